@@ -0,0 +1,1010 @@
+/*
+ * Copyright (C) 2017 Intel Deutschland GmbH, Germany
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Host microbenchmarks for the platform independent hot paths.
+// Results are written to stdout as JSON. Each benchmark runs a fixed number
+// of iterations several times and reports the fastest run, so numbers are
+// comparable between firmware versions on the same machine.
+
+#include "host_hal.h"
+#include "host_ssp.h"
+#include "LPC214x.h"
+#include "ext_com.h"
+#include "sdkio.h"
+#include "ll_hl_comm.h"
+#include "ll_events.h"
+#include "ll_convert.h"
+#include "slow_channel.h"
+#include "jobs.h"
+#include "profiler.h"
+#include "irq_stats.h"
+#include "trace.h"
+#include "sdk.h"
+#include "examples/gps_waypoints.h"
+#include "waypoint_fsm.h"
+#include "util/cobs.h"
+#include "util/crc16.h"
+#include "util/fifo.h"
+#include "hal/uart0.h"
+#include "hal/sys_time.h"
+#include "hal/ssp.h"
+#include "LPC214x.h"
+#include "irq.h"
+#include "asctec_uav_msgs/message_definitions.h"
+#include "asctec_uav_msgs/transport_definitions.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_RUNS        5
+#define BENCH_DATA_SIZE 256
+#define BENCH_FIFO_CHUNK 64
+
+typedef struct _BenchResult
+{
+  const char* pName;
+  const char* pUnit;
+  uint32_t iterations;
+  uint32_t size;
+  double value;
+} BenchResult;
+
+typedef void(*BenchFunc)(uint32_t iterations);
+
+static uint8_t benchData[BENCH_DATA_SIZE];
+static uint8_t benchEncoded[COBSMaxStuffedSize(BENCH_DATA_SIZE)];
+static uint32_t benchEncodedSize;
+static uint8_t benchOut[COBSMaxStuffedSize(BENCH_DATA_SIZE)];
+static volatile uint32_t benchSink;
+
+static uint64_t nowNs(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec*1000000000ULL + ts.tv_nsec;
+}
+
+// fixed pseudo random payload with some zeros for COBS to stuff
+static void fillBenchData(void)
+{
+  uint32_t lcg = 0x12345678;
+
+  for(uint32_t i = 0; i < BENCH_DATA_SIZE; i++)
+  {
+    lcg = lcg*1664525 + 1013904223;
+    benchData[i] = (i % 17 == 0) ? 0 : (uint8_t)(lcg >> 24);
+  }
+
+  COBSEncode(benchData, BENCH_DATA_SIZE, benchEncoded, sizeof(benchEncoded), &benchEncodedSize);
+}
+
+static void benchCOBSEncode(uint32_t iterations)
+{
+  uint32_t written;
+
+  for(uint32_t i = 0; i < iterations; i++)
+  {
+    COBSEncode(benchData, BENCH_DATA_SIZE, benchOut, sizeof(benchOut), &written);
+    benchSink += written;
+  }
+}
+
+static void benchCOBSDecode(uint32_t iterations)
+{
+  uint32_t written;
+
+  for(uint32_t i = 0; i < iterations; i++)
+  {
+    COBSDecode(benchEncoded, benchEncodedSize, benchOut, sizeof(benchOut), &written);
+    benchSink += written;
+  }
+}
+
+static void benchCRC16(uint32_t iterations)
+{
+  for(uint32_t i = 0; i < iterations; i++)
+    benchSink += CRC16Checksum(benchData, BENCH_DATA_SIZE);
+}
+
+static void benchFifoWrite(uint32_t iterations)
+{
+  Fifo fifo;
+  uint8_t buf[BENCH_FIFO_CHUNK*4];
+  FifoInit(&fifo, buf, sizeof(buf));
+
+  for(uint32_t i = 0; i < iterations; i++)
+  {
+    FifoWrite(&fifo, benchData, BENCH_FIFO_CHUNK);
+    fifo.readPos = fifo.writePos;
+  }
+
+  benchSink += fifo.writePos;
+}
+
+static void benchFifoGet(uint32_t iterations)
+{
+  Fifo fifo;
+  uint8_t buf[BENCH_FIFO_CHUNK*4];
+  uint8_t data;
+  FifoInit(&fifo, buf, sizeof(buf));
+
+  for(uint32_t i = 0; i < iterations; i++)
+  {
+    fifo.readPos = fifo.writePos;
+    fifo.writePos = (fifo.writePos + BENCH_FIFO_CHUNK) % fifo.size;
+
+    while(FifoGet(&fifo, &data) == 0)
+      benchSink += data;
+  }
+}
+
+static void benchExtComSendMessage(uint32_t iterations)
+{
+  TransportHeader header;
+  Imu imu;
+
+  header.id = MESSAGE_ID_IMU;
+  header.flags = 0;
+  header.ackId = 0;
+  memcpy(&imu, benchData, sizeof(Imu));
+
+  for(uint32_t i = 0; i < iterations; i++)
+  {
+    ExtComSendMessage(&header, &imu, sizeof(Imu));
+    uart0.txFifo.readPos = uart0.txFifo.writePos;
+  }
+}
+
+static void benchSDKParseLLData(uint32_t iterations)
+{
+  struct LL_ATTITUDE_DATA pages[3];
+
+  for(uint8_t p = 0; p < 3; p++)
+  {
+    memcpy(&pages[p], benchData + p*32, sizeof(pages[0]));
+    pages[p].system_flags = (pages[p].system_flags & ~0x03) | p;
+  }
+
+  for(uint32_t i = 0; i < iterations; i++)
+    SDKParseLLData(&pages[i % 3]);
+
+  benchSink += sdk.ro.attitude.yaw;
+}
+
+// LL frame of 22 words for page p from the bench data with angle_pitch set to pitch
+static void makeLLFrame(uint16_t* pFrame, uint8_t p, int16_t pitch)
+{
+  uint8_t* pBytes = (uint8_t*)pFrame;
+
+  pBytes[0] = '>';
+  pBytes[1] = '*';
+  memcpy(&pBytes[2], benchData + p*32, 40);
+  pBytes[2] = (pBytes[2] & ~0x03) | p;
+  memcpy(&pBytes[4], &pitch, 2);
+  pBytes[42] = '<';
+  pBytes[43] = 0;
+}
+
+// SSP receive interrupt work for one complete LL frame of 22 words
+static void benchSSPRxFrame(uint32_t iterations)
+{
+  uint16_t frames[3][22];
+
+  for(uint8_t p = 0; p < 3; p++)
+    makeLLFrame(frames[p], p, p);
+
+  for(uint32_t i = 0; i < iterations; i++)
+  {
+    const uint16_t* pFrame = frames[i % 3];
+
+    for(uint8_t j = 0; j < 22; j++)
+      SSP_rx_handler_HL(pFrame[j]);
+  }
+
+  benchSink += llRxStats.frames;
+}
+
+// main loop work to parse the newest LL frame, fed by the SSP interrupt in between
+static void benchLLRxProcess(uint32_t iterations)
+{
+  uint16_t frames[3][22];
+
+  for(uint8_t p = 0; p < 3; p++)
+    makeLLFrame(frames[p], p, p);
+
+  for(uint32_t i = 0; i < iterations; i++)
+  {
+    const uint16_t* pFrame = frames[i % 3];
+
+    for(uint8_t j = 0; j < 22; j++)
+      SSP_rx_handler_HL(pFrame[j]);
+
+    LLRxProcess();
+  }
+
+  benchSink += sdk.ro.attitude.yaw;
+}
+
+// pack and queue one control frame to the LL, pages alternating, and run the
+// SSP interrupt (host SSP model included) until it has started the frame
+static void benchSSPTxWrite(uint32_t iterations)
+{
+  struct LL_CONTROL_INPUT input;
+  uint16_t word;
+
+  memcpy(&input, benchData, sizeof(input));
+
+  HostSSPReset();
+  HostSSPSetRxDiscard(1);
+  SSPInit();
+  SSPInitIRQ();
+
+  for(uint32_t i = 0; i < iterations; i++)
+  {
+    SSPWriteToLL(i & 1, (uint8_t*)&input);
+
+    while(SSPTxPending())
+    {
+      HostSSPService();
+      HostSSPTransfer(0, 0, &word);
+    }
+  }
+
+  SSPCR1 = 0;
+
+  benchSink += sspTxStats.frames;
+}
+
+static uint32_t sdkUpdateCalls[SDK_NUM_GROUPS];
+static uint32_t sdkUpdateSeq[SDK_NUM_GROUPS];
+
+static void countSDKUpdate(uint8_t group, uint32_t seq)
+{
+  ++sdkUpdateCalls[group];
+  sdkUpdateSeq[group] = seq;
+}
+
+// dispatch on a tick with new attitude only, one subscriber
+static void benchSDKDispatchUpdates(uint32_t iterations)
+{
+  for(uint32_t i = 0; i < iterations; i++)
+  {
+    SDKGroupUpdated(SDK_GROUP_ATTITUDE);
+    SDKDispatchUpdates();
+  }
+
+  benchSink += sdkUpdateCalls[SDK_GROUP_ATTITUDE];
+}
+
+// divisors of the LL conversions, volatile so that the host divides like the
+// target does instead of folding the constants into multiplications
+static volatile int32_t llConvDivisors[7] = { 52000, 200000, 4000, 301, 100, 579, 15 };
+
+// LL command and sensor conversions of one tick with division
+static void benchLLConvDivision(uint32_t iterations)
+{
+  int32_t d[7];
+  int32_t sum = 0;
+
+  for(uint8_t i = 0; i < 7; i++)
+    d[i] = llConvDivisors[i];
+
+  for(uint32_t i = 0; i < iterations; i++)
+  {
+    int32_t x = (int32_t)(i & 0xFFFF) - 32768;
+
+    sum += (x*2048)/d[0] + (-x*2048)/d[0] + (x*2048)/d[1] + (((x >> 4)+2000)*4096)/d[2];
+    for(uint8_t j = 0; j < 4; j++)
+      sum += (8*((i + j) & 0x1FFF)-8600)/d[3];
+    sum += (x*981)/d[4] + (-x*981)/d[4] + ((x >> 1)*981)/d[4];
+    sum += ((uint32_t)(i & 0x3FFF)*14 + (uint32_t)(i & 1023)*9872/(uint32_t)d[5])/(uint32_t)d[6];
+  }
+
+  benchSink += sum;
+}
+
+// the same conversions with ll_convert.h
+static void benchLLConvReciprocal(uint32_t iterations)
+{
+  int32_t sum = 0;
+
+  for(uint32_t i = 0; i < iterations; i++)
+  {
+    int32_t x = (int32_t)(i & 0xFFFF) - 32768;
+
+    sum += LLConvAngleCmd(x) + LLConvAngleCmd(-x) + LLConvYawRateCmd(x) + LLConvClimbRateCmd(x >> 4);
+    for(uint8_t j = 0; j < 4; j++)
+      sum += LLConvMotorCmd((i + j) & 0x1FFF);
+    sum += LLConvAcc(x) + LLConvAcc(-x) + LLConvAcc(x >> 1);
+    sum += LLConvBatteryFilter(i & 0x3FFF, LLConvBatteryMV(i & 1023));
+  }
+
+  benchSink += sum;
+}
+
+// cost of one PROFILER_START/PROFILER_STOP pair around a scheduler task
+static void benchProfilerSample(uint32_t iterations)
+{
+  for(uint32_t i = 0; i < iterations; i++)
+  {
+    PROFILER_START(start);
+    PROFILER_STOP(i % SCHEDULER_MAX_TASKS, start);
+  }
+
+  benchSink += profiler.stage[0].count;
+}
+
+// cost of the instrumentation in every interrupt handler
+static void benchIRQStats(uint32_t iterations)
+{
+  IRQStatsReset();
+
+  for(uint32_t i = 0; i < iterations; i++)
+  {
+    IRQ_STATS_ENTER(IRQ_STATS_UART0);
+    IRQ_STATS_EXIT(IRQ_STATS_UART0);
+  }
+
+  benchSink += irqStats.irq[IRQ_STATS_UART0].count;
+}
+
+static void benchTraceEmit(uint32_t iterations)
+{
+  TraceStart();
+
+  for(uint32_t i = 0; i < iterations; i++)
+    TRACE(TRACE_EV_USER, i);
+
+  TraceStop();
+}
+
+// one tick of inputs for the waypoint example: a square flight that is
+// aborted by the aux switch every 4s, a waypoint is reached every 250ms.
+// Every 1.75s the pilot aborts, alone or together with a reached waypoint.
+static void waypointInputs(uint32_t tick)
+{
+  sdk.ro.serialInterfaceReady = 1;
+  sdk.ro.rc.aux = tick % 4000 < 2 ? 1000 : 3000;
+  sdk.ro.waypoint.ackTrigger = 1;
+  sdk.ro.waypoint.navStatus = tick % 250 == 249 ? WP_NAVSTAT_REACHED_POS_TIME : 0;
+  if(tick % 1750 == 999 || tick % 1750 == 1499)
+    sdk.ro.waypoint.navStatus |= WP_NAVSTAT_PILOT_ABORT;
+  sdk.cmd.wpAbsolute.updated = 0;
+}
+
+static void benchWaypointStateMachine(uint32_t iterations)
+{
+  for(uint32_t i = 0; i < iterations; i++)
+  {
+    waypointInputs(i);
+    BenchWaypointStateMachine();
+  }
+
+  benchSink += wpExample.wpNr;
+}
+
+static void benchWaypointCoroutine(uint32_t iterations)
+{
+  for(uint32_t i = 0; i < iterations; i++)
+  {
+    waypointInputs(i);
+    ExampleGPSWaypointControl();
+  }
+
+  benchSink += wpExample.wpNr;
+}
+
+static void benchSysTimeLongUSec(uint32_t iterations)
+{
+  int64_t sum = 0;
+
+  for(uint32_t i = 0; i < iterations; i++)
+    sum += SysTimeLongUSec();
+
+  benchSink += sum;
+}
+
+static void benchSysTimeCycles(uint32_t iterations)
+{
+  for(uint32_t i = 0; i < iterations; i++)
+    benchSink += SysTimeCycles();
+}
+
+static void benchSysTimeCyclesToUSec(uint32_t iterations)
+{
+  uint32_t sum = 0;
+
+  for(uint32_t i = 0; i < iterations; i++)
+    sum += SysTimeCyclesToUSec(i*4099);
+
+  benchSink += sum;
+}
+
+// the 64 bit division SysTimeLongUSec() used before
+static void benchSysTimeDivision(uint32_t iterations)
+{
+  uint32_t sum = 0;
+
+  for(uint32_t i = 0; i < iterations; i++)
+    sum += ((int64_t)(i*4099 % CPU_CLOCK_HZ)*1000000)/CPU_CLOCK_HZ;
+
+  benchSink += sum;
+}
+
+// one clock reading at absolute time cycles, with the timer 1 interrupt handled
+// at the wrap or still pending like inside another interrupt handler
+static uint8_t checkSysTimeAt(uint64_t cycles, uint8_t pending, int64_t* pLast)
+{
+  if(pending)
+    VICIntEnable &= ~(1UL << TIMER1_INT);
+
+  HostSetCycles(cycles);
+
+  int64_t expected = cycles*1000000/CPU_CLOCK_HZ;
+  int64_t us = SysTimeLongUSec();
+  uint8_t ok = us == expected && us >= *pLast && SysTimeCycles() == (uint32_t)cycles;
+
+  VICIntEnable |= 1UL << TIMER1_INT;
+  if(T1IR & 0x01)
+  {
+    HostRaiseIrq(TIMER1_INT);
+    T1IR = 0;
+
+    ok = ok && SysTimeLongUSec() == us;
+  }
+
+  *pLast = us;
+
+  return ok;
+}
+
+// SysTimeLongUSec() is exact and monotonic across timer 1 wraps
+static uint8_t checkSysTimeMonotonic(void)
+{
+  SysTimeInit();
+  SysTimeInitIRQ();
+
+  int64_t last = 0;
+  uint64_t cycles = 0;
+
+  for(uint8_t wrap = 1; wrap <= 80; wrap++)
+  {
+    uint64_t wrapCycles = (uint64_t)wrap*CPU_CLOCK_HZ;
+    uint8_t pending = wrap & 1;
+
+    for(; cycles < wrapCycles - 5000; cycles += 999983)
+    {
+      if(!checkSysTimeAt(cycles, pending, &last))
+        return 0;
+    }
+
+    for(cycles = wrapCycles - 5000; cycles < wrapCycles + 5000; cycles += 7)
+    {
+      if(!checkSysTimeAt(cycles, pending, &last))
+        return 0;
+    }
+  }
+
+  return 1;
+}
+
+// the main loop always parses the newest complete LL frame, wherever the SSP
+// interrupt is within the next one
+static uint8_t checkLLRxConsistent(void)
+{
+  uint16_t frame[22];
+  int16_t pitch = 0;
+
+  for(uint8_t offset = 0; offset <= 22; offset++)
+  {
+    // complete frame, then the first bytes of the next one
+    makeLLFrame(frame, pitch % 3, pitch);
+    for(uint8_t j = 0; j < 22; j++)
+      SSP_rx_handler_HL(frame[j]);
+
+    makeLLFrame(frame, (pitch + 1) % 3, pitch + 1);
+    for(uint8_t j = 0; j < offset; j++)
+      SSP_rx_handler_HL(frame[j]);
+
+    LLRxProcess();
+    if(sdk.ro.attitude.angle[1] != (offset == 22 ? pitch + 1 : pitch)*10)
+      return 0;
+
+    // rest of the next frame and another one while the main loop did not parse
+    for(uint8_t j = offset; j < 22; j++)
+      SSP_rx_handler_HL(frame[j]);
+
+    makeLLFrame(frame, (pitch + 2) % 3, pitch + 2);
+    for(uint8_t j = 0; j < 22; j++)
+      SSP_rx_handler_HL(frame[j]);
+
+    LLRxProcess();
+    if(sdk.ro.attitude.angle[1] != (pitch + 2)*10)
+      return 0;
+
+    pitch += 3;
+  }
+
+  return llRxStats.badFrames == 0 && llRxStats.syncLosses == 0 && llRxStats.pageErrors == 0;
+}
+
+// frames without end marker are dropped and counted, garbage between frames
+// counts as one sync loss, a skipped page as one page error
+static uint8_t checkLLRxErrors(void)
+{
+  uint16_t frame[22];
+  LLRxStats before = llRxStats;
+
+  makeLLFrame(frame, 0, 1000);
+  for(uint8_t j = 0; j < 22; j++)
+    SSP_rx_handler_HL(frame[j]);
+  LLRxProcess();
+
+  makeLLFrame(frame, 1, 1001);
+  frame[21] = 0;
+  for(uint8_t j = 0; j < 22; j++)
+    SSP_rx_handler_HL(frame[j]);
+  LLRxProcess();
+
+  if(sdk.ro.attitude.angle[1] != 10000 || llRxStats.badFrames != before.badFrames + 1)
+    return 0;
+
+  SSP_rx_handler_HL(0x1234);
+  SSP_rx_handler_HL(0x5678);
+  SSP_rx_handler_HL(0);
+
+  makeLLFrame(frame, 2, 1002);
+  for(uint8_t j = 0; j < 22; j++)
+    SSP_rx_handler_HL(frame[j]);
+  LLRxProcess();
+
+  if(sdk.ro.attitude.angle[1] != 10020 || llRxStats.syncLosses != before.syncLosses + 1
+      || llRxStats.pageErrors != before.pageErrors + 1 || llRxStats.frames != before.frames + 2)
+    return 0;
+
+  // three 43 byte frames without pad byte, the second starts in the high byte of a word
+  uint8_t bytes[3*43 + 1];
+
+  for(uint8_t p = 0; p < 3; p++)
+  {
+    makeLLFrame(frame, p, 1003 + p);
+    memcpy(&bytes[p*43], frame, 43);
+  }
+  bytes[3*43] = 0;
+
+  for(uint8_t j = 0; j < sizeof(bytes)/2; j++)
+  {
+    SSP_rx_handler_HL(bytes[2*j] | (bytes[2*j + 1] << 8));
+
+    // end of the shifted frame
+    if(j == 42)
+    {
+      LLRxProcess();
+      if(sdk.ro.attitude.angle[1] != 10040)
+        return 0;
+    }
+  }
+  LLRxProcess();
+
+  return sdk.ro.attitude.angle[1] == 10050 && llRxStats.oddStarts == before.oddStarts + 1
+      && llRxStats.frames == before.frames + 5 && llRxStats.badFrames == before.badFrames + 1
+      && llRxStats.syncLosses == before.syncLosses + 1 && llRxStats.pageErrors == before.pageErrors + 1;
+}
+
+// a navigation status that is set for a single page 2 frame shows up as two
+// events, repeated values as none, and a reader too far behind counts its losses
+static uint8_t checkLLEvents(void)
+{
+  static const int16_t navStatus[] = { 0, 0, WP_NAVSTAT_REACHED_POS, 0, 0 };
+  LLEventReader reader;
+  LLEvent event;
+  int64_t rising = 0, falling = 0;
+  uint8_t events = 0;
+
+  LLEventsInit();
+  LLEventReaderInit(&reader);
+
+  for(uint8_t i = 0; i < sizeof(navStatus)/sizeof(navStatus[0]); i++)
+    LLEventsUpdate(SUDC_NAVSTATUS, navStatus[i], i);
+
+  while(LLEventRead(&reader, &event))
+  {
+    ++events;
+    if(LLEventRising(&event, WP_NAVSTAT_REACHED_POS))
+      rising = event.timeUs;
+    else if(!event.first && (event.previous & WP_NAVSTAT_REACHED_POS))
+      falling = event.timeUs;
+  }
+
+  if(events != 3 || rising != 2 || falling != 3)
+    return 0;
+
+  for(int16_t i = 1; i <= LL_EVENTS_QUEUE_SIZE + 4; i++)
+    LLEventsUpdate(SUDC_FLIGHTTIME, i, 10 + i);
+
+  if(LLEventReaderLost(&reader) != 4 || !LLEventRead(&reader, &event) || event.value != 5 || reader.lost != 4)
+    return 0;
+
+  return 1;
+}
+
+// subscribers run once per group update, a repeated slow channel value is no
+// event, and two updates between dispatches make one call with the newer seq
+static uint8_t checkSDKUpdates(void)
+{
+  struct LL_ATTITUDE_DATA pages[3];
+  uint32_t seq[SDK_NUM_GROUPS];
+
+  memset(pages, 0, sizeof(pages));
+  for(uint8_t p = 0; p < 3; p++)
+    pages[p].system_flags = p;
+  pages[2].status2 = SUDC_FLIGHTTIME << 1;
+
+  if(SDKSubscribe(0x3F, &countSDKUpdate))
+    return 0;
+
+  SDKDispatchUpdates();
+  memcpy(seq, sdk.ro.updateSeq, sizeof(seq));
+  memset(sdkUpdateCalls, 0, sizeof(sdkUpdateCalls));
+
+  for(uint8_t i = 0; i < 12; i++)
+  {
+    pages[2].slowDataUpChannelDataShort = 1000 + i/6; // new on the 1st and 3rd page 2, repeated on the others
+    SDKParseLLData(&pages[i % 3]);
+    SDKDispatchUpdates();
+  }
+
+  static const uint8_t expected[SDK_NUM_GROUPS] = { 12, 4, 4, 4, 0, 2 };
+
+  for(uint8_t group = 0; group < SDK_NUM_GROUPS; group++)
+  {
+    if(sdkUpdateCalls[group] != expected[group] || sdk.ro.updateSeq[group] != seq[group] + expected[group])
+      return 0;
+  }
+
+  SDKParseLLData(&pages[0]);
+  SDKParseLLData(&pages[1]);
+  SDKDispatchUpdates();
+  SDKDispatchUpdates();
+
+  if(sdkUpdateCalls[SDK_GROUP_ATTITUDE] != 13 || sdkUpdateSeq[SDK_GROUP_ATTITUDE] != seq[SDK_GROUP_ATTITUDE] + 14
+      || sdkUpdateCalls[SDK_GROUP_RC_ACC] != 5 || sdkUpdateCalls[SDK_GROUP_HEIGHT_MOTORS] != 5
+      || sdkUpdateCalls[SDK_GROUP_MAG_STATUS] != 4)
+    return 0;
+
+  return 1;
+}
+
+// every LL conversion is bit exact with the division it replaces over the whole
+// range where that does not overflow, both yaw scalings included
+static uint8_t checkLLConvert(void)
+{
+  for(int32_t x = -(1 << 20); x < (1 << 20); x++)
+  {
+    if(LLConvAngleCmd(x) != (x*2048)/52000 || LLConvSpeedCmd(x) != (x*2048)/3000)
+      return 0;
+
+    if(llConvDivS(x*64, LL_CONV_RECIP(9375, 13), 13) != (x*2048)/300000
+        || llConvDivS(x*32, LL_CONV_RECIP(3125, 11), 11) != (x*2048)/200000)
+      return 0;
+  }
+
+  for(int32_t x = -(1 << 19) - 2000; x < (1 << 19) - 2000; x++)
+  {
+    if(LLConvClimbRateCmd(x) != ((x+2000)*4096)/4000)
+      return 0;
+  }
+
+  for(int32_t rpm = 0; rpm <= 32768; rpm++)
+  {
+    if(LLConvMotorCmd(rpm) != (8*rpm-8600)/301 || LLConvMotorCmdFirefly(rpm) != (4*rpm-500)/175)
+      return 0;
+  }
+
+  for(int32_t acc = INT16_MIN; acc <= INT16_MAX; acc++)
+  {
+    if(LLConvAcc(acc) != (acc*981)/100)
+      return 0;
+  }
+
+  for(uint32_t raw = 0; raw*9872 < (1UL << 31); raw++)
+  {
+    if(LLConvBatteryMV(raw) != raw * 9872 / 579)
+      return 0;
+  }
+
+  // every filter input up to the highest 10 bit ADC voltage
+  const uint32_t batMaxMV = 1023 * 9872 / 579;
+
+  for(uint32_t filtered = 0; filtered <= batMaxMV; filtered++)
+  {
+    for(uint32_t mV = 0; mV < 15; mV++)
+    {
+      if(LLConvBatteryFilter(filtered, mV) != (filtered * 14 + mV) / 15)
+        return 0;
+    }
+  }
+
+  for(uint32_t mV = 0; mV <= batMaxMV; mV++)
+  {
+    if(LLConvBatteryFilter(batMaxMV, mV) != (batMaxMV * 14 + mV) / 15)
+      return 0;
+  }
+
+  return 1;
+}
+
+// SDK items the LL never confirms cannot take the entries reserved for the
+// emergency mode, declination, inclination and build info
+static uint8_t checkSlowChannelReserve(void)
+{
+  SlowChannelItem item;
+  uint8_t sdkQueued = 0;
+
+  SlowChannelInit();
+
+  for(uint8_t i = 0; i < SLOW_CHANNEL_MAX; i++)
+  {
+    if(!SDKSlowChannelSend(0x40 + i, 0, i, SUDC_FLIGHTTIME, SLOW_CHANNEL_RETRY_FOREVER))
+      ++sdkQueued;
+  }
+
+  // a newer value for a queued select still replaces it
+  if(sdkQueued != SLOW_CHANNEL_MAX - SLOW_CHANNEL_RESERVED
+      || SDKSlowChannelSend(0x40, 0, 100, SUDC_FLIGHTTIME, SLOW_CHANNEL_RETRY_FOREVER))
+    return 0;
+
+  static const uint8_t classes[SLOW_CHANNEL_RESERVED] = { SLOW_CHANNEL_CLASS_EM_MODE,
+      SLOW_CHANNEL_CLASS_DECLINATION, SLOW_CHANNEL_CLASS_DECLINATION, SLOW_CHANNEL_CLASS_BUILD_INFO };
+
+  for(uint8_t i = 0; i < SLOW_CHANNEL_RESERVED; i++)
+  {
+    memset(&item, 0, sizeof(item));
+    item.itemClass = classes[i];
+    item.slot.select = 0x20 + i;
+
+    if(SlowChannelPost(&item))
+      return 0;
+  }
+
+  uint8_t ok = slowChannel.stat[SLOW_CHANNEL_CLASS_SDK].dropped == SLOW_CHANNEL_RESERVED;
+
+  SlowChannelInit();
+
+  return ok;
+}
+
+#define WAYPOINT_REPLAY_TICKS 16000
+
+typedef struct _WaypointReplayTick
+{
+  int32_t latitude;
+  int32_t longitude;
+  int32_t heading;
+  uint8_t updated;
+  uint8_t mode;
+  uint8_t wpNr;
+  uint16_t state;
+} WaypointReplayTick;
+
+static WaypointReplayTick waypointReplay[WAYPOINT_REPLAY_TICKS];
+
+// one replay of the scripted waypoint inputs, from a reset by the serial switch
+static uint8_t replayWaypoints(void(*pControl)(void), uint8_t compare)
+{
+  memset(&sdk.cmd, 0, sizeof(sdk.cmd));
+  memset(&wpExample, 0, sizeof(wpExample));
+  sdk.ro.serialInterfaceReady = 0;
+  pControl();
+
+  for(uint32_t i = 0; i < WAYPOINT_REPLAY_TICKS; i++)
+  {
+    WaypointReplayTick tick;
+
+    sdk.ro.gps.latitude = 475000000 + i;
+    sdk.ro.gps.longitude = 85000000 - i;
+    sdk.ro.attitude.yaw = (i*37) % 360000;
+    sdk.ro.height = i;
+    waypointInputs(i);
+    pControl();
+
+    memset(&tick, 0, sizeof(tick));
+    tick.latitude = sdk.cmd.wpAbsolute.latitude;
+    tick.longitude = sdk.cmd.wpAbsolute.longitude;
+    tick.heading = sdk.cmd.wpAbsolute.heading;
+    tick.updated = sdk.cmd.wpAbsolute.updated;
+    tick.mode = sdk.cmd.mode;
+    tick.wpNr = wpExample.wpNr;
+    tick.state = wpExample.state;
+
+    if(!compare)
+      waypointReplay[i] = tick;
+    else if(memcmp(&waypointReplay[i], &tick, sizeof(tick)))
+      return 0;
+  }
+
+  return 1;
+}
+
+static uint8_t jobRuns[2];
+
+static uint8_t benchJobA(void* pArg)
+{
+  (void)pArg;
+  ++jobRuns[0];
+  return JOB_DONE;
+}
+
+static uint8_t benchJobB(void* pArg)
+{
+  (void)pArg;
+  ++jobRuns[1];
+  return JOB_DONE;
+}
+
+// a job that does not fit the idle time left does not hold back a cheaper one
+static uint8_t checkJobsFit(void)
+{
+  volatile uint8_t tickPending = 0;
+  const uint32_t savedMatch = T0MR0;
+  const uint32_t match = CPU_CLOCK_HZ/1000 - 1;
+
+  T0MR0 = match;
+
+  JobsInit();
+  memset(jobRuns, 0, sizeof(jobRuns));
+  JobPost("long", &benchJobA, 0, 900);
+  JobPost("short", &benchJobB, 0, 50);
+
+  // 100us left in the tick
+  T0TC = match - 100*(CPU_CLOCK_HZ/1000000);
+  uint8_t ran = JobsRunIdle(&tickPending);
+  uint8_t ok = ran && jobRuns[1] == 1 && !jobRuns[0] && jobs.count == 1 && jobs.deferrals == 1
+      && !JobsRunIdle(&tickPending);
+
+  // a whole tick left, the long job runs now
+  T0TC = 0;
+  ok = ok && JobsRunIdle(&tickPending) && jobRuns[0] == 1 && !jobs.count;
+
+  T0MR0 = savedMatch;
+  JobsInit();
+  return ok;
+}
+
+// the waypoint coroutine commands the same waypoints in the same ticks as the
+// former state machine, including a pilot abort together with a reached waypoint
+static uint8_t checkWaypointReplay(void)
+{
+  replayWaypoints(&BenchWaypointStateMachine, 0);
+
+  return replayWaypoints(&ExampleGPSWaypointControl, 1);
+}
+
+static double runBench(BenchFunc func, uint32_t iterations, uint32_t opsPerIteration)
+{
+  uint64_t best = UINT64_MAX;
+
+  func(iterations/10+1); // warm up caches and branch predictors
+
+  for(uint8_t run = 0; run < BENCH_RUNS; run++)
+  {
+    uint64_t start = nowNs();
+    func(iterations);
+    uint64_t duration = nowNs() - start;
+
+    if(duration < best)
+      best = duration;
+  }
+
+  return (double)best/((double)iterations*opsPerIteration);
+}
+
+int main(void)
+{
+  HostHalInit();
+  HostCoreInit();
+  fillBenchData();
+
+  uint8_t sysTimeOk = checkSysTimeMonotonic();
+  uint8_t llRxOk = checkLLRxConsistent();
+  uint8_t llRxErrorsOk = checkLLRxErrors();
+  uint8_t llEventsOk = checkLLEvents();
+  uint8_t sdkUpdatesOk = checkSDKUpdates();
+  uint8_t llConvertOk = checkLLConvert();
+  uint8_t waypointReplayOk = checkWaypointReplay();
+  uint8_t slowChannelOk = checkSlowChannelReserve();
+  uint8_t jobsFitOk = checkJobsFit();
+
+  BenchResult results[] = {
+    { "cobs_encode",          "ns/byte", 200000, BENCH_DATA_SIZE,  0 },
+    { "cobs_decode",          "ns/byte", 200000, BENCH_DATA_SIZE,  0 },
+    { "crc16_checksum",       "ns/byte", 200000, BENCH_DATA_SIZE,  0 },
+    { "fifo_write",           "ns/byte", 500000, BENCH_FIFO_CHUNK, 0 },
+    { "fifo_get",             "ns/byte", 500000, BENCH_FIFO_CHUNK, 0 },
+    { "ext_com_send_message", "ns/call", 500000, sizeof(Imu),      0 },
+    { "sdk_parse_ll_data",    "ns/call", 3000000, sizeof(struct LL_ATTITUDE_DATA), 0 },
+    { "sdk_dispatch_updates", "ns/call", 5000000, 0,                0 },
+    { "ll_conv_division",     "ns/tick", 2000000, 0,                0 },
+    { "ll_conv_reciprocal",   "ns/tick", 2000000, 0,                0 },
+    { "ssp_rx_frame",         "ns/frame", 1000000, 44,              0 },
+    { "ll_rx_process",        "ns/frame", 1000000, 44,              0 },
+    { "ssp_tx_write",         "ns/frame", 3000000, 42,              0 },
+    { "profiler_sample",      "ns/call", 5000000, 0,                0 },
+    { "irq_stats",            "ns/call", 5000000, 0,                0 },
+    { "trace_emit",           "ns/call", 5000000, 0,                0 },
+    { "waypoint_state_machine", "ns/tick", 4000000, 0,              0 },
+    { "waypoint_coroutine",   "ns/tick", 4000000, 0,                0 },
+    { "sys_time_long_usec",   "ns/call", 5000000, 0,                0 },
+    { "sys_time_cycles",      "ns/call", 5000000, 0,                0 },
+    { "sys_time_cycles_to_usec", "ns/call", 5000000, 0,             0 },
+    { "sys_time_division",    "ns/call", 5000000, 0,                0 },
+  };
+
+  BenchFunc funcs[] = {
+    &benchCOBSEncode,
+    &benchCOBSDecode,
+    &benchCRC16,
+    &benchFifoWrite,
+    &benchFifoGet,
+    &benchExtComSendMessage,
+    &benchSDKParseLLData,
+    &benchSDKDispatchUpdates,
+    &benchLLConvDivision,
+    &benchLLConvReciprocal,
+    &benchSSPRxFrame,
+    &benchLLRxProcess,
+    &benchSSPTxWrite,
+    &benchProfilerSample,
+    &benchIRQStats,
+    &benchTraceEmit,
+    &benchWaypointStateMachine,
+    &benchWaypointCoroutine,
+    &benchSysTimeLongUSec,
+    &benchSysTimeCycles,
+    &benchSysTimeCyclesToUSec,
+    &benchSysTimeDivision,
+  };
+
+  const uint32_t numBenches = sizeof(results)/sizeof(results[0]);
+
+  for(uint32_t i = 0; i < numBenches; i++)
+  {
+    uint32_t ops = strcmp(results[i].pUnit, "ns/byte") == 0 ? results[i].size : 1;
+    results[i].value = runBench(funcs[i], results[i].iterations, ops);
+  }
+
+  printf("{\n");
+  printf("  \"suite\": \"host-bench\",\n");
+  printf("  \"version\": \"%d.%d\",\n", __VERSION_MAJOR, __VERSION_MINOR);
+  printf("  \"checks\": { \"sysTimeMonotonic\": %s, \"llRxConsistent\": %s, \"llRxErrors\": %s, \"llEvents\": %s,"
+      " \"sdkUpdates\": %s, \"llConvert\": %s, \"waypointReplay\": %s,"
+      " \"slowChannelReserve\": %s, \"jobsFit\": %s },\n",
+      sysTimeOk ? "true" : "false", llRxOk ? "true" : "false", llRxErrorsOk ? "true" : "false",
+      llEventsOk ? "true" : "false", sdkUpdatesOk ? "true" : "false", llConvertOk ? "true" : "false",
+      waypointReplayOk ? "true" : "false", slowChannelOk ? "true" : "false", jobsFitOk ? "true" : "false");
+  printf("  \"results\": [\n");
+  for(uint32_t i = 0; i < numBenches; i++)
+  {
+    printf("    { \"name\": \"%s\", \"unit\": \"%s\", \"value\": %.3f, \"iterations\": %u, \"size\": %u }%s\n",
+        results[i].pName, results[i].pUnit, results[i].value, results[i].iterations, results[i].size,
+        i+1 < numBenches ? "," : "");
+  }
+  printf("  ]\n");
+  printf("}\n");
+
+  return sysTimeOk && llRxOk && llRxErrorsOk && llEventsOk && sdkUpdatesOk && llConvertOk && waypointReplayOk && slowChannelOk
+      && jobsFitOk ? 0 : 1;
+}
@@ -0,0 +1,203 @@
+/*
+ * Copyright (C) 2017 Intel Deutschland GmbH, Germany
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Runs many independent SIL vehicles in one process. The host multi-instance
+// build makes all firmware state thread local (see src/context.h), so every
+// worker thread owns a complete vehicle. The same set of instances is run
+// with 1, 2, 4, ... worker threads to show how throughput scales with cores.
+// All instances use the same configuration, so identical results also show
+// that no state leaks between them.
+//
+// usage: host-multi [-n instances] [-j max threads] [-t seconds per instance]
+
+#include "../sil/ll_emulator.h"
+#include "../sil/sil_run.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+typedef struct _InstanceResult
+{
+  uint64_t ticks;
+  uint32_t framesConsumed;
+  uint32_t cmdWritten;
+  uint32_t cmdChecksumErrors;
+  uint64_t latencySum;
+} InstanceResult;
+
+typedef struct _Worker
+{
+  pthread_t thread;
+  const SILConfig* pConfig;
+  InstanceResult* pResults;
+  uint32_t first;
+  uint32_t stride;
+  uint32_t instances;
+} Worker;
+
+static double wallSeconds(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+static void* workerMain(void* pArg)
+{
+  Worker* pWorker = pArg;
+
+  for(uint32_t i = pWorker->first; i < pWorker->instances; i += pWorker->stride)
+  {
+    InstanceResult* pResult = &pWorker->pResults[i];
+
+    pResult->ticks = SILRun(pWorker->pConfig);
+
+    const LLEmuStat* pStat = LLEmuGetStat();
+    pResult->framesConsumed = pStat->framesConsumed;
+    pResult->cmdWritten = pStat->cmdWritten;
+    pResult->cmdChecksumErrors = pStat->cmdChecksumErrors;
+    pResult->latencySum = pStat->latencySum;
+  }
+
+  return 0;
+}
+
+// returns wall time, 0 on failure
+static double runInstances(const SILConfig* pConfig, uint32_t instances, uint32_t threads,
+    InstanceResult* pResults)
+{
+  Worker* pWorkers = calloc(threads, sizeof(Worker));
+  if(!pWorkers)
+    return 0.0;
+
+  double start = wallSeconds();
+
+  for(uint32_t i = 0; i < threads; i++)
+  {
+    pWorkers[i].pConfig = pConfig;
+    pWorkers[i].pResults = pResults;
+    pWorkers[i].first = i;
+    pWorkers[i].stride = threads;
+    pWorkers[i].instances = instances;
+
+    if(pthread_create(&pWorkers[i].thread, 0, &workerMain, &pWorkers[i]) != 0)
+    {
+      threads = i;
+      break;
+    }
+  }
+
+  for(uint32_t i = 0; i < threads; i++)
+    pthread_join(pWorkers[i].thread, 0);
+
+  double wall = wallSeconds() - start;
+
+  free(pWorkers);
+
+  return wall;
+}
+
+int main(int argc, char** argv)
+{
+  long cores = sysconf(_SC_NPROCESSORS_ONLN);
+  uint32_t maxThreads = cores > 0 ? cores : 1;
+  uint32_t instances = 0;
+  SILConfig config = {
+    .seconds = 10.0,
+    .llPhaseUs = 500.0,
+  };
+  int opt;
+
+  while((opt = getopt(argc, argv, "n:j:t:")) != -1)
+  {
+    switch(opt)
+    {
+      case 'n':
+        instances = atoi(optarg);
+        break;
+      case 'j':
+        maxThreads = atoi(optarg);
+        break;
+      case 't':
+        config.seconds = atof(optarg);
+        break;
+      default:
+        fprintf(stderr, "usage: %s [-n instances] [-j max threads] [-t seconds per instance]\n", argv[0]);
+        return 1;
+    }
+  }
+
+  if(maxThreads < 1)
+    maxThreads = 1;
+
+  if(instances == 0)
+    instances = 2*maxThreads;
+
+  InstanceResult* pResults = calloc(instances, sizeof(InstanceResult));
+  if(!pResults)
+    return 1;
+
+  printf("{\n");
+  printf("  \"suite\": \"host-multi\",\n");
+  printf("  \"version\": \"%d.%d\",\n", __VERSION_MAJOR, __VERSION_MINOR);
+  printf("  \"instances\": %u,\n", instances);
+  printf("  \"secondsPerInstance\": %.3f,\n", config.seconds);
+  printf("  \"cores\": %ld,\n", cores);
+  printf("  \"runs\": [\n");
+
+  double baseThroughput = 0.0;
+  uint32_t mismatches = 0;
+
+  for(uint32_t threads = 1; threads <= maxThreads; threads = threads < maxThreads && threads*2 > maxThreads ? maxThreads : threads*2)
+  {
+    memset(pResults, 0, instances*sizeof(InstanceResult));
+
+    double wall = runInstances(&config, instances, threads, pResults);
+    double throughput = wall > 0.0 ? instances*config.seconds/wall : 0.0;
+
+    if(threads == 1)
+      baseThroughput = throughput;
+
+    for(uint32_t i = 1; i < instances; i++)
+    {
+      if(memcmp(&pResults[i], &pResults[0], sizeof(InstanceResult)) != 0)
+        ++mismatches;
+    }
+
+    printf("    { \"threads\": %u, \"wallSeconds\": %.3f, \"simSecondsPerSecond\": %.1f, \"scaling\": %.2f, \"efficiency\": %.2f }%s\n",
+        threads, wall, throughput,
+        baseThroughput > 0.0 ? throughput/baseThroughput : 0.0,
+        baseThroughput > 0.0 ? throughput/baseThroughput/threads : 0.0,
+        threads == maxThreads ? "" : ",");
+
+    if(threads == maxThreads)
+      break;
+  }
+
+  printf("  ],\n");
+  printf("  \"instance\": { \"ticks\": %llu, \"framesConsumed\": %u, \"cmdWritten\": %u, \"checksumErrors\": %u },\n",
+      (unsigned long long)pResults[0].ticks, pResults[0].framesConsumed, pResults[0].cmdWritten,
+      pResults[0].cmdChecksumErrors);
+  printf("  \"mismatches\": %u\n", mismatches);
+  printf("}\n");
+
+  free(pResults);
+
+  return mismatches ? 1 : 0;
+}
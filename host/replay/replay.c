@@ -0,0 +1,355 @@
+/*
+ * Copyright (C) 2017 Intel Deutschland GmbH, Germany
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Replays a capture (see src/capture.h) into a host build of the firmware.
+// Each tick record runs one mainloop() pass, recorded input bytes are fed to
+// the same handlers as on the target in the recorded order, so the same
+// capture always produces the same outputs. Outputs (UART0 Tx bytes and HL to
+// LL SSP frames) can be written to a text file and diffed between firmware
+// versions, mainloop() host timing is reported as JSON on stdout.
+//
+// usage: host-replay [-o output file] capture file
+
+#include "LPC214x.h"
+#include "irq.h"
+#include "host_hal.h"
+#include "host_ssp.h"
+#include "host_firmware.h"
+#include "main.h"
+#include "capture.h"
+#include "ll_hl_comm.h"
+#include "hal/system.h"
+#include "hal/uart0.h"
+#include "hal/ublox.h"
+#include "hal/sys_time.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define SSP_FRAME_SIZE 42
+
+typedef struct _Replay
+{
+  FILE* pOut;
+  uint64_t tick;
+  uint32_t outputHash;
+
+  uint8_t frame[SSP_FRAME_SIZE];
+  uint8_t frameUsed;
+
+  uint8_t sspLow;       // SSP bytes are recorded in pairs, low byte first
+  uint8_t sspHasLow;
+
+  struct
+  {
+    uint32_t ssp;
+    uint32_t gps;
+    uint32_t uart0;
+  } in;
+
+  struct
+  {
+    uint32_t uart0Bytes;
+    uint32_t sspFrames;
+  } out;
+} Replay;
+
+static Replay replay;
+
+static uint8_t* loadFile(const char* pFile, uint32_t* pSize)
+{
+  FILE* pIn = fopen(pFile, "rb");
+  if(!pIn)
+  {
+    perror(pFile);
+    return 0;
+  }
+
+  fseek(pIn, 0, SEEK_END);
+  long size = ftell(pIn);
+  fseek(pIn, 0, SEEK_SET);
+
+  uint8_t* pData = malloc(size > 0 ? size : 1);
+  if(pData && fread(pData, 1, size, pIn) != (size_t)size)
+  {
+    free(pData);
+    pData = 0;
+  }
+
+  fclose(pIn);
+
+  *pSize = size;
+  return pData;
+}
+
+static double nowNs(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec*1e9 + ts.tv_nsec;
+}
+
+static int compareDouble(const void* pA, const void* pB)
+{
+  double a = *(const double*)pA;
+  double b = *(const double*)pB;
+  return (a > b) - (a < b);
+}
+
+// FNV-1a over all outputs, for a quick comparison of two runs
+static void hashOutput(const uint8_t* pData, uint32_t size)
+{
+  for(uint32_t i = 0; i < size; i++)
+  {
+    replay.outputHash ^= pData[i];
+    replay.outputHash *= 16777619;
+  }
+}
+
+static void writeOutput(const char* pName, const uint8_t* pData, uint32_t size)
+{
+  hashOutput(pData, size);
+
+  if(!replay.pOut)
+    return;
+
+  fprintf(replay.pOut, "%llu %s ", (unsigned long long)replay.tick, pName);
+  for(uint32_t i = 0; i < size; i++)
+    fprintf(replay.pOut, "%02x", pData[i]);
+  fprintf(replay.pOut, "\n");
+}
+
+// the LL side is not emulated, only HL Tx words are clocked and framed
+static void clockSSP(uint32_t words)
+{
+  for(uint32_t i = 0; i < words; i++)
+  {
+    uint16_t word;
+
+    if(HostSSPTransfer(0, 0, &word))
+    {
+      uint8_t lo = word & 0xFF;
+      uint8_t hi = word >> 8;
+
+      if(replay.frameUsed == 0 && (lo != '>' || hi != '*'))
+      {
+        HostSSPService();
+        continue;
+      }
+
+      replay.frame[replay.frameUsed++] = lo;
+      replay.frame[replay.frameUsed++] = hi;
+
+      if(replay.frameUsed == SSP_FRAME_SIZE)
+      {
+        writeOutput("ssp", replay.frame, SSP_FRAME_SIZE);
+        replay.out.sspFrames++;
+        replay.frameUsed = 0;
+      }
+    }
+
+    HostSSPService();
+  }
+}
+
+static void drainUART0(void)
+{
+  uint8_t buf[UART0_BUFFER_SIZE];
+  uint32_t used = 0;
+
+  while(FifoGet(&uart0.txFifo, &buf[used]) == 0)
+    ++used;
+
+  if(used)
+  {
+    writeOutput("uart0", buf, used);
+    replay.out.uart0Bytes += used;
+  }
+}
+
+int main(int argc, char** argv)
+{
+  const char* pOutFile = 0;
+  int opt;
+
+  while((opt = getopt(argc, argv, "o:")) != -1)
+  {
+    switch(opt)
+    {
+      case 'o':
+        pOutFile = optarg;
+        break;
+      default:
+        fprintf(stderr, "usage: %s [-o output file] capture file\n", argv[0]);
+        return 1;
+    }
+  }
+
+  if(optind >= argc)
+  {
+    fprintf(stderr, "usage: %s [-o output file] capture file\n", argv[0]);
+    return 1;
+  }
+
+  uint32_t fileSize;
+  uint8_t* pFile = loadFile(argv[optind], &fileSize);
+  if(!pFile)
+    return 1;
+
+  CaptureHeader header;
+  if(fileSize < sizeof(CaptureHeader))
+  {
+    fprintf(stderr, "%s: too small for a capture\n", argv[optind]);
+    return 1;
+  }
+
+  memcpy(&header, pFile, sizeof(CaptureHeader));
+  if(header.magic != CAPTURE_MAGIC || header.version != CAPTURE_VERSION
+      || header.recordSize > fileSize - sizeof(CaptureHeader))
+  {
+    fprintf(stderr, "%s: not a valid capture\n", argv[optind]);
+    return 1;
+  }
+
+  if(pOutFile)
+  {
+    replay.pOut = fopen(pOutFile, "w");
+    if(!replay.pOut)
+    {
+      perror(pOutFile);
+      return 1;
+    }
+  }
+
+  replay.outputHash = 2166136261;
+
+  HostHalInit();
+  HostSSPSetRxDiscard(1);
+  HostFirmwareInit();
+
+  // TEMT never set, UART0 Tx data stays in the fifo and is drained after each cycle
+  U0LSR = 0x00;
+
+  const uint64_t startCycles = (uint64_t)header.startTimeUs*CPU_CLOCK_HZ/1000000;
+  const uint32_t wordsPerTick = header.tickCycles/HostSSPCyclesPerWord();
+
+  const uint8_t* pRec = pFile + sizeof(CaptureHeader);
+  const uint8_t* pEnd = pRec + header.recordSize;
+
+  double* pLoopNs = malloc((header.recordSize + 1)*sizeof(double));
+  uint32_t loops = 0;
+  double loopNsSum = 0.0;
+
+  replay.tick = header.firstTick;
+
+  double wallStart = nowNs();
+
+  while(pRec < pEnd)
+  {
+    uint8_t source = *pRec >> 6;
+    uint8_t count = *pRec & CAPTURE_MAX_COUNT;
+    ++pRec;
+
+    if(source == CAPTURE_SRC_TICK)
+    {
+      replay.tick += count;
+      HostSetCycles(startCycles + replay.tick*header.tickCycles);
+      HostTimer0Match();
+
+      T0IR = 0x01;
+      HostRaiseIrq(TIMER0_INT);
+
+      double start = nowNs();
+      mainloopHostCycle();
+      double ns = nowNs() - start;
+
+      pLoopNs[loops++] = ns;
+      loopNsSum += ns;
+
+      // same background job chunk as host/sil after each tick
+      mainloopHostIdle();
+
+      drainUART0();
+      clockSSP(wordsPerTick);
+      continue;
+    }
+
+    if(count > pEnd - pRec)
+      break;
+
+    for(uint8_t i = 0; i < count; i++, pRec++)
+    {
+      switch(source)
+      {
+        case CAPTURE_SRC_SSP:
+          if(replay.sspHasLow)
+            SSP_rx_handler_HL(replay.sspLow | (*pRec << 8));
+          replay.sspLow = *pRec;
+          replay.sspHasLow = !replay.sspHasLow;
+          replay.in.ssp++;
+          break;
+        case CAPTURE_SRC_GPS:
+          uBloxReceiveHandler(*pRec);
+          replay.in.gps++;
+          break;
+        case CAPTURE_SRC_UART0:
+          FifoPut(&uart0.rxFifo, *pRec);
+          replay.in.uart0++;
+
+          // as uart0IRQ() and the idle loop
+          if(*pRec == 0)
+          {
+            ++uart0.rxDelimiters;
+            mainloopHostIdle();
+          }
+          break;
+      }
+    }
+  }
+
+  double wallNs = nowNs() - wallStart;
+
+  if(replay.pOut)
+    fclose(replay.pOut);
+
+  qsort(pLoopNs, loops, sizeof(double), &compareDouble);
+
+  printf("{\n");
+  printf("  \"suite\": \"host-replay\",\n");
+  printf("  \"version\": \"%d.%d\",\n", __VERSION_MAJOR, __VERSION_MINOR);
+  printf("  \"captureFirmware\": \"%d.%d\",\n", header.firmwareVersion >> 8, header.firmwareVersion & 0xFF);
+  printf("  \"captureBytes\": %u,\n", header.recordSize);
+  printf("  \"overwrittenBytes\": %u,\n", header.overwritten);
+  printf("  \"wallSeconds\": %.3f,\n", wallNs*1e-9);
+  printf("  \"inputs\": { \"ticks\": %u, \"ssp\": %u, \"gps\": %u, \"uart0\": %u },\n",
+      loops, replay.in.ssp, replay.in.gps, replay.in.uart0);
+  printf("  \"outputs\": { \"uart0Bytes\": %u, \"sspFrames\": %u, \"hash\": \"%08x\" },\n",
+      replay.out.uart0Bytes, replay.out.sspFrames, replay.outputHash);
+  printf("  \"mainloopNs\": { \"min\": %.0f, \"mean\": %.0f, \"p50\": %.0f, \"p99\": %.0f, \"max\": %.0f }\n",
+      loops ? pLoopNs[0] : 0.0,
+      loops ? loopNsSum/loops : 0.0,
+      loops ? pLoopNs[loops/2] : 0.0,
+      loops ? pLoopNs[(uint64_t)loops*99/100] : 0.0,
+      loops ? pLoopNs[loops-1] : 0.0);
+  printf("}\n");
+
+  free(pLoopNs);
+  free(pFile);
+
+  return 0;
+}
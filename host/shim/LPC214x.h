@@ -0,0 +1,418 @@
+/*
+ * Copyright (C) 2017 Intel Deutschland GmbH, Germany
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Host replacement for src/LPC214x.h.
+// Same register names and addresses, but every register is a 32-bit cell in
+// hostRegisters[] instead of a memory mapped peripheral. SSPDR and SSPSR have
+// side effects on real hardware and are served by host_ssp.c. The host build
+// force-includes this file, so the include guard below turns every later
+// #include "LPC214x.h" (including "../LPC214x.h") into a no-op.
+
+#ifndef __LPC214x_H
+#define __LPC214x_H
+
+#include <stdint.h>
+#include "context.h"
+
+#define HOST_REG_SPACE 0x00200000UL
+
+extern CONTEXT_LOCAL volatile uint32_t hostRegisters[HOST_REG_SPACE/4];
+
+#define HOST_REG(addr) (hostRegisters[((addr) & (HOST_REG_SPACE-1)) >> 2])
+
+extern volatile uint32_t* HostSSPStatus(void);
+extern volatile uint32_t* HostSSPData(void);
+
+/* Vectored Interrupt Controller (VIC) */
+#define VIC_BASE_ADDR	0xFFFFF000
+
+#define VICIRQStatus   HOST_REG(VIC_BASE_ADDR + 0x000)
+#define VICFIQStatus   HOST_REG(VIC_BASE_ADDR + 0x004)
+#define VICRawIntr     HOST_REG(VIC_BASE_ADDR + 0x008)
+#define VICIntSelect   HOST_REG(VIC_BASE_ADDR + 0x00C)
+#define VICIntEnable   HOST_REG(VIC_BASE_ADDR + 0x010)
+#define VICIntEnClr    HOST_REG(VIC_BASE_ADDR + 0x014)
+#define VICSoftInt     HOST_REG(VIC_BASE_ADDR + 0x018)
+#define VICSoftIntClr  HOST_REG(VIC_BASE_ADDR + 0x01C)
+#define VICProtection  HOST_REG(VIC_BASE_ADDR + 0x020)
+#define VICVectAddr    HOST_REG(VIC_BASE_ADDR + 0x030)
+#define VICDefVectAddr HOST_REG(VIC_BASE_ADDR + 0x034)
+#define VICVectAddr0   HOST_REG(VIC_BASE_ADDR + 0x100)
+#define VICVectAddr1   HOST_REG(VIC_BASE_ADDR + 0x104)
+#define VICVectAddr2   HOST_REG(VIC_BASE_ADDR + 0x108)
+#define VICVectAddr3   HOST_REG(VIC_BASE_ADDR + 0x10C)
+#define VICVectAddr4   HOST_REG(VIC_BASE_ADDR + 0x110)
+#define VICVectAddr5   HOST_REG(VIC_BASE_ADDR + 0x114)
+#define VICVectAddr6   HOST_REG(VIC_BASE_ADDR + 0x118)
+#define VICVectAddr7   HOST_REG(VIC_BASE_ADDR + 0x11C)
+#define VICVectAddr8   HOST_REG(VIC_BASE_ADDR + 0x120)
+#define VICVectAddr9   HOST_REG(VIC_BASE_ADDR + 0x124)
+#define VICVectAddr10  HOST_REG(VIC_BASE_ADDR + 0x128)
+#define VICVectAddr11  HOST_REG(VIC_BASE_ADDR + 0x12C)
+#define VICVectAddr12  HOST_REG(VIC_BASE_ADDR + 0x130)
+#define VICVectAddr13  HOST_REG(VIC_BASE_ADDR + 0x134)
+#define VICVectAddr14  HOST_REG(VIC_BASE_ADDR + 0x138)
+#define VICVectAddr15  HOST_REG(VIC_BASE_ADDR + 0x13C)
+#define VICVectCntl0   HOST_REG(VIC_BASE_ADDR + 0x200)
+#define VICVectCntl1   HOST_REG(VIC_BASE_ADDR + 0x204)
+#define VICVectCntl2   HOST_REG(VIC_BASE_ADDR + 0x208)
+#define VICVectCntl3   HOST_REG(VIC_BASE_ADDR + 0x20C)
+#define VICVectCntl4   HOST_REG(VIC_BASE_ADDR + 0x210)
+#define VICVectCntl5   HOST_REG(VIC_BASE_ADDR + 0x214)
+#define VICVectCntl6   HOST_REG(VIC_BASE_ADDR + 0x218)
+#define VICVectCntl7   HOST_REG(VIC_BASE_ADDR + 0x21C)
+#define VICVectCntl8   HOST_REG(VIC_BASE_ADDR + 0x220)
+#define VICVectCntl9   HOST_REG(VIC_BASE_ADDR + 0x224)
+#define VICVectCntl10  HOST_REG(VIC_BASE_ADDR + 0x228)
+#define VICVectCntl11  HOST_REG(VIC_BASE_ADDR + 0x22C)
+#define VICVectCntl12  HOST_REG(VIC_BASE_ADDR + 0x230)
+#define VICVectCntl13  HOST_REG(VIC_BASE_ADDR + 0x234)
+#define VICVectCntl14  HOST_REG(VIC_BASE_ADDR + 0x238)
+#define VICVectCntl15  HOST_REG(VIC_BASE_ADDR + 0x23C)
+
+/* Pin Connect Block */
+#define PINSEL_BASE_ADDR	0xE002C000
+#define PINSEL0        HOST_REG(PINSEL_BASE_ADDR + 0x00)
+#define PINSEL1        HOST_REG(PINSEL_BASE_ADDR + 0x04)
+#define PINSEL2        HOST_REG(PINSEL_BASE_ADDR + 0x14)
+
+/* General Purpose Input/Output (GPIO) */
+#define GPIO_BASE_ADDR		0xE0028000
+#define IOPIN0         HOST_REG(GPIO_BASE_ADDR + 0x00)
+#define IOSET0         HOST_REG(GPIO_BASE_ADDR + 0x04)
+#define IODIR0         HOST_REG(GPIO_BASE_ADDR + 0x08)
+#define IOCLR0         HOST_REG(GPIO_BASE_ADDR + 0x0C)
+#define IOPIN1         HOST_REG(GPIO_BASE_ADDR + 0x10)
+#define IOSET1         HOST_REG(GPIO_BASE_ADDR + 0x14)
+#define IODIR1         HOST_REG(GPIO_BASE_ADDR + 0x18)
+#define IOCLR1         HOST_REG(GPIO_BASE_ADDR + 0x1C)
+
+/* Fast I/O setup */
+#define FIO_BASE_ADDR		0x3FFFC000
+#define FIO0DIR        HOST_REG(FIO_BASE_ADDR + 0x00)
+#define FIO0MASK       HOST_REG(FIO_BASE_ADDR + 0x10)
+#define FIO0PIN        HOST_REG(FIO_BASE_ADDR + 0x14)
+#define FIO0SET        HOST_REG(FIO_BASE_ADDR + 0x18)
+#define FIO0CLR        HOST_REG(FIO_BASE_ADDR + 0x1C)
+#define FIO1DIR        HOST_REG(FIO_BASE_ADDR + 0x20)
+#define FIO1MASK       HOST_REG(FIO_BASE_ADDR + 0x30)
+#define FIO1PIN        HOST_REG(FIO_BASE_ADDR + 0x34)
+#define FIO1SET        HOST_REG(FIO_BASE_ADDR + 0x38)
+#define FIO1CLR        HOST_REG(FIO_BASE_ADDR + 0x3C)
+
+/* System Control Block(SCB) modules include Memory Accelerator Module,
+Phase Locked Loop, VPB divider, Power Control, External Interrupt,
+Reset, and Code Security/Debugging */
+
+#define SCB_BASE_ADDR	0xE01FC000
+
+/* Memory Accelerator Module (MAM) */
+#define MAMCR          HOST_REG(SCB_BASE_ADDR + 0x000)
+#define MAMTIM         HOST_REG(SCB_BASE_ADDR + 0x004)
+#define MEMMAP         HOST_REG(SCB_BASE_ADDR + 0x040)
+
+/* Phase Locked Loop (PLL) */
+#define PLLCON         HOST_REG(SCB_BASE_ADDR + 0x080)
+#define PLLCFG         HOST_REG(SCB_BASE_ADDR + 0x084)
+#define PLLSTAT        HOST_REG(SCB_BASE_ADDR + 0x088)
+#define PLLFEED        HOST_REG(SCB_BASE_ADDR + 0x08C)
+
+/* PLL48 Registers */
+#define PLL48CON       HOST_REG(SCB_BASE_ADDR + 0x0A0)
+#define PLL48CFG       HOST_REG(SCB_BASE_ADDR + 0x0A4)
+#define PLL48STAT      HOST_REG(SCB_BASE_ADDR + 0x0A8)
+#define PLL48FEED      HOST_REG(SCB_BASE_ADDR + 0x0AC)
+
+/* Power Control */
+#define PCON           HOST_REG(SCB_BASE_ADDR + 0x0C0)
+#define PCONP          HOST_REG(SCB_BASE_ADDR + 0x0C4)
+
+/* VPB Divider */
+#define VPBDIV         HOST_REG(SCB_BASE_ADDR + 0x100)
+
+/* External Interrupts */
+#define EXTINT         HOST_REG(SCB_BASE_ADDR + 0x140)
+#define INTWAKE        HOST_REG(SCB_BASE_ADDR + 0x144)
+#define EXTMODE        HOST_REG(SCB_BASE_ADDR + 0x148)
+#define EXTPOLAR       HOST_REG(SCB_BASE_ADDR + 0x14C)
+
+/* Reset */
+#define RSIR           HOST_REG(SCB_BASE_ADDR + 0x180)
+
+/* System Controls and Status */
+#define SCS            HOST_REG(SCB_BASE_ADDR + 0x1A0)
+
+/* Timer 0 */
+#define TMR0_BASE_ADDR		0xE0004000
+#define T0IR           HOST_REG(TMR0_BASE_ADDR + 0x00)
+#define T0TCR          HOST_REG(TMR0_BASE_ADDR + 0x04)
+#define T0TC           HOST_REG(TMR0_BASE_ADDR + 0x08)
+#define T0PR           HOST_REG(TMR0_BASE_ADDR + 0x0C)
+#define T0PC           HOST_REG(TMR0_BASE_ADDR + 0x10)
+#define T0MCR          HOST_REG(TMR0_BASE_ADDR + 0x14)
+#define T0MR0          HOST_REG(TMR0_BASE_ADDR + 0x18)
+#define T0MR1          HOST_REG(TMR0_BASE_ADDR + 0x1C)
+#define T0MR2          HOST_REG(TMR0_BASE_ADDR + 0x20)
+#define T0MR3          HOST_REG(TMR0_BASE_ADDR + 0x24)
+#define T0CCR          HOST_REG(TMR0_BASE_ADDR + 0x28)
+#define T0CR0          HOST_REG(TMR0_BASE_ADDR + 0x2C)
+#define T0CR1          HOST_REG(TMR0_BASE_ADDR + 0x30)
+#define T0CR2          HOST_REG(TMR0_BASE_ADDR + 0x34)
+#define T0CR3          HOST_REG(TMR0_BASE_ADDR + 0x38)
+#define T0EMR          HOST_REG(TMR0_BASE_ADDR + 0x3C)
+#define T0CTCR         HOST_REG(TMR0_BASE_ADDR + 0x70)
+
+/* Timer 1 */
+#define TMR1_BASE_ADDR		0xE0008000
+#define T1IR           HOST_REG(TMR1_BASE_ADDR + 0x00)
+#define T1TCR          HOST_REG(TMR1_BASE_ADDR + 0x04)
+#define T1TC           HOST_REG(TMR1_BASE_ADDR + 0x08)
+#define T1PR           HOST_REG(TMR1_BASE_ADDR + 0x0C)
+#define T1PC           HOST_REG(TMR1_BASE_ADDR + 0x10)
+#define T1MCR          HOST_REG(TMR1_BASE_ADDR + 0x14)
+#define T1MR0          HOST_REG(TMR1_BASE_ADDR + 0x18)
+#define T1MR1          HOST_REG(TMR1_BASE_ADDR + 0x1C)
+#define T1MR2          HOST_REG(TMR1_BASE_ADDR + 0x20)
+#define T1MR3          HOST_REG(TMR1_BASE_ADDR + 0x24)
+#define T1CCR          HOST_REG(TMR1_BASE_ADDR + 0x28)
+#define T1CR0          HOST_REG(TMR1_BASE_ADDR + 0x2C)
+#define T1CR1          HOST_REG(TMR1_BASE_ADDR + 0x30)
+#define T1CR2          HOST_REG(TMR1_BASE_ADDR + 0x34)
+#define T1CR3          HOST_REG(TMR1_BASE_ADDR + 0x38)
+#define T1EMR          HOST_REG(TMR1_BASE_ADDR + 0x3C)
+#define T1CTCR         HOST_REG(TMR1_BASE_ADDR + 0x70)
+
+/* Pulse Width Modulator (PWM) */
+#define PWM_BASE_ADDR		0xE0014000
+#define PWMIR          HOST_REG(PWM_BASE_ADDR + 0x00)
+#define PWMTCR         HOST_REG(PWM_BASE_ADDR + 0x04)
+#define PWMTC          HOST_REG(PWM_BASE_ADDR + 0x08)
+#define PWMPR          HOST_REG(PWM_BASE_ADDR + 0x0C)
+#define PWMPC          HOST_REG(PWM_BASE_ADDR + 0x10)
+#define PWMMCR         HOST_REG(PWM_BASE_ADDR + 0x14)
+#define PWMMR0         HOST_REG(PWM_BASE_ADDR + 0x18)
+#define PWMMR1         HOST_REG(PWM_BASE_ADDR + 0x1C)
+#define PWMMR2         HOST_REG(PWM_BASE_ADDR + 0x20)
+#define PWMMR3         HOST_REG(PWM_BASE_ADDR + 0x24)
+#define PWMMR4         HOST_REG(PWM_BASE_ADDR + 0x40)
+#define PWMMR5         HOST_REG(PWM_BASE_ADDR + 0x44)
+#define PWMMR6         HOST_REG(PWM_BASE_ADDR + 0x48)
+#define PWMEMR         HOST_REG(PWM_BASE_ADDR + 0x3C)
+#define PWMPCR         HOST_REG(PWM_BASE_ADDR + 0x4C)
+#define PWMLER         HOST_REG(PWM_BASE_ADDR + 0x50)
+
+/* Universal Asynchronous Receiver Transmitter 0 (UART0) */
+#define UART0_BASE_ADDR		0xE000C000
+#define U0RBR          HOST_REG(UART0_BASE_ADDR + 0x00)
+#define U0THR          HOST_REG(UART0_BASE_ADDR + 0x00)
+#define U0DLL          HOST_REG(UART0_BASE_ADDR + 0x00)
+#define U0DLM          HOST_REG(UART0_BASE_ADDR + 0x04)
+#define U0IER          HOST_REG(UART0_BASE_ADDR + 0x04)
+#define U0IIR          HOST_REG(UART0_BASE_ADDR + 0x08)
+#define U0FCR          HOST_REG(UART0_BASE_ADDR + 0x08)
+#define U0LCR          HOST_REG(UART0_BASE_ADDR + 0x0C)
+#define U0MCR          HOST_REG(UART0_BASE_ADDR + 0x10)
+#define U0LSR          HOST_REG(UART0_BASE_ADDR + 0x14)
+#define U0MSR          HOST_REG(UART0_BASE_ADDR + 0x18)
+#define U0SCR          HOST_REG(UART0_BASE_ADDR + 0x1C)
+#define U0ACR          HOST_REG(UART0_BASE_ADDR + 0x20)
+#define U0FDR          HOST_REG(UART0_BASE_ADDR + 0x28)
+#define U0TER          HOST_REG(UART0_BASE_ADDR + 0x30)
+
+/* Universal Asynchronous Receiver Transmitter 1 (UART1) */
+#define UART1_BASE_ADDR		0xE0010000
+#define U1RBR          HOST_REG(UART1_BASE_ADDR + 0x00)
+#define U1THR          HOST_REG(UART1_BASE_ADDR + 0x00)
+#define U1DLL          HOST_REG(UART1_BASE_ADDR + 0x00)
+#define U1DLM          HOST_REG(UART1_BASE_ADDR + 0x04)
+#define U1IER          HOST_REG(UART1_BASE_ADDR + 0x04)
+#define U1IIR          HOST_REG(UART1_BASE_ADDR + 0x08)
+#define U1FCR          HOST_REG(UART1_BASE_ADDR + 0x08)
+#define U1LCR          HOST_REG(UART1_BASE_ADDR + 0x0C)
+#define U1MCR          HOST_REG(UART1_BASE_ADDR + 0x10)
+#define U1LSR          HOST_REG(UART1_BASE_ADDR + 0x14)
+#define U1MSR          HOST_REG(UART1_BASE_ADDR + 0x18)
+#define U1SCR          HOST_REG(UART1_BASE_ADDR + 0x1C)
+#define U1ACR          HOST_REG(UART1_BASE_ADDR + 0x20)
+#define U1FDR          HOST_REG(UART1_BASE_ADDR + 0x28)
+#define U1TER          HOST_REG(UART1_BASE_ADDR + 0x30)
+
+/* I2C Interface 0 */
+#define I2C0_BASE_ADDR		0xE001C000
+#define I20CONSET      HOST_REG(I2C0_BASE_ADDR + 0x00)
+#define I20STAT        HOST_REG(I2C0_BASE_ADDR + 0x04)
+#define I20DAT         HOST_REG(I2C0_BASE_ADDR + 0x08)
+#define I20ADR         HOST_REG(I2C0_BASE_ADDR + 0x0C)
+#define I20SCLH        HOST_REG(I2C0_BASE_ADDR + 0x10)
+#define I20SCLL        HOST_REG(I2C0_BASE_ADDR + 0x14)
+#define I20CONCLR      HOST_REG(I2C0_BASE_ADDR + 0x18)
+
+/* I2C Interface 1 */
+#define I2C1_BASE_ADDR		0xE005C000
+#define I21CONSET      HOST_REG(I2C1_BASE_ADDR + 0x00)
+#define I21STAT        HOST_REG(I2C1_BASE_ADDR + 0x04)
+#define I21DAT         HOST_REG(I2C1_BASE_ADDR + 0x08)
+#define I21ADR         HOST_REG(I2C1_BASE_ADDR + 0x0C)
+#define I21SCLH        HOST_REG(I2C1_BASE_ADDR + 0x10)
+#define I21SCLL        HOST_REG(I2C1_BASE_ADDR + 0x14)
+#define I21CONCLR      HOST_REG(I2C1_BASE_ADDR + 0x18)
+
+/* SPI0 (Serial Peripheral Interface 0) */
+#define SPI0_BASE_ADDR		0xE0020000
+#define S0SPCR         HOST_REG(SPI0_BASE_ADDR + 0x00)
+#define S0SPSR         HOST_REG(SPI0_BASE_ADDR + 0x04)
+#define S0SPDR         HOST_REG(SPI0_BASE_ADDR + 0x08)
+#define S0SPCCR        HOST_REG(SPI0_BASE_ADDR + 0x0C)
+#define S0SPINT        HOST_REG(SPI0_BASE_ADDR + 0x1C)
+
+/* SSP Controller */
+#define SSP_BASE_ADDR		0xE0068000
+#define SSPCR0         HOST_REG(SSP_BASE_ADDR + 0x00)
+#define SSPCR1         HOST_REG(SSP_BASE_ADDR + 0x04)
+#define SSPDR          (*HostSSPData())    // served by the SSP model in host_ssp.c
+#define SSPSR          (*HostSSPStatus())  // served by the SSP model in host_ssp.c
+#define SSPCPSR        HOST_REG(SSP_BASE_ADDR + 0x10)
+#define SSPIMSC        HOST_REG(SSP_BASE_ADDR + 0x14)
+#define SSPRIS         HOST_REG(SSP_BASE_ADDR + 0x18)
+#define SSPMIS         HOST_REG(SSP_BASE_ADDR + 0x1C)
+#define SSPICR         HOST_REG(SSP_BASE_ADDR + 0x20)
+
+/* Real Time Clock */
+#define RTC_BASE_ADDR		0xE0024000
+#define ILR            HOST_REG(RTC_BASE_ADDR + 0x00)
+#define CTC            HOST_REG(RTC_BASE_ADDR + 0x04)
+#define CCR            HOST_REG(RTC_BASE_ADDR + 0x08)
+#define CIIR           HOST_REG(RTC_BASE_ADDR + 0x0C)
+#define AMR            HOST_REG(RTC_BASE_ADDR + 0x10)
+#define CTIME0         HOST_REG(RTC_BASE_ADDR + 0x14)
+#define CTIME1         HOST_REG(RTC_BASE_ADDR + 0x18)
+#define CTIME2         HOST_REG(RTC_BASE_ADDR + 0x1C)
+#define SEC            HOST_REG(RTC_BASE_ADDR + 0x20)
+#define MIN            HOST_REG(RTC_BASE_ADDR + 0x24)
+#define HOUR           HOST_REG(RTC_BASE_ADDR + 0x28)
+#define DOM            HOST_REG(RTC_BASE_ADDR + 0x2C)
+#define DOW            HOST_REG(RTC_BASE_ADDR + 0x30)
+#define DOY            HOST_REG(RTC_BASE_ADDR + 0x34)
+#define MONTH          HOST_REG(RTC_BASE_ADDR + 0x38)
+#define YEAR           HOST_REG(RTC_BASE_ADDR + 0x3C)
+#define ALSEC          HOST_REG(RTC_BASE_ADDR + 0x60)
+#define ALMIN          HOST_REG(RTC_BASE_ADDR + 0x64)
+#define ALHOUR         HOST_REG(RTC_BASE_ADDR + 0x68)
+#define ALDOM          HOST_REG(RTC_BASE_ADDR + 0x6C)
+#define ALDOW          HOST_REG(RTC_BASE_ADDR + 0x70)
+#define ALDOY          HOST_REG(RTC_BASE_ADDR + 0x74)
+#define ALMON          HOST_REG(RTC_BASE_ADDR + 0x78)
+#define ALYEAR         HOST_REG(RTC_BASE_ADDR + 0x7C)
+#define PREINT         HOST_REG(RTC_BASE_ADDR + 0x80)
+#define PREFRAC        HOST_REG(RTC_BASE_ADDR + 0x84)
+
+/* A/D Converter 0 (AD0) */
+#define AD0_BASE_ADDR		0xE0034000
+#define AD0CR          HOST_REG(AD0_BASE_ADDR + 0x00)
+#define AD0GDR         HOST_REG(AD0_BASE_ADDR + 0x04)
+#define AD0STAT        HOST_REG(AD0_BASE_ADDR + 0x30)
+#define AD0INTEN       HOST_REG(AD0_BASE_ADDR + 0x0C)
+#define AD0DR0         HOST_REG(AD0_BASE_ADDR + 0x10)
+#define AD0DR1         HOST_REG(AD0_BASE_ADDR + 0x14)
+#define AD0DR2         HOST_REG(AD0_BASE_ADDR + 0x18)
+#define AD0DR3         HOST_REG(AD0_BASE_ADDR + 0x1C)
+#define AD0DR4         HOST_REG(AD0_BASE_ADDR + 0x20)
+#define AD0DR5         HOST_REG(AD0_BASE_ADDR + 0x24)
+#define AD0DR6         HOST_REG(AD0_BASE_ADDR + 0x28)
+#define AD0DR7         HOST_REG(AD0_BASE_ADDR + 0x2C)
+
+#define ADGSR          HOST_REG(AD0_BASE_ADDR + 0x08)
+/* A/D Converter 1 (AD1) */
+#define AD1_BASE_ADDR		0xE0060000
+#define AD1CR          HOST_REG(AD1_BASE_ADDR + 0x00)
+#define AD1GDR         HOST_REG(AD1_BASE_ADDR + 0x04)
+#define AD1STAT        HOST_REG(AD1_BASE_ADDR + 0x30)
+#define AD1INTEN       HOST_REG(AD1_BASE_ADDR + 0x0C)
+#define AD1DR0         HOST_REG(AD1_BASE_ADDR + 0x10)
+#define AD1DR1         HOST_REG(AD1_BASE_ADDR + 0x14)
+#define AD1DR2         HOST_REG(AD1_BASE_ADDR + 0x18)
+#define AD1DR3         HOST_REG(AD1_BASE_ADDR + 0x1C)
+#define AD1DR4         HOST_REG(AD1_BASE_ADDR + 0x20)
+#define AD1DR5         HOST_REG(AD1_BASE_ADDR + 0x24)
+#define AD1DR6         HOST_REG(AD1_BASE_ADDR + 0x28)
+#define AD1DR7         HOST_REG(AD1_BASE_ADDR + 0x2C)
+
+/* D/A Converter */
+#define DAC_BASE_ADDR		0xE006C000
+#define DACR           HOST_REG(DAC_BASE_ADDR + 0x00)
+
+/* Watchdog */
+#define WDG_BASE_ADDR		0xE0000000
+#define WDMOD          HOST_REG(WDG_BASE_ADDR + 0x00)
+#define WDTC           HOST_REG(WDG_BASE_ADDR + 0x04)
+#define WDFEED         HOST_REG(WDG_BASE_ADDR + 0x08)
+#define WDTV           HOST_REG(WDG_BASE_ADDR + 0x0C)
+
+/* USB Controller */
+#define USB_BASE_ADDR		0xE0090000			/* USB Base Address */
+/* Device Interrupt Registers */
+#define DEV_INT_STAT    HOST_REG(USB_BASE_ADDR + 0x00)
+#define DEV_INT_EN      HOST_REG(USB_BASE_ADDR + 0x04)
+#define DEV_INT_CLR     HOST_REG(USB_BASE_ADDR + 0x08)
+#define DEV_INT_SET     HOST_REG(USB_BASE_ADDR + 0x0C)
+#define DEV_INT_PRIO    HOST_REG(USB_BASE_ADDR + 0x2C)
+
+/* Endpoint Interrupt Registers */
+#define EP_INT_STAT     HOST_REG(USB_BASE_ADDR + 0x30)
+#define EP_INT_EN       HOST_REG(USB_BASE_ADDR + 0x34)
+#define EP_INT_CLR      HOST_REG(USB_BASE_ADDR + 0x38)
+#define EP_INT_SET      HOST_REG(USB_BASE_ADDR + 0x3C)
+#define EP_INT_PRIO     HOST_REG(USB_BASE_ADDR + 0x40)
+
+/* Endpoint Realization Registers */
+#define REALIZE_EP      HOST_REG(USB_BASE_ADDR + 0x44)
+#define EP_INDEX        HOST_REG(USB_BASE_ADDR + 0x48)
+#define MAXPACKET_SIZE  HOST_REG(USB_BASE_ADDR + 0x4C)
+
+/* Command Reagisters */
+#define CMD_CODE        HOST_REG(USB_BASE_ADDR + 0x10)
+#define CMD_DATA        HOST_REG(USB_BASE_ADDR + 0x14)
+
+/* Data Transfer Registers */
+#define RX_DATA         HOST_REG(USB_BASE_ADDR + 0x18)
+#define TX_DATA         HOST_REG(USB_BASE_ADDR + 0x1C)
+#define RX_PLENGTH      HOST_REG(USB_BASE_ADDR + 0x20)
+#define TX_PLENGTH      HOST_REG(USB_BASE_ADDR + 0x24)
+#define USB_CTRL        HOST_REG(USB_BASE_ADDR + 0x28)
+
+/* DMA Registers */
+#define DMA_REQ_STAT        HOST_REG(USB_BASE_ADDR + 4 * 0x50)
+#define DMA_REQ_CLR         HOST_REG(USB_BASE_ADDR + 4 * 0x54)
+#define DMA_REQ_SET         HOST_REG(USB_BASE_ADDR + 4 * 0x58)
+#define UDCA_HEAD           HOST_REG(USB_BASE_ADDR + 4 * 0x80)
+#define EP_DMA_STAT         HOST_REG(USB_BASE_ADDR + 4 * 0x84)
+#define EP_DMA_EN           HOST_REG(USB_BASE_ADDR + 4 * 0x88)
+#define EP_DMA_DIS          HOST_REG(USB_BASE_ADDR + 4 * 0x8C)
+#define DMA_INT_STAT        HOST_REG(USB_BASE_ADDR + 4 * 0x90)
+#define DMA_INT_EN          HOST_REG(USB_BASE_ADDR + 4 * 0x94)
+#define EOT_INT_STAT        HOST_REG(USB_BASE_ADDR + 4 * 0xA0)
+#define EOT_INT_CLR         HOST_REG(USB_BASE_ADDR + 4 * 0xA4)
+#define EOT_INT_SET         HOST_REG(USB_BASE_ADDR + 4 * 0xA8)
+#define NDD_REQ_INT_STAT    HOST_REG(USB_BASE_ADDR + 4 * 0xAC)
+#define NDD_REQ_INT_CLR     HOST_REG(USB_BASE_ADDR + 4 * 0xB0)
+#define NDD_REQ_INT_SET     HOST_REG(USB_BASE_ADDR + 4 * 0xB4)
+#define SYS_ERR_INT_STAT    HOST_REG(USB_BASE_ADDR + 4 * 0xB8)
+#define SYS_ERR_INT_CLR     HOST_REG(USB_BASE_ADDR + 4 * 0xBC)
+#define SYS_ERR_INT_SET     HOST_REG(USB_BASE_ADDR + 4 * 0xC0)
+#define MODULE_ID           HOST_REG(USB_BASE_ADDR + 4 * 0xFC)
+
+#endif  // __LPC214x_H
+
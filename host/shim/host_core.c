@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2017 Intel Deutschland GmbH, Germany
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Host stand-ins for the main.c, uart0.c, ublox.c and sdk.c globals that the
+// platform independent core links against when the rest of the firmware is
+// not part of the host program (see host-bench).
+
+#include "main.h"
+#include "sdk.h"
+#include "hal/system.h"
+#include "hal/uart0.h"
+#include "hal/ublox.h"
+
+// main.c
+struct HL_STATUS HL_Status;
+volatile unsigned int GPS_timeout = 0;
+volatile char SYSTEM_initialized = 0;
+
+// hal/uart0.c
+UART0Data uart0;
+
+// hal/ublox.c
+GPSData gps;
+
+// sdk.c, user messages are dropped
+void SDKProcessUserMsg(const TransportHeader* pHeader, const uint8_t* pData, uint32_t dataSize)
+{
+  (void)pHeader;
+  (void)pData;
+  (void)dataSize;
+}
+
+void HostCoreInit(void)
+{
+  FifoInit(&uart0.txFifo, uart0.txBuf, UART0_BUFFER_SIZE);
+  FifoInit(&uart0.rxFifo, uart0.rxBuf, UART0_BUFFER_SIZE);
+}
@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2017 Intel Deutschland GmbH, Germany
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "host_firmware.h"
+#include "main.h"
+#include "sdk.h"
+#include "cli.h"
+#include "terminal.h"
+#include "hal/system.h"
+#include "hal/buzzer.h"
+#include "hal/led.h"
+#include "hal/i2c1.h"
+#include "hal/pelican_ptu.h"
+#include "hal/uart0.h"
+#include "util/build_info.h"
+
+void HostFirmwareInit(void)
+{
+  init();
+  BuzzerEnable(0);
+
+  TerminalInit(&uart0.rxFifo, &uart0.txFifo, &CLICmdCallback, &CLIEscCallback);
+
+  I2C1Init();
+  I2C1SetRGBLed(255, 0, 0);
+
+  generateBuildInfo();
+
+  LEDGreenEnable(1);
+
+  PTU_init();
+
+  mainloopInit();
+
+  SDKInit();
+}
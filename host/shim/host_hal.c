@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2017 Intel Deutschland GmbH, Germany
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Host stand-ins for win_arm/irq.c and the emulated register file.
+
+#include "LPC214x.h"
+#include "irq.h"
+#include "host_hal.h"
+#include "host_ssp.h"
+#include "hal/sys_time.h"
+#include <string.h>
+
+CONTEXT_LOCAL volatile uint32_t hostRegisters[HOST_REG_SPACE/4];
+
+static CONTEXT_LOCAL void (*hostIrqHandlers[32])(void);
+static CONTEXT_LOCAL uint64_t hostCycles;
+static CONTEXT_LOCAL uint64_t hostTimer0Start;
+
+void init_VIC(void)
+{
+  memset(hostIrqHandlers, 0, sizeof(hostIrqHandlers));
+  VICIntEnClr = 0xFFFFFFFF;
+}
+
+unsigned long install_irq(unsigned long IntNumber, void *HandlerAddr)
+{
+  if(IntNumber >= 32)
+    return 0;
+
+  hostIrqHandlers[IntNumber] = (void(*)(void))HandlerAddr;
+  VICIntEnable |= 1UL << IntNumber;
+  return 1;
+}
+
+unsigned long uninstall_irq(unsigned long IntNumber)
+{
+  if(IntNumber >= 32)
+    return 0;
+
+  hostIrqHandlers[IntNumber] = 0;
+  VICIntEnable &= ~(1UL << IntNumber);
+  return 1;
+}
+
+uint8_t HostRaiseIrq(uint8_t intNumber)
+{
+  if(intNumber >= 32 || !hostIrqHandlers[intNumber] || !(VICIntEnable & (1UL << intNumber)))
+    return 0;
+
+  hostIrqHandlers[intNumber]();
+  return 1;
+}
+
+void HostSetCycles(uint64_t cycles)
+{
+  uint64_t period = T1MR0 ? T1MR0 + 1 : CPU_CLOCK_HZ;
+
+  // timer 1 resets on MR0 match, one interrupt per wrap
+  while(cycles/period > hostCycles/period)
+  {
+    hostCycles = (hostCycles/period + 1)*period;
+    T1TC = 0;
+    T1IR = 0x01;
+
+    // the handler's write clears the flag on the target
+    if(HostRaiseIrq(TIMER1_INT))
+      T1IR = 0;
+  }
+
+  hostCycles = cycles;
+  T1TC = cycles % period;
+  T0TC = cycles - hostTimer0Start;
+}
+
+uint64_t HostGetCycles(void)
+{
+  return hostCycles;
+}
+
+uint64_t HostTimer0NextMatch(void)
+{
+  return hostTimer0Start + T0MR0 + 1;
+}
+
+void HostTimer0Match(void)
+{
+  hostTimer0Start = hostCycles;
+  T0TC = 0;
+}
+
+void HostHalInit(void)
+{
+  memset((void*)hostRegisters, 0, sizeof(hostRegisters));
+  memset(hostIrqHandlers, 0, sizeof(hostIrqHandlers));
+  hostCycles = 0;
+  hostTimer0Start = 0;
+
+  // UART transmitters are always empty, so busy waits on them return
+  U0LSR = 0x60;
+  U1LSR = 0x60;
+
+  HostSSPReset();
+}
@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) 2017 Intel Deutschland GmbH, Germany
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+// Reset emulated registers, interrupt table and time.
+void HostHalInit(void);
+
+// Stand-ins for main.c/uart0.c/ublox.c globals, only when those are not linked.
+void HostCoreInit(void);
+
+// Run the handler installed for a VIC channel, if it is enabled. Returns 1 if it ran.
+uint8_t HostRaiseIrq(uint8_t intNumber);
+
+// Advance emulated time to an absolute CPU cycle count. Updates T1TC and runs
+// the timer 1 interrupt on every wrap so SysTimeLongUSec() follows. With the
+// interrupt disabled in the VIC, T1IR stays set like a pending interrupt.
+void HostSetCycles(uint64_t cycles);
+uint64_t HostGetCycles(void);
+
+// Timer 0 counts from its last MR0 match, T0TC follows HostSetCycles().
+// HostTimer0NextMatch() is the absolute cycle of the next match with the
+// current T0MR0, HostTimer0Match() restarts the counter at the current time.
+uint64_t HostTimer0NextMatch(void);
+void HostTimer0Match(void);
@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2017 Intel Deutschland GmbH, Germany
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "LPC214x.h"
+#include "irq.h"
+#include "host_hal.h"
+#include "host_ssp.h"
+#include <string.h>
+
+#define SSP_DR_LOADED 0x80000000UL
+
+#define SSPSR_TFE 0x01
+#define SSPSR_TNF 0x02
+#define SSPSR_RNE 0x04
+#define SSPSR_RFF 0x08
+
+#define SSP_INT_ROR 0x01
+#define SSP_INT_RX  0x04
+#define SSP_INT_TX  0x08
+
+typedef struct _HostSSPFifo
+{
+  uint16_t data[HOST_SSP_FIFO_SIZE];
+  uint32_t tag[HOST_SSP_FIFO_SIZE];
+  uint8_t head;
+  uint8_t count;
+} HostSSPFifo;
+
+typedef struct _HostSSP
+{
+  HostSSPFifo rx;
+  HostSSPFifo tx;
+  volatile uint32_t status;
+  volatile uint32_t dr;
+  uint8_t drPending;
+  uint8_t overrun;
+  uint8_t rxDiscard;
+  HostSSPTagFunc pTagFunc;
+  HostSSPStat stat;
+} HostSSP;
+
+static CONTEXT_LOCAL HostSSP hostSSP;
+
+static void fifoPush(HostSSPFifo* pFifo, uint16_t data, uint32_t tag)
+{
+  uint8_t pos = (pFifo->head + pFifo->count) % HOST_SSP_FIFO_SIZE;
+  pFifo->data[pos] = data;
+  pFifo->tag[pos] = tag;
+  pFifo->count++;
+}
+
+static uint16_t fifoPop(HostSSPFifo* pFifo, uint32_t* pTag)
+{
+  uint16_t data = pFifo->data[pFifo->head];
+  *pTag = pFifo->tag[pFifo->head];
+  pFifo->head = (pFifo->head + 1) % HOST_SSP_FIFO_SIZE;
+  pFifo->count--;
+  return data;
+}
+
+// Resolve the last SSPDR access. The cell is preloaded with the marked Rx word,
+// so an untouched marker means the firmware read it and anything else is a write.
+static void commitDataRegister(void)
+{
+  if(!hostSSP.drPending)
+    return;
+
+  hostSSP.drPending = 0;
+
+  if(hostSSP.dr & SSP_DR_LOADED)
+  {
+    if(hostSSP.rx.count)
+    {
+      uint32_t tag;
+      fifoPop(&hostSSP.rx, &tag);
+
+      if(tag && hostSSP.pTagFunc)
+        hostSSP.pTagFunc(tag);
+    }
+  }
+  else if(hostSSP.tx.count < HOST_SSP_FIFO_SIZE)
+  {
+    fifoPush(&hostSSP.tx, hostSSP.dr & 0xFFFF, 0);
+  }
+}
+
+void HostSSPReset(void)
+{
+  HostSSPTagFunc pTagFunc = hostSSP.pTagFunc;
+  uint8_t rxDiscard = hostSSP.rxDiscard;
+
+  memset(&hostSSP, 0, sizeof(hostSSP));
+  hostSSP.pTagFunc = pTagFunc;
+  hostSSP.rxDiscard = rxDiscard;
+}
+
+volatile uint32_t* HostSSPData(void)
+{
+  commitDataRegister();
+
+  hostSSP.dr = SSP_DR_LOADED;
+  if(hostSSP.rx.count)
+    hostSSP.dr |= hostSSP.rx.data[hostSSP.rx.head];
+
+  hostSSP.drPending = 1;
+  return &hostSSP.dr;
+}
+
+volatile uint32_t* HostSSPStatus(void)
+{
+  uint32_t status = 0;
+
+  commitDataRegister();
+
+  if(hostSSP.tx.count == 0)
+    status |= SSPSR_TFE;
+  if(hostSSP.tx.count < HOST_SSP_FIFO_SIZE)
+    status |= SSPSR_TNF;
+  if(hostSSP.rx.count)
+    status |= SSPSR_RNE;
+  if(hostSSP.rx.count == HOST_SSP_FIFO_SIZE)
+    status |= SSPSR_RFF;
+
+  hostSSP.status = status;
+  return &hostSSP.status;
+}
+
+uint8_t HostSSPTransfer(uint16_t slaveWord, uint32_t tag, uint16_t* pMasterWord)
+{
+  uint32_t masterTag;
+
+  commitDataRegister();
+
+  if(!(SSPCR1 & 0x02) || hostSSP.tx.count == 0)
+    return 0;
+
+  *pMasterWord = fifoPop(&hostSSP.tx, &masterTag);
+  hostSSP.stat.words++;
+
+  if(hostSSP.rxDiscard)
+    return 1;
+
+  if(hostSSP.rx.count == HOST_SSP_FIFO_SIZE)
+  {
+    hostSSP.overrun = 1;
+    hostSSP.stat.rxOverruns++;
+  }
+  else
+  {
+    fifoPush(&hostSSP.rx, slaveWord, tag);
+  }
+
+  return 1;
+}
+
+void HostSSPService(void)
+{
+  uint32_t raw = 0;
+
+  commitDataRegister();
+
+  if(hostSSP.overrun)
+    raw |= SSP_INT_ROR;
+  if(hostSSP.rx.count >= HOST_SSP_FIFO_SIZE/2)
+    raw |= SSP_INT_RX;
+  if(hostSSP.tx.count <= HOST_SSP_FIFO_SIZE/2)
+    raw |= SSP_INT_TX;
+
+  SSPRIS = raw;
+  SSPMIS = raw & SSPIMSC;
+
+  if(SSPMIS)
+  {
+    hostSSP.overrun = 0;
+    hostSSP.stat.irqs++;
+    HostRaiseIrq(SPI1_INT);
+  }
+}
+
+uint32_t HostSSPCyclesPerWord(void)
+{
+  uint32_t bits = (SSPCR0 & 0x0F) + 1;
+  uint32_t scr = (SSPCR0 >> 8) & 0xFF;
+  uint32_t prescale = SSPCPSR ? SSPCPSR : 2;
+
+  return bits*prescale*(scr + 1);
+}
+
+void HostSSPSetTagFunc(HostSSPTagFunc func)
+{
+  hostSSP.pTagFunc = func;
+}
+
+void HostSSPSetRxDiscard(uint8_t discard)
+{
+  hostSSP.rxDiscard = discard;
+}
+
+const HostSSPStat* HostSSPGetStat(void)
+{
+  return &hostSSP.stat;
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2017 Intel Deutschland GmbH, Germany
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+// Host model of the LPC214x SSP in master mode with 8 word Rx/Tx FIFOs.
+// SSPSR and SSPDR accesses are routed here by the shim LPC214x.h. Every SSPDR
+// access hands out a cell preloaded with the next Rx word plus a marker bit;
+// the access is resolved on the next call into the model: marker untouched
+// means the firmware read (and popped) the word, otherwise it wrote a Tx word.
+
+#define HOST_SSP_FIFO_SIZE 8
+
+typedef void(*HostSSPTagFunc)(uint32_t tag);
+
+typedef struct _HostSSPStat
+{
+  uint32_t words;       // words clocked over the link
+  uint32_t rxOverruns;  // words lost because the Rx FIFO was full
+  uint32_t irqs;        // SSP interrupts raised
+} HostSSPStat;
+
+void HostSSPReset(void);
+
+// Clock one word if the master (HL) has data in its Tx FIFO.
+// slaveWord goes to the HL Rx FIFO, the word sent by the HL is returned in pMasterWord.
+// tag is handed to the tag function when the HL reads this word from SSPDR, 0 = no tag.
+// Returns 0 if the link is idle (SSP disabled or Tx FIFO empty).
+uint8_t HostSSPTransfer(uint16_t slaveWord, uint32_t tag, uint16_t* pMasterWord);
+
+// Update SSPRIS/SSPMIS and run the SSP interrupt if any enabled source is pending.
+void HostSSPService(void);
+
+// Number of SSPCR0/SSPCPSR clock cycles per word.
+uint32_t HostSSPCyclesPerWord(void);
+
+void HostSSPSetTagFunc(HostSSPTagFunc func);
+
+// Drop slave words instead of queuing them in the Rx FIFO. Used by drivers
+// that feed SSP_rx_handler_HL() themselves and only need the HL Tx side.
+void HostSSPSetRxDiscard(uint8_t discard);
+const HostSSPStat* HostSSPGetStat(void);
+
+volatile uint32_t* HostSSPStatus(void);
+volatile uint32_t* HostSSPData(void);
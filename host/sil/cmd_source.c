@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) 2017 Intel Deutschland GmbH, Germany
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cmd_source.h"
+#include "ll_emulator.h"
+#include "host_hal.h"
+#include "LPC214x.h"
+#include "irq.h"
+#include "config.h"
+#include "ext_com.h"
+#include "util/cobs.h"
+#include "util/crc16.h"
+#include "hal/sys_time.h"
+#include "asctec_uav_msgs/message_definitions.h"
+#include <math.h>
+#include <string.h>
+
+// 8N1
+#define BYTE_CYCLES (10*CPU_CLOCK_HZ/UART0_BAUDRATE)
+
+// thrust values sent, as they arrive in LL_CONTROL_INPUT.thrust
+#define THRUST_FIRST 1000
+#define THRUST_RANGE 2000
+
+typedef struct _CmdSource
+{
+  uint64_t period;            // [cycles], 0 = off
+  uint64_t tickCycles;
+
+  uint32_t count;             // commands started
+  uint64_t nextByte;
+  uint8_t frame[EXT_COM_MAX_ENCODED_MSG_SIZE];
+  uint32_t frameSize;
+  uint32_t framePos;
+  short frameThrust;
+
+  uint8_t pending;            // sent, not yet seen by the LL
+  short pendingThrust;
+  uint64_t pendingSince;
+
+  uint16_t seq;
+
+  CmdSourceStat stat;
+} CmdSource;
+
+static CONTEXT_LOCAL CmdSource cmd;
+
+static void buildFrame(uint32_t k)
+{
+  uint8_t msg[sizeof(TransportHeader) + sizeof(CommandRollPitchYawrateThrust)];
+  TransportHeader header;
+  CommandRollPitchYawrateThrust rpyt;
+
+  short thrust = THRUST_FIRST + k % THRUST_RANGE;
+
+  header.id = MESSAGE_ID_COMMAND_ROLL_PITCH_YAWRATE_THRUST;
+  header.flags = 0;
+  header.ackId = 0;
+
+  rpyt.roll = 0.0f;
+  rpyt.pitch = 0.0f;
+  rpyt.yawRate = 0.0f;
+  rpyt.thrust = (thrust + 0.5f)*MAX_THRUST/4095.0f;
+
+  memcpy(msg, &header, sizeof(header));
+  memcpy(msg + sizeof(header), &rpyt, sizeof(rpyt));
+
+  // same framing as ExtComSend()
+  uint16_t seq = cmd.seq++;
+  uint16_t crc = CRC16Checksum(msg, sizeof(msg));
+  crc = CRC16ChecksumFeed(crc, &seq, EXT_COM_HEADER_SIZE);
+
+  COBSState cState;
+  uint32_t bytesWritten;
+  COBSStartEncode(&cState, sizeof(msg) + EXT_COM_CHECKSUM_SIZE + EXT_COM_HEADER_SIZE, cmd.frame, sizeof(cmd.frame));
+  COBSFeedEncodeBlock(&cState, msg, sizeof(msg));
+  COBSFeedEncodeBlock(&cState, &seq, EXT_COM_HEADER_SIZE);
+  COBSFeedEncodeBlock(&cState, &crc, EXT_COM_CHECKSUM_SIZE);
+  COBSFinalizeEncode(&cState, &bytesWritten);
+
+  cmd.frame[bytesWritten++] = 0;
+  cmd.frameSize = bytesWritten;
+  cmd.framePos = 0;
+  cmd.frameThrust = thrust;
+}
+
+// start of command k, the fractional part of k*golden ratio spreads the
+// start phases evenly over the timer 0 period
+static uint64_t startCycles(uint32_t k)
+{
+  double frac = k*0.6180339887 - floor(k*0.6180339887);
+
+  return (k + 1)*cmd.period + (uint64_t)(frac*cmd.tickCycles);
+}
+
+void CmdSourceInit(double rateHz, uint64_t tickCycles)
+{
+  memset(&cmd, 0, sizeof(cmd));
+  cmd.stat.latencyMin = UINT32_MAX;
+  cmd.tickCycles = tickCycles;
+
+  if(rateHz <= 0)
+    return;
+
+  cmd.period = (uint64_t)(CPU_CLOCK_HZ/rateHz);
+  buildFrame(0);
+  cmd.nextByte = startCycles(0);
+}
+
+uint64_t CmdSourceNextByte(void)
+{
+  return cmd.period ? cmd.nextByte : UINT64_MAX;
+}
+
+void CmdSourceByte(uint64_t cycles)
+{
+  uint8_t c = cmd.frame[cmd.framePos++];
+
+  // RDA interrupt
+  U0RBR = c;
+  U0IIR = 0x04;
+  HostRaiseIrq(UART0_INT);
+  U0IIR = 0x01;
+
+  if(cmd.framePos < cmd.frameSize)
+  {
+    cmd.nextByte += BYTE_CYCLES;
+    return;
+  }
+
+  if(cmd.pending)
+    ++cmd.stat.lost;
+
+  cmd.pending = 1;
+  cmd.pendingThrust = cmd.frameThrust;
+  cmd.pendingSince = cycles;
+  ++cmd.stat.sent;
+
+  ++cmd.count;
+  buildFrame(cmd.count);
+  cmd.nextByte = startCycles(cmd.count);
+}
+
+void CmdSourceCheck(uint64_t cycles)
+{
+  if(!cmd.pending || LLEmuGetControlInput()->thrust != cmd.pendingThrust)
+    return;
+
+  cmd.pending = 0;
+  ++cmd.stat.received;
+
+  uint64_t latency = cycles - cmd.pendingSince;
+  uint32_t bin = (uint32_t)(latency*1000000/CPU_CLOCK_HZ/CMD_SOURCE_LATENCY_BIN_US);
+
+  if(bin >= CMD_SOURCE_LATENCY_BINS)
+    bin = CMD_SOURCE_LATENCY_BINS - 1;
+
+  ++cmd.stat.latencyHist[bin];
+  cmd.stat.latencySum += latency;
+  if(latency < cmd.stat.latencyMin)
+    cmd.stat.latencyMin = latency;
+  if(latency > cmd.stat.latencyMax)
+    cmd.stat.latencyMax = latency;
+}
+
+const CmdSourceStat* CmdSourceGetStat(void)
+{
+  return &cmd.stat;
+}
+
+uint32_t CmdSourceLatencyPercentile(uint8_t percent)
+{
+  uint64_t target = ((uint64_t)cmd.stat.received*percent + 99)/100;
+  uint64_t sum = 0;
+
+  for(uint32_t i = 0; i < CMD_SOURCE_LATENCY_BINS; i++)
+  {
+    sum += cmd.stat.latencyHist[i];
+    if(sum >= target && sum)
+    {
+      uint32_t maxUs = (uint32_t)((uint64_t)cmd.stat.latencyMax*1000000/CPU_CLOCK_HZ);
+      uint32_t us = (i + 1)*CMD_SOURCE_LATENCY_BIN_US;
+      return us < maxUs ? us : maxUs;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2017 Intel Deutschland GmbH, Germany
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+// Offboard controller on UART0 for the SIL. Sends COMMAND_ROLL_PITCH_YAWRATE_THRUST
+// messages byte by byte at the UART0 baud rate through uart0IRQ() and measures
+// the time from the last byte until the LL emulator received the command.
+// Every command carries its own thrust value, so it is recognized in the LL
+// control input. Start times walk over the timer 0 period.
+
+#define CMD_SOURCE_LATENCY_BIN_US 10
+#define CMD_SOURCE_LATENCY_BINS   1000
+
+typedef struct _CmdSourceStat
+{
+  uint32_t sent;              // commands completely sent to UART0
+  uint32_t received;          // commands seen by the LL
+  uint32_t lost;              // superseded before the LL saw them
+
+  // command-to-SPI latency: delimiter received by UART0 -> control frame received by the LL
+  uint64_t latencySum;        // [cycles]
+  uint32_t latencyMin;        // [cycles]
+  uint32_t latencyMax;        // [cycles]
+  uint32_t latencyHist[CMD_SOURCE_LATENCY_BINS];
+} CmdSourceStat;
+
+// rateHz = 0 disables the source
+void CmdSourceInit(double rateHz, uint64_t tickCycles);
+
+// Absolute cycle of the next UART0 byte, UINT64_MAX if none.
+uint64_t CmdSourceNextByte(void);
+
+// Deliver the next byte, due at cycles.
+void CmdSourceByte(uint64_t cycles);
+
+// Look for the pending command in the LL control input, after each LL word.
+void CmdSourceCheck(uint64_t cycles);
+
+const CmdSourceStat* CmdSourceGetStat(void);
+
+// Latency percentile in us from the histogram.
+uint32_t CmdSourceLatencyPercentile(uint8_t percent);
@@ -0,0 +1,457 @@
+/*
+ * Copyright (C) 2017 Intel Deutschland GmbH, Germany
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ll_emulator.h"
+#include "host_hal.h"
+#include "hal/sys_time.h"
+#include "hal/jeti_telemetry.h"
+#include "main.h"
+#include <math.h>
+#include <string.h>
+
+#define LL_FRAME_SIZE     44  // '>' '*' 40 data '<' + pad byte to a full word
+#define LL_OUT_BUF_SIZE   256
+#define LL_HISTORY        64
+#define LL_CMD_QUEUE      8
+#define HL_FRAME_DATA     38
+
+#define LL_FM_ATTITUDE    0x01
+#define LL_FM_HEIGHT      0x02
+#define LL_FM_POSITION    0x04
+#define LL_FM_SERIAL_EN   0x20
+
+typedef struct _LLCmdPending
+{
+  uint32_t sensorFrame;   // freshest attitude frame the HL had read, 0 = none
+} LLCmdPending;
+
+typedef struct _LLEmu
+{
+  struct LL_ATTITUDE_DATA att;
+  struct LL_CONTROL_INPUT ctrl;
+
+  // LL -> HL byte stream
+  uint8_t out[LL_OUT_BUF_SIZE];
+  uint32_t outTag[LL_OUT_BUF_SIZE/2];
+  uint16_t outRead;       // in words
+  uint16_t outCount;      // in words
+
+  uint32_t frameCnt;
+  uint64_t sampleCycles[LL_HISTORY];
+  uint32_t freshestConsumed;
+  uint32_t lastCmdSensorFrame;
+  uint8_t gpsAckPending;
+  uint8_t slowSelect;
+  short emergencyMode;    // last SDC_EM_MODE, reported on SUDC_EM_MODE
+  uint32_t jetiKeyPeriod; // [frames]
+  short jetiKey;          // reported on SUDC_JETIKEYVAL
+  uint8_t jetiText[32];   // display text received from the HL
+  uint8_t jetiPressText[32];
+  uint8_t jetiKeyNew;     // not reported yet
+  uint8_t jetiWaiting;    // for a new text after a key press
+  uint64_t jetiPressCycles; // key first reported to the HL
+
+  LLCmdPending cmdQueue[LL_CMD_QUEUE];
+  uint8_t cmdHead;
+  uint8_t cmdCount;
+
+  // HL -> LL frame parser
+  uint8_t rxState;
+  uint8_t rxCnt;
+  uint8_t rxData[HL_FRAME_DATA+2];
+
+  LLEmuStat stat;
+} LLEmu;
+
+static CONTEXT_LOCAL LLEmu ll;
+
+static const uint8_t slowUpChannels[] = {
+  SUDC_FLIGHTTIME, SUDC_NAVSTATUS, SUDC_DISTTOWP, SUDC_WPACKTRIGGER,
+  SUDC_SENDOMTYPE, SUDC_JETIKEYVAL, SUDC_EM_MODE,
+};
+
+void LLEmuInit(void)
+{
+  memset(&ll, 0, sizeof(ll));
+  ll.stat.latencyMin = UINT32_MAX;
+}
+
+// deterministic flight: slow attitude oscillation, hovering at 10m
+static void sampleVehicle(uint32_t k)
+{
+  float s = k*0.001f;
+  struct LL_ATTITUDE_DATA* pAtt = &ll.att;
+
+  pAtt->angle_roll = (short)(500.0f*sinf(2.0f*(float)M_PI*0.5f*s));
+  pAtt->angle_pitch = (short)(300.0f*cosf(2.0f*(float)M_PI*0.3f*s));
+  pAtt->angle_yaw = (unsigned short)((k/10) % 36000);
+  pAtt->angvel_roll = (short)(500.0f*(float)M_PI*cosf(2.0f*(float)M_PI*0.5f*s)/100.0f/0.015f);
+  pAtt->angvel_pitch = (short)(-300.0f*0.6f*(float)M_PI*sinf(2.0f*(float)M_PI*0.3f*s)/100.0f/0.015f);
+  pAtt->angvel_yaw = (short)(1.0f/0.015f);
+
+  memset(pAtt->RC_data, 128, sizeof(pAtt->RC_data));
+  pAtt->RC_data[4] = 255; // serial interface switch on
+  pAtt->RC_data[5] = 255; // GPS mode
+  pAtt->RC_data[6] = 0;
+
+  pAtt->latitude_best_estimate = 481234567;
+  pAtt->longitude_best_estimate = 115678901;
+  pAtt->acc_x = (short)(pAtt->angle_pitch/6);
+  pAtt->acc_y = (short)(-pAtt->angle_roll/6);
+  pAtt->acc_z = 1000;
+  pAtt->temp_gyro = 2500;
+
+  for(uint8_t i = 0; i < 8; i++)
+  {
+    pAtt->motor_data[i] = 100;
+    pAtt->motor_data[i + 8] = 80;
+  }
+
+  pAtt->speed_x_best_estimate = 0;
+  pAtt->speed_y_best_estimate = 0;
+  pAtt->height = 10000 + (int)(1000.0f*sinf(2.0f*(float)M_PI*0.05f*s));
+  pAtt->dheight = (short)(1000.0f*2.0f*(float)M_PI*0.05f*cosf(2.0f*(float)M_PI*0.05f*s));
+
+  pAtt->mag_x = 1500;
+  pAtt->mag_y = 0;
+  pAtt->mag_z = -2500;
+  pAtt->battery_voltage1 = 12600 - (short)(k/1000);
+  pAtt->battery_voltage2 = 0;
+  pAtt->flightMode = LL_FM_ATTITUDE | LL_FM_HEIGHT | LL_FM_POSITION | LL_FM_SERIAL_EN;
+  pAtt->cpu_load = 300;
+  pAtt->status = 0;
+}
+
+static uint8_t fillSlowUpChannel(uint32_t k)
+{
+  uint8_t select = slowUpChannels[ll.slowSelect];
+  short value = 0;
+
+  if(++ll.slowSelect == sizeof(slowUpChannels))
+    ll.slowSelect = 0;
+
+  switch(select)
+  {
+    case SUDC_FLIGHTTIME:
+      value = (short)(k/1000);
+      break;
+    case SUDC_SENDOMTYPE:
+      value = OM_QUAD;
+      break;
+    case SUDC_EM_MODE:
+      value = ll.emergencyMode;
+      break;
+    case SUDC_JETIKEYVAL:
+      value = ll.jetiKey;
+      break;
+    default:
+      break;
+  }
+
+  ll.att.slowDataUpChannelDataShort = value;
+  ll.att.status2 = (select << 1) | 0x01; // flying
+
+  return select;
+}
+
+void LLEmuSetJetiKeyPeriod(uint32_t periodMs)
+{
+  ll.jetiKeyPeriod = periodMs;
+}
+
+static void pressJetiKey(uint32_t k)
+{
+  uint32_t phase = k % ll.jetiKeyPeriod;
+
+  if(k && !phase)
+  {
+    ll.jetiKey = JETI_KEY_RIGHT;
+    ll.jetiKeyNew = 1;
+    ++ll.stat.jetiKeyPresses;
+  }
+  else if(phase == 100)
+  {
+    ll.jetiKey = 0;
+  }
+}
+
+void LLEmuTick(uint64_t cycles)
+{
+  uint32_t k = ll.frameCnt;
+  uint8_t page = k % 3;
+
+  if(ll.jetiKeyPeriod)
+    pressJetiKey(k);
+
+  if(LL_OUT_BUF_SIZE/2 - ll.outCount < LL_FRAME_SIZE/2)
+  {
+    ++ll.stat.framesDropped;
+    return;
+  }
+
+  sampleVehicle(k);
+  // the display latency starts when the HL can see the key
+  if(page == 2 && fillSlowUpChannel(k) == SUDC_JETIKEYVAL && ll.jetiKeyNew)
+  {
+    ll.jetiKeyNew = 0;
+    ll.jetiPressCycles = cycles;
+    memcpy(ll.jetiPressText, ll.jetiText, sizeof(ll.jetiText));
+    ll.jetiWaiting = 1;
+  }
+
+  ll.att.system_flags = page;
+  if(ll.gpsAckPending)
+  {
+    ll.att.system_flags |= SF_GPS_NEW;
+    ll.gpsAckPending = 0;
+  }
+
+  uint8_t frame[LL_FRAME_SIZE];
+  const uint8_t* pAtt = (const uint8_t*)&ll.att;
+
+  frame[0] = '>';
+  frame[1] = '*';
+  memcpy(&frame[2], pAtt, 14);
+  memcpy(&frame[16], pAtt + 14 + 26*page, 26);
+  frame[42] = '<';
+  frame[43] = 0;
+
+  ll.sampleCycles[k % LL_HISTORY] = cycles;
+  ++ll.frameCnt;
+  ++ll.stat.framesSent;
+
+  for(uint8_t i = 0; i < LL_FRAME_SIZE/2; i++)
+  {
+    uint16_t pos = (ll.outRead + ll.outCount) % (LL_OUT_BUF_SIZE/2);
+    ll.out[pos*2] = frame[i*2];
+    ll.out[pos*2 + 1] = frame[i*2 + 1];
+    ll.outTag[pos] = (i == LL_FRAME_SIZE/2 - 1) ? k + 1 : 0;
+    ++ll.outCount;
+  }
+}
+
+uint16_t LLEmuPeekWord(uint32_t* pTag)
+{
+  if(!ll.outCount)
+  {
+    *pTag = 0;
+    return 0;
+  }
+
+  *pTag = ll.outTag[ll.outRead];
+  return ll.out[ll.outRead*2] | (ll.out[ll.outRead*2 + 1] << 8);
+}
+
+void LLEmuAdvanceWord(void)
+{
+  if(!ll.outCount)
+    return;
+
+  ll.outRead = (ll.outRead + 1) % (LL_OUT_BUF_SIZE/2);
+  --ll.outCount;
+}
+
+void LLEmuFrameConsumed(uint32_t tag)
+{
+  ll.freshestConsumed = tag;
+  ++ll.stat.framesConsumed;
+}
+
+void LLEmuCommandWritten(uint64_t cycles)
+{
+  (void)cycles;
+
+  ++ll.stat.cmdWritten;
+
+  if(ll.cmdCount == LL_CMD_QUEUE)
+    return;
+
+  ll.cmdQueue[(ll.cmdHead + ll.cmdCount) % LL_CMD_QUEUE].sensorFrame = ll.freshestConsumed;
+  ++ll.cmdCount;
+}
+
+static void commandReceived(uint64_t cycles)
+{
+  if(!ll.cmdCount)
+    return;
+
+  uint32_t sensorFrame = ll.cmdQueue[ll.cmdHead].sensorFrame;
+  ll.cmdHead = (ll.cmdHead + 1) % LL_CMD_QUEUE;
+  --ll.cmdCount;
+
+  if(!sensorFrame)
+    return;
+
+  if(sensorFrame == ll.lastCmdSensorFrame)
+    ++ll.stat.cmdStale;
+  ll.lastCmdSensorFrame = sensorFrame;
+
+  uint64_t latency = cycles - ll.sampleCycles[(sensorFrame - 1) % LL_HISTORY];
+  uint32_t bin = (uint32_t)(latency*1000000/CPU_CLOCK_HZ/LL_EMU_LATENCY_BIN_US);
+
+  if(bin >= LL_EMU_LATENCY_BINS)
+    bin = LL_EMU_LATENCY_BINS - 1;
+
+  ++ll.stat.latencyHist[bin];
+  ++ll.stat.latencyCount;
+  ll.stat.latencySum += latency;
+  if(latency < ll.stat.latencyMin)
+    ll.stat.latencyMin = latency;
+  if(latency > ll.stat.latencyMax)
+    ll.stat.latencyMax = latency;
+}
+
+static void decodeJetiCommand(uint64_t cycles)
+{
+  const struct LL_CONTROL_INPUT* pCtrl = &ll.ctrl;
+  uint8_t cmd = (uint8_t)pCtrl->status;
+
+  if(cmd < PD_JETI_SETNAME || cmd >= PD_JETI_SETNAME + LL_EMU_JETI_CMDS)
+    return;
+
+  ++ll.stat.jetiSlots;
+  ++ll.stat.jetiCmds[cmd - PD_JETI_SETNAME];
+
+  if(cmd != PD_JETI_SETTEXT && cmd != PD_JETI_SETTEXT2)
+    return;
+
+  uint8_t* pText = &ll.jetiText[cmd == PD_JETI_SETTEXT ? 0 : 16];
+
+  memcpy(pText, &pCtrl->latitude, 4);
+  memcpy(pText + 4, &pCtrl->longitude, 4);
+  memcpy(pText + 8, &pCtrl->height, 4);
+  memcpy(pText + 12, &pCtrl->speed_x, 2);
+  memcpy(pText + 14, &pCtrl->speed_y, 2);
+
+  // complete once the second half arrived
+  if(cmd == PD_JETI_SETTEXT2 && ll.jetiWaiting && memcmp(ll.jetiText, ll.jetiPressText, sizeof(ll.jetiText)))
+  {
+    uint64_t latency = cycles - ll.jetiPressCycles;
+
+    ll.jetiWaiting = 0;
+    ++ll.stat.displayUpdates;
+    ll.stat.displayLatencySum += latency;
+    if(latency > ll.stat.displayLatencyMax)
+      ll.stat.displayLatencyMax = latency;
+  }
+}
+
+static void decodeControlFrame(uint64_t cycles)
+{
+  uint16_t chksum = 0xAAAA;
+
+  for(uint8_t i = 0; i < HL_FRAME_DATA; i++)
+    chksum += ll.rxData[i];
+
+  if(chksum != (ll.rxData[HL_FRAME_DATA] | (ll.rxData[HL_FRAME_DATA + 1] << 8)))
+  {
+    ++ll.stat.cmdChecksumErrors;
+    commandReceived(cycles);
+    return;
+  }
+
+  uint8_t* pCtrl = (uint8_t*)&ll.ctrl;
+  uint8_t page = ll.rxData[0] & 0x01;
+
+  if(!page)
+  {
+    memcpy(pCtrl, ll.rxData, HL_FRAME_DATA);
+  }
+  else
+  {
+    memcpy(pCtrl, ll.rxData, 20);
+    memcpy(pCtrl + 38, ll.rxData + 20, 18);
+  }
+
+  if(ll.ctrl.system_flags & SF_GPS_NEW)
+    ll.gpsAckPending = 1;
+
+  if(!page)
+  {
+    if(ll.ctrl.system_flags & SF_GPS_NEW)
+      ++ll.stat.gpsSlots;
+    else
+      decodeJetiCommand(cycles);
+  }
+
+  if(page && ll.ctrl.slowDataChannelSelect)
+  {
+    ++ll.stat.slowSlots;
+    if(ll.ctrl.slowDataChannelSelect == SDC_EM_MODE)
+      ll.emergencyMode = ll.ctrl.slowDataChannelDataShort;
+  }
+
+  ++ll.stat.cmdFrames[page];
+  commandReceived(cycles);
+}
+
+static void receiveByte(uint8_t data, uint64_t cycles)
+{
+  switch(ll.rxState)
+  {
+    case 0:
+      if(data == '>')
+        ll.rxState = 1;
+      break;
+    case 1:
+      ll.rxState = (data == '*') ? 2 : 0;
+      ll.rxCnt = 0;
+      break;
+    case 2:
+      ll.rxData[ll.rxCnt++] = data;
+      if(ll.rxCnt == HL_FRAME_DATA + 2)
+      {
+        decodeControlFrame(cycles);
+        ll.rxState = 0;
+      }
+      break;
+  }
+}
+
+void LLEmuMasterWord(uint16_t word, uint64_t cycles)
+{
+  receiveByte(word & 0xFF, cycles);
+  receiveByte(word >> 8, cycles);
+}
+
+const struct LL_CONTROL_INPUT* LLEmuGetControlInput(void)
+{
+  return &ll.ctrl;
+}
+
+const LLEmuStat* LLEmuGetStat(void)
+{
+  return &ll.stat;
+}
+
+uint32_t LLEmuLatencyPercentile(uint8_t percent)
+{
+  uint64_t target = ((uint64_t)ll.stat.latencyCount*percent + 99)/100;
+  uint64_t sum = 0;
+
+  for(uint32_t i = 0; i < LL_EMU_LATENCY_BINS; i++)
+  {
+    sum += ll.stat.latencyHist[i];
+    if(sum >= target && sum)
+    {
+      uint32_t maxUs = (uint32_t)((uint64_t)ll.stat.latencyMax*1000000/CPU_CLOCK_HZ);
+      uint32_t us = (i + 1)*LL_EMU_LATENCY_BIN_US;
+      return us < maxUs ? us : maxUs;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2017 Intel Deutschland GmbH, Germany
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "ll_hl_comm.h"
+
+// Host emulation of the AscTec LL processor on the SPI link.
+// Produces the '>' '*' ... '<' LL_ATTITUDE_DATA stream (pages 0/1/2 at 1kHz)
+// and decodes the 42 byte frames written by SSPWriteToLL().
+
+#define LL_EMU_LATENCY_BIN_US 10
+#define LL_EMU_LATENCY_BINS   1000
+#define LL_EMU_JETI_CMDS      10 // PD_JETI_SETNAME ...
+
+typedef struct _LLEmuStat
+{
+  uint32_t framesSent;        // attitude frames queued for the HL
+  uint32_t framesDropped;     // attitude frames not queued, link still busy
+  uint32_t framesConsumed;    // attitude frames read completely by the HL
+  uint32_t cmdWritten;        // control frames written by HL2LL_write_cycle
+  uint32_t cmdFrames[2];      // valid control frames per page
+  uint32_t cmdChecksumErrors;
+  uint32_t cmdStale;          // control frames without new attitude data since the last one
+  uint32_t slowSlots;         // page 1 control frames with a slow data channel item
+  uint32_t gpsSlots;          // page 0 control frames with GPS data
+  uint32_t jetiSlots;         // page 0 control frames with a PD_JETI_* command
+  uint32_t jetiCmds[LL_EMU_JETI_CMDS];
+
+  // Jeti display: key reported to the HL -> display text changed on the LL
+  uint32_t jetiKeyPresses;
+  uint32_t displayUpdates;
+  uint64_t displayLatencySum; // [cycles]
+  uint32_t displayLatencyMax; // [cycles]
+
+  // sensor-to-command latency: attitude frame sampled -> control frame received
+  uint32_t latencyCount;
+  uint64_t latencySum;        // [cycles]
+  uint32_t latencyMin;        // [cycles]
+  uint32_t latencyMax;        // [cycles]
+  uint32_t latencyHist[LL_EMU_LATENCY_BINS];
+} LLEmuStat;
+
+void LLEmuInit(void);
+
+// Press JETI_KEY_RIGHT on the Jeti box every periodMs for 100ms, 0 = never.
+void LLEmuSetJetiKeyPeriod(uint32_t periodMs);
+
+// LL control loop tick, samples the vehicle and queues the next attitude frame.
+void LLEmuTick(uint64_t cycles);
+
+// Next word the LL shifts out and whether it ends an attitude frame (tag != 0).
+uint16_t LLEmuPeekWord(uint32_t* pTag);
+void LLEmuAdvanceWord(void);
+
+// Word received from the HL.
+void LLEmuMasterWord(uint16_t word, uint64_t cycles);
+
+// HL read the last word of an attitude frame (SSP tag callback).
+void LLEmuFrameConsumed(uint32_t tag);
+
+// HL2LL_write_cycle() handed a new control frame to the SSP driver.
+void LLEmuCommandWritten(uint64_t cycles);
+
+const struct LL_CONTROL_INPUT* LLEmuGetControlInput(void);
+const LLEmuStat* LLEmuGetStat(void);
+
+// Latency percentile in us from the histogram.
+uint32_t LLEmuLatencyPercentile(uint8_t percent);
@@ -0,0 +1,256 @@
+/*
+ * Copyright (C) 2017 Intel Deutschland GmbH, Germany
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Software-in-the-loop run of the HL firmware against the LL emulator.
+// The real init() and mainloop() run on the host register shim, the SPI link
+// is clocked word by word in emulated CPU cycles, so a 10 minute flight
+// finishes in seconds and produces the same results on every run.
+//
+// usage: host-sil [-t seconds] [-p ll phase us] [-d ll clock drift ppm] [-c capture file]
+//                 [-T trace file] [-L] [-C command rate hz] [-S]
+//
+// -c records all firmware inputs for host-replay, -T the event trace for host-trace.
+// -L phase locks timer 0 to the LL frames.
+// -C sends offboard commands on UART0 and reports the command-to-SPI latency,
+// -S turns the ExtCom fast path off for comparison.
+
+#include "host_ssp.h"
+#include "ll_emulator.h"
+#include "cmd_source.h"
+#include "sil_run.h"
+#include "capture.h"
+#include "trace.h"
+#include "phase_lock.h"
+#include "ll_hl_comm.h"
+#include "slow_channel.h"
+#include "ll_events.h"
+#include "jeti_sync.h"
+#include "sdkio.h"
+#include "hal/sys_time.h"
+#include "hal/ssp.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+static double wallSeconds(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+typedef uint32_t(*ImageReadFunc)(uint32_t offset, uint8_t* pDst, uint32_t size);
+
+static int writeImage(const char* pFile, ImageReadFunc readFunc)
+{
+  uint8_t chunk[256];
+  uint32_t offset = 0;
+  uint32_t size;
+
+  FILE* pOut = fopen(pFile, "wb");
+  if(!pOut)
+  {
+    perror(pFile);
+    return 0;
+  }
+
+  while((size = (*readFunc)(offset, chunk, sizeof(chunk))) > 0)
+  {
+    fwrite(chunk, 1, size, pOut);
+    offset += size;
+  }
+
+  fclose(pOut);
+
+  return 1;
+}
+
+static double cyclesToUs(uint64_t cycles)
+{
+  return cycles*1e6/CPU_CLOCK_HZ;
+}
+
+int main(int argc, char** argv)
+{
+  double seconds = 600.0;
+  double llPhaseUs = 500.0;
+  double llDriftPpm = 0.0;
+  const char* pCaptureFile = 0;
+  const char* pTraceFile = 0;
+  uint8_t phaseLockOn = 0;
+  double cmdRateHz = 0.0;
+  uint8_t cmdSlowPath = 0;
+  uint8_t emergencyMode = 0;
+  uint32_t jetiKeyMs = 0;
+  double loopDelayUs = 0.0;
+  int opt;
+
+  while((opt = getopt(argc, argv, "t:p:d:c:T:LC:SE:J:W:")) != -1)
+  {
+    switch(opt)
+    {
+      case 't':
+        seconds = atof(optarg);
+        break;
+      case 'p':
+        llPhaseUs = atof(optarg);
+        break;
+      case 'd':
+        llDriftPpm = atof(optarg);
+        break;
+      case 'c':
+        pCaptureFile = optarg;
+        break;
+      case 'T':
+        pTraceFile = optarg;
+        break;
+      case 'L':
+        phaseLockOn = 1;
+        break;
+      case 'C':
+        cmdRateHz = atof(optarg);
+        break;
+      case 'S':
+        cmdSlowPath = 1;
+        break;
+      case 'E':
+        emergencyMode = atoi(optarg);
+        break;
+      case 'J':
+        jetiKeyMs = atoi(optarg);
+        break;
+      case 'W':
+        loopDelayUs = atof(optarg);
+        break;
+      default:
+        fprintf(stderr, "usage: %s [-t seconds] [-p ll phase us] [-d ll clock drift ppm] [-c capture file] [-T trace file] [-L] [-C command rate hz] [-S] [-E emergency mode] [-J jeti key period ms] [-W max main loop delay us]\n", argv[0]);
+        return 1;
+    }
+  }
+
+  SILConfig config = {
+    .seconds = seconds,
+    .llPhaseUs = llPhaseUs,
+    .llDriftPpm = llDriftPpm,
+    .capture = pCaptureFile != 0,
+    .trace = pTraceFile != 0,
+    .phaseLock = phaseLockOn,
+    .cmdRateHz = cmdRateHz,
+    .emergencyMode = emergencyMode,
+    .jetiKeyMs = jetiKeyMs,
+    .loopDelayUs = loopDelayUs,
+    .cmdSlowPath = cmdSlowPath,
+  };
+
+  double wallStart = wallSeconds();
+
+  uint64_t ticks = SILRun(&config);
+
+  double wall = wallSeconds() - wallStart;
+
+  if(pCaptureFile && !writeImage(pCaptureFile, &CaptureRead))
+    return 1;
+
+  if(pTraceFile && !writeImage(pTraceFile, &TraceRead))
+    return 1;
+
+  const LLEmuStat* pStat = LLEmuGetStat();
+  const HostSSPStat* pSSP = HostSSPGetStat();
+  const struct LL_CONTROL_INPUT* pCtrl = LLEmuGetControlInput();
+  const CmdSourceStat* pCmd = CmdSourceGetStat();
+
+  printf("{\n");
+  printf("  \"suite\": \"host-sil\",\n");
+  printf("  \"version\": \"%d.%d\",\n", __VERSION_MAJOR, __VERSION_MINOR);
+  printf("  \"simulatedSeconds\": %.3f,\n", seconds);
+  printf("  \"wallSeconds\": %.3f,\n", wall);
+  printf("  \"speedup\": %.1f,\n", wall > 0 ? seconds/wall : 0.0);
+  printf("  \"ticks\": %llu,\n", (unsigned long long)ticks);
+  printf("  \"ssp\": { \"words\": %u, \"rxOverruns\": %u, \"irqs\": %u },\n",
+      pSSP->words, pSSP->rxOverruns, pSSP->irqs);
+  printf("  \"ll\": { \"framesSent\": %u, \"framesDropped\": %u, \"framesConsumed\": %u },\n",
+      pStat->framesSent, pStat->framesDropped, pStat->framesConsumed);
+  printf("  \"llRx\": { \"frames\": %u, \"parsed\": %u, \"dropped\": %u, \"syncLosses\": %u, \"badFrames\": %u, \"pageErrors\": %u,\n",
+      llRxStats.frames, llRxStats.parsed, llRxStats.dropped, llRxStats.syncLosses, llRxStats.badFrames,
+      llRxStats.pageErrors);
+  printf("    \"oddStarts\": %u, \"lateFrames\": %u, \"gapMinUs\": %.1f, \"gapMaxUs\": %.1f },\n",
+      llRxStats.oddStarts, llRxStats.lateFrames, cyclesToUs(llRxStats.gapMinCycles), cyclesToUs(llRxStats.gapMaxCycles));
+  printf("  \"slowChannel\": { \"slots\": %u, \"llSlots\": %u, \"emergencyMode\": %u, \"classes\": [\n",
+      slowChannel.slots, pStat->slowSlots, sdk.ro.emergencyMode);
+  for(uint8_t i = 0; i < SLOW_CHANNEL_NUM_CLASSES; i++)
+  {
+    const SlowChannelClassStat* pClass = &slowChannel.stat[i];
+
+    printf("    { \"name\": \"%s\", \"posted\": %u, \"done\": %u, \"failed\": %u, \"waitMaxUs\": %u, \"doneMaxUs\": %u }%s\n",
+        SlowChannelClassName(i), pClass->posted, pClass->done, pClass->failed, pClass->waitMaxUs, pClass->doneMaxUs,
+        i + 1 < SLOW_CHANNEL_NUM_CLASSES ? "," : "");
+  }
+  printf("  ] },\n");
+  printf("  \"jeti\": { \"page0Slots\": %u, \"gpsSlots\": %u, \"jetiSlots\": %u, \"freeSlots\": %u, \"cmds\": [",
+      pStat->cmdFrames[0], pStat->gpsSlots, pStat->jetiSlots, pStat->cmdFrames[0] - pStat->gpsSlots - pStat->jetiSlots);
+  for(uint8_t i = 0; i < LL_EMU_JETI_CMDS; i++)
+    printf("%s%u", i ? ", " : "", pStat->jetiCmds[i]);
+  printf("],\n    \"keyPresses\": %u, \"displayUpdates\": %u, \"displayLatencyMeanUs\": %.1f, \"displayLatencyMaxUs\": %.1f,\n",
+      pStat->jetiKeyPresses, pStat->displayUpdates,
+      pStat->displayUpdates ? cyclesToUs(pStat->displayLatencySum)/pStat->displayUpdates : 0.0,
+      cyclesToUs(pStat->displayLatencyMax));
+  printf("    \"hlRefreshes\": %u, \"hlTextUpdates\": %u, \"hlTextLatencyMeanUs\": %u, \"hlTextLatencyMaxUs\": %u },\n",
+      jetiSync.stat.refreshes, jetiSync.stat.textUpdates,
+      jetiSync.stat.textUpdates ? (uint32_t)(jetiSync.stat.textLatencySumUs/jetiSync.stat.textUpdates) : 0,
+      jetiSync.stat.textLatencyMaxUs);
+  printf("  \"llEvents\": { \"values\": %u, \"events\": %u, \"untracked\": %u, \"sdkLost\": %u, \"channels\": [",
+      llEvents.updates, llEvents.seq, llEvents.ignored, SDKEventsLost());
+  for(uint8_t i = 0, n = 0; i < LL_EVENTS_NUM_CHANNELS; i++)
+  {
+    if(llEvents.seen & (1 << i))
+      printf("%s\n    { \"select\": %u, \"last\": %d, \"events\": %u }", n++ ? "," : "", i, llEvents.last[i], llEvents.events[i]);
+  }
+  printf(" ] },\n");
+  printf("  \"hl\": { \"cmdWritten\": %u, \"cmdPage0\": %u, \"cmdPage1\": %u, \"checksumErrors\": %u, \"stale\": %u },\n",
+      pStat->cmdWritten, pStat->cmdFrames[0], pStat->cmdFrames[1], pStat->cmdChecksumErrors, pStat->cmdStale);
+  printf("  \"sdkUpdates\": { \"attitude\": %u, \"rcAcc\": %u, \"heightMotors\": %u, \"magStatus\": %u, \"gpsRaw\": %u, \"events\": %u },\n",
+      sdk.ro.updateSeq[SDK_GROUP_ATTITUDE], sdk.ro.updateSeq[SDK_GROUP_RC_ACC], sdk.ro.updateSeq[SDK_GROUP_HEIGHT_MOTORS],
+      sdk.ro.updateSeq[SDK_GROUP_MAG_STATUS], sdk.ro.updateSeq[SDK_GROUP_GPS_RAW], sdk.ro.updateSeq[SDK_GROUP_EVENTS]);
+  printf("  \"sspTx\": { \"frames\": %u, \"queued\": %u, \"skipped\": %u },\n",
+      sspTxStats.frames, sspTxStats.queued, sspTxStats.skipped);
+  printf("  \"latencyUs\": { \"count\": %u, \"min\": %.1f, \"mean\": %.1f, \"p50\": %u, \"p99\": %u, \"max\": %.1f },\n",
+      pStat->latencyCount,
+      pStat->latencyCount ? cyclesToUs(pStat->latencyMin) : 0.0,
+      pStat->latencyCount ? cyclesToUs(pStat->latencySum)/pStat->latencyCount : 0.0,
+      LLEmuLatencyPercentile(50), LLEmuLatencyPercentile(99),
+      cyclesToUs(pStat->latencyMax));
+  printf("  \"phaseLock\": { \"enabled\": %u, \"locked\": %u, \"trim\": %d, \"minErrorUs\": %.1f, \"maxErrorUs\": %.1f,\n",
+      phaseLock.enabled, phaseLock.locked, phaseLock.trim,
+      phaseLock.stat.minError*1e6/CPU_CLOCK_HZ, phaseLock.stat.maxError*1e6/CPU_CLOCK_HZ);
+  printf("    \"frameToWriteUs\": { \"count\": %u, \"min\": %.1f, \"mean\": %.1f, \"max\": %.1f } },\n",
+      phaseLock.stat.commands,
+      phaseLock.stat.commands ? cyclesToUs(phaseLock.stat.minLatency) : 0.0,
+      phaseLock.stat.commands ? cyclesToUs(phaseLock.stat.sumLatency)/phaseLock.stat.commands : 0.0,
+      cyclesToUs(phaseLock.stat.maxLatency));
+  printf("  \"commandToSpiUs\": { \"fastPath\": %u, \"sent\": %u, \"received\": %u, \"lost\": %u, \"min\": %.1f, \"mean\": %.1f, \"p50\": %u, \"p99\": %u, \"max\": %.1f },\n",
+      !cmdSlowPath, pCmd->sent, pCmd->received, pCmd->lost,
+      pCmd->received ? cyclesToUs(pCmd->latencyMin) : 0.0,
+      pCmd->received ? cyclesToUs(pCmd->latencySum)/pCmd->received : 0.0,
+      CmdSourceLatencyPercentile(50), CmdSourceLatencyPercentile(99),
+      cyclesToUs(pCmd->latencyMax));
+  printf("  \"lastCommand\": { \"systemFlags\": %u, \"ctrlFlags\": %u, \"pitch\": %d, \"roll\": %d, \"yaw\": %d, \"thrust\": %d, \"numSV\": %u, \"batteryVoltage\": %d }\n",
+      pCtrl->system_flags, pCtrl->ctrl_flags, pCtrl->pitch, pCtrl->roll, pCtrl->yaw, pCtrl->thrust,
+      pCtrl->numSV, pCtrl->battery_voltage_1);
+  printf("}\n");
+
+  return 0;
+}
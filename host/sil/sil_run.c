@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2017 Intel Deutschland GmbH, Germany
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Event loop of the software-in-the-loop run. Timer 0 ticks, LL loop ticks,
+// SSP word slots and UART0 command bytes are processed in emulated CPU cycle
+// order.
+
+#include "LPC214x.h"
+#include "irq.h"
+#include "host_hal.h"
+#include "host_ssp.h"
+#include "host_firmware.h"
+#include "ll_emulator.h"
+#include "cmd_source.h"
+#include "sil_run.h"
+#include "main.h"
+#include "capture.h"
+#include "trace.h"
+#include "phase_lock.h"
+#include "ext_com.h"
+#include "hal/ssp.h"
+#include "hal/sys_time.h"
+#include "sdkio.h"
+
+uint64_t SILRun(const SILConfig* pConfig)
+{
+  HostHalInit();
+  LLEmuInit();
+  LLEmuSetJetiKeyPeriod(pConfig->jetiKeyMs);
+  HostSSPSetTagFunc(&LLEmuFrameConsumed);
+
+  HostFirmwareInit();
+
+  if(pConfig->capture)
+    CaptureStart();
+
+  if(pConfig->trace)
+    TraceStart();
+
+  PhaseLockEnable(pConfig->phaseLock);
+  ExtComSetFastPath(!pConfig->cmdSlowPath);
+
+  if(pConfig->emergencyMode)
+    SDKSetEmergencyMode(pConfig->emergencyMode);
+
+  const uint64_t tickCycles = T0MR0 + 1;
+  const uint64_t wordCycles = HostSSPCyclesPerWord();
+  const double llPeriod = tickCycles*(1.0 + pConfig->llDriftPpm*1e-6);
+  const uint64_t endCycles = (uint64_t)(pConfig->seconds*CPU_CLOCK_HZ);
+
+  uint64_t nextTick;
+  uint64_t nextWord = 0;
+  double nextLL = pConfig->llPhaseUs*1e-6*CPU_CLOCK_HZ;
+  uint64_t ticks = 0;
+
+  // main loop start after the timer 0 match, pseudo random up to loopDelayUs
+  uint64_t maxDelay = (uint64_t)(pConfig->loopDelayUs*1e-6*CPU_CLOCK_HZ);
+  uint64_t nextRun = UINT64_MAX;
+  uint32_t delaySeed = 12345;
+
+  if(maxDelay >= tickCycles)
+    maxDelay = tickCycles - 1;
+
+  CmdSourceInit(pConfig->cmdRateHz, tickCycles);
+
+  while(1)
+  {
+    // the phase lock moves T0MR0 from the SSP interrupt
+    nextTick = HostTimer0NextMatch();
+
+    uint64_t now = nextTick;
+    if(nextWord < now)
+      now = nextWord;
+    if((uint64_t)nextLL < now)
+      now = (uint64_t)nextLL;
+    if(CmdSourceNextByte() < now)
+      now = CmdSourceNextByte();
+    if(nextRun < now)
+      now = nextRun;
+
+    if(now >= endCycles)
+      break;
+
+    HostSetCycles(now);
+
+    if((uint64_t)nextLL == now)
+    {
+      LLEmuTick(now);
+      nextLL += llPeriod;
+    }
+
+    if(nextTick == now)
+    {
+      HostTimer0Match();
+      T0IR = 0x01;
+      HostRaiseIrq(TIMER0_INT);
+
+      nextRun = now;
+      if(maxDelay)
+      {
+        delaySeed = delaySeed*1103515245 + 12345;
+        nextRun += (delaySeed >> 8) % (maxDelay + 1);
+      }
+    }
+
+    if(nextRun == now)
+    {
+      uint32_t framesBefore = sspTxStats.frames;
+
+      nextRun = UINT64_MAX;
+      mainloopHostCycle();
+
+      if(sspTxStats.frames != framesBefore)
+        LLEmuCommandWritten(now);
+
+      // one background job chunk per tick
+      mainloopHostIdle();
+
+      ++ticks;
+    }
+
+    if(nextWord == now)
+    {
+      uint32_t tag;
+      uint16_t masterWord;
+      uint16_t slaveWord = LLEmuPeekWord(&tag);
+
+      if(HostSSPTransfer(slaveWord, tag, &masterWord))
+      {
+        LLEmuAdvanceWord();
+        LLEmuMasterWord(masterWord, now);
+        CmdSourceCheck(now);
+      }
+
+      HostSSPService();
+      nextWord += wordCycles;
+    }
+
+    if(CmdSourceNextByte() == now)
+    {
+      CmdSourceByte(now);
+      mainloopHostIdle();
+    }
+  }
+
+  if(pConfig->capture)
+    CaptureStop();
+
+  if(pConfig->trace)
+    TraceStop();
+
+  return ticks;
+}
@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) 2017 Intel Deutschland GmbH, Germany
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+typedef struct _SILConfig
+{
+  double seconds;     // emulated flight time
+  double llPhaseUs;   // LL loop phase relative to the HL timer 0
+  double llDriftPpm;  // LL clock drift
+  uint8_t capture;    // record all firmware inputs (see capture.h)
+  uint8_t trace;      // record the event trace (see trace.h)
+  uint8_t phaseLock;  // phase lock timer 0 to the LL frames (see phase_lock.h)
+  double cmdRateHz;   // offboard commands on UART0 (see cmd_source.h), 0 = none
+  uint8_t cmdSlowPath;  // handle ExtCom messages only in the comm task
+  uint8_t emergencyMode;  // EM_* requested from the LL at startup, 0 = none
+  uint32_t jetiKeyMs;     // Jeti key presses on the LL (see ll_emulator.h), 0 = none
+  double loopDelayUs;     // main loop starts up to this late after the timer 0 match (random), 0 = at once
+} SILConfig;
+
+// Reset the shim, the LL emulator and the firmware of the calling thread and
+// run the firmware for pConfig->seconds. Returns the number of timer 0 ticks.
+// Results are available from LLEmuGetStat(), HostSSPGetStat() and
+// CmdSourceGetStat() afterwards.
+uint64_t SILRun(const SILConfig* pConfig);
@@ -0,0 +1,254 @@
+/*
+ * Copyright (C) 2017 Intel Deutschland GmbH, Germany
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Converts an event trace image (see src/trace.h) to Chrome trace event JSON,
+// which chrome://tracing and ui.perfetto.dev display as one timeline with a
+// track for the main loop tasks and one for the interrupt handlers.
+//
+// usage: host-trace [-o json file] trace file
+
+#include "trace.h"
+#include "irq_stats.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define TID_MAIN 1
+#define TID_ISR  2
+
+static const char* const irqNames[IRQ_STATS_NUM] = IRQ_STATS_NAMES;
+
+typedef struct _Track
+{
+  const TraceRecord* pRecords;
+  uint32_t numRecords;
+  int64_t* pCycles;       // unwrapped time of every record
+} Track;
+
+// Record time holds the seconds modulo 64, every track covers much less than
+// that between two records, so counting backward steps of the seconds field
+// restores the full time.
+static void unwrap(Track* pTrack, uint32_t cpuClockHz)
+{
+  const uint32_t cycleMask = (1UL << TRACE_TIME_CYCLE_BITS) - 1;
+  int64_t epoch = 0;
+  uint32_t prevSeconds = 0;
+
+  for(uint32_t i = 0; i < pTrack->numRecords; i++)
+  {
+    uint32_t time = pTrack->pRecords[i].time;
+    uint32_t seconds = time >> TRACE_TIME_CYCLE_BITS;
+
+    if(i > 0 && seconds < prevSeconds)
+      epoch += 1 << (32 - TRACE_TIME_CYCLE_BITS);
+
+    prevSeconds = seconds;
+    pTrack->pCycles[i] = (epoch + seconds)*cpuClockHz + (time & cycleMask);
+  }
+}
+
+static void writeName(FILE* pOut, const TraceHeader* pHeader, const TraceRecord* pRecord)
+{
+  switch(pRecord->event)
+  {
+    case TRACE_EV_IRQ_ENTER:
+    case TRACE_EV_IRQ_EXIT:
+      if(pRecord->arg < IRQ_STATS_NUM)
+        fprintf(pOut, "%s", irqNames[pRecord->arg]);
+      else
+        fprintf(pOut, "irq %u", pRecord->arg);
+      break;
+    case TRACE_EV_TASK_BEGIN:
+    case TRACE_EV_TASK_END:
+      if(pRecord->arg < SCHEDULER_MAX_TASKS && pHeader->taskNames[pRecord->arg][0])
+        fprintf(pOut, "%.*s", TRACE_NAME_SIZE, pHeader->taskNames[pRecord->arg]);
+      else
+        fprintf(pOut, "task %u", pRecord->arg);
+      break;
+    case TRACE_EV_SSP_FRAME:
+      fprintf(pOut, "ssp frame");
+      break;
+    case TRACE_EV_EXTCOM_MSG:
+      fprintf(pOut, "extcom msg");
+      break;
+    case TRACE_EV_LL_WRITE:
+      fprintf(pOut, "ll write");
+      break;
+    default:
+      fprintf(pOut, "event 0x%x", pRecord->event);
+      break;
+  }
+}
+
+static void writeTrack(FILE* pOut, const TraceHeader* pHeader, const Track* pTrack, uint32_t tid,
+    int64_t startCycles, uint8_t* pFirst)
+{
+  for(uint32_t i = 0; i < pTrack->numRecords; i++)
+  {
+    const TraceRecord* pRecord = &pTrack->pRecords[i];
+    const char* pPhase;
+
+    switch(pRecord->event)
+    {
+      case TRACE_EV_IRQ_ENTER:
+      case TRACE_EV_TASK_BEGIN:
+        pPhase = "B";
+        break;
+      case TRACE_EV_IRQ_EXIT:
+      case TRACE_EV_TASK_END:
+        pPhase = "E";
+        break;
+      default:
+        pPhase = "i";
+        break;
+    }
+
+    double us = (pTrack->pCycles[i] - startCycles)*1e6/pHeader->cpuClockHz;
+
+    fprintf(pOut, "%s\n    { \"name\": \"", *pFirst ? "" : ",");
+    writeName(pOut, pHeader, pRecord);
+    fprintf(pOut, "\", \"ph\": \"%s\", \"ts\": %.3f, \"pid\": 1, \"tid\": %u", pPhase, us, tid);
+
+    if(pPhase[0] == 'i')
+      fprintf(pOut, ", \"s\": \"t\", \"args\": { \"arg\": %u }", pRecord->arg);
+
+    fprintf(pOut, " }");
+    *pFirst = 0;
+  }
+}
+
+int main(int argc, char** argv)
+{
+  const char* pOutFile = 0;
+  int opt;
+
+  while((opt = getopt(argc, argv, "o:")) != -1)
+  {
+    switch(opt)
+    {
+      case 'o':
+        pOutFile = optarg;
+        break;
+      default:
+        fprintf(stderr, "usage: %s [-o json file] trace file\n", argv[0]);
+        return 1;
+    }
+  }
+
+  if(optind >= argc)
+  {
+    fprintf(stderr, "usage: %s [-o json file] trace file\n", argv[0]);
+    return 1;
+  }
+
+  FILE* pIn = fopen(argv[optind], "rb");
+  if(!pIn)
+  {
+    perror(argv[optind]);
+    return 1;
+  }
+
+  TraceHeader header;
+  if(fread(&header, sizeof(header), 1, pIn) != 1 || header.magic != TRACE_MAGIC || header.version != TRACE_VERSION)
+  {
+    fprintf(stderr, "%s: not a trace image\n", argv[optind]);
+    return 1;
+  }
+
+  Track tracks[TRACE_NUM_RINGS];
+
+  for(uint8_t r = 0; r < TRACE_NUM_RINGS; r++)
+  {
+    TraceRecord* pRecords = calloc(header.numRecords[r] + 1, sizeof(TraceRecord));
+    tracks[r].pCycles = calloc(header.numRecords[r] + 1, sizeof(int64_t));
+    tracks[r].numRecords = fread(pRecords, sizeof(TraceRecord), header.numRecords[r], pIn);
+    tracks[r].pRecords = pRecords;
+
+    if(tracks[r].numRecords != header.numRecords[r])
+      fprintf(stderr, "%s: truncated, %u of %u records\n", argv[optind], tracks[r].numRecords, header.numRecords[r]);
+
+    unwrap(&tracks[r], header.cpuClockHz);
+  }
+
+  fclose(pIn);
+
+  // Both tracks were unwrapped from their own first record, align their epochs.
+  const int64_t epochCycles = (int64_t)header.cpuClockHz << (32 - TRACE_TIME_CYCLE_BITS);
+  Track* pMain = &tracks[TRACE_RING_MAIN];
+  Track* pIsr = &tracks[TRACE_RING_ISR];
+
+  if(pMain->numRecords && pIsr->numRecords)
+  {
+    int64_t diff = pIsr->pCycles[0] - pMain->pCycles[0];
+    int64_t shift = 0;
+
+    while(diff + shift > epochCycles/2)
+      shift -= epochCycles;
+    while(diff + shift < -epochCycles/2)
+      shift += epochCycles;
+
+    for(uint32_t i = 0; i < pIsr->numRecords; i++)
+      pIsr->pCycles[i] += shift;
+  }
+
+  int64_t startCycles = INT64_MAX;
+  for(uint8_t r = 0; r < TRACE_NUM_RINGS; r++)
+  {
+    if(tracks[r].numRecords && tracks[r].pCycles[0] < startCycles)
+      startCycles = tracks[r].pCycles[0];
+  }
+
+  FILE* pOut = stdout;
+  if(pOutFile)
+  {
+    pOut = fopen(pOutFile, "w");
+    if(!pOut)
+    {
+      perror(pOutFile);
+      return 1;
+    }
+  }
+
+  uint8_t first = 1;
+
+  fprintf(pOut, "{\n  \"displayTimeUnit\": \"ns\",\n");
+  fprintf(pOut, "  \"otherData\": { \"firmware\": \"%u.%u\", \"overwrittenMain\": %u, \"overwrittenIsr\": %u },\n",
+      header.firmwareVersion >> 8, header.firmwareVersion & 0xFF,
+      header.overwritten[TRACE_RING_MAIN], header.overwritten[TRACE_RING_ISR]);
+  fprintf(pOut, "  \"traceEvents\": [\n");
+  fprintf(pOut, "    { \"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %u, \"args\": { \"name\": \"main loop\" } },\n", TID_MAIN);
+  fprintf(pOut, "    { \"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %u, \"args\": { \"name\": \"interrupts\" } }", TID_ISR);
+  first = 0;
+
+  writeTrack(pOut, &header, pMain, TID_MAIN, startCycles, &first);
+  writeTrack(pOut, &header, pIsr, TID_ISR, startCycles, &first);
+
+  fprintf(pOut, "\n  ]\n}\n");
+
+  if(pOut != stdout)
+    fclose(pOut);
+
+  fprintf(stderr, "%u main loop and %u interrupt records\n", pMain->numRecords, pIsr->numRecords);
+
+  for(uint8_t r = 0; r < TRACE_NUM_RINGS; r++)
+  {
+    free((void*)tracks[r].pRecords);
+    free(tracks[r].pCycles);
+  }
+
+  return 0;
+}
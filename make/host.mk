@@ -0,0 +1,102 @@
+# Host (x86-64 Linux) builds of the firmware.
+# LPC214x registers and the interrupt controller are replaced by the shim in
+# host/shim. ARM char is unsigned, so the host build uses the same.
+
+HOST_CC ?= gcc
+UAV_MSGS_INCLUDE ?= deps/asctec_uav_msgs/include
+
+host_build_dir := host-build
+
+host_shim_src := host/shim/host_hal.c host/shim/host_ssp.c
+
+# platform independent core only, for microbenchmarks
+host_core_src := src/util/cobs.c src/util/crc16.c src/util/fifo.c src/util/fastmath.c \
+ src/util/gpsmath.c src/util/declination.c src/util/build_info.c \
+ src/ext_com.c src/sdkio.c src/ll_hl_comm.c src/capture.c src/scheduler.c src/profiler.c \
+ src/irq_stats.c src/trace.c src/phase_lock.c src/jobs.c src/coroutine.c src/stack_monitor.c src/load_shed.c src/slow_channel.c src/ll_events.c src/jeti_sync.c \
+ src/hal/ssp.c src/hal/sys_time.c src/hal/jeti_telemetry.c \
+ host/shim/host_core.c $(host_shim_src)
+
+# complete firmware without startup code and VIC driver
+host_fw_src := $(filter-out src/hal/syscalls.c src/win_arm/irq.c, \
+ $(wildcard src/*.c $(addprefix src/,$(addsuffix /*.c,hal util examples win_arm)))) \
+ $(host_shim_src) host/shim/host_firmware.c
+
+host_bench_src := $(host_core_src) src/examples/gps_waypoints.c host/bench/waypoint_fsm.c host/bench/bench.c
+host_bench := $(host_build_dir)/host-bench
+
+host_sil_src := $(host_fw_src) host/sil/ll_emulator.c host/sil/cmd_source.c host/sil/sil_run.c host/sil/sil.c
+host_sil := $(host_build_dir)/host-sil
+
+host_replay_src := $(host_fw_src) host/replay/replay.c
+host_replay := $(host_build_dir)/host-replay
+
+# converts trace images (src/trace.h) to Chrome trace event JSON
+host_trace_src := host/trace/trace_export.c
+host_trace := $(host_build_dir)/host-trace
+
+# many vehicles in one process, firmware state is thread local (src/context.h)
+host_mt_build_dir := $(host_build_dir)/mt
+host_multi_src := $(host_fw_src) host/sil/ll_emulator.c host/sil/cmd_source.c host/sil/sil_run.c host/multi/multi.c
+host_multi := $(host_build_dir)/host-multi
+
+HOST_CFLAGS := -std=gnu11 -O2 -g $(WARNINGS) -Wno-int-to-pointer-cast -Wno-pointer-to-int-cast \
+ -fno-strict-aliasing -funsigned-char \
+ -include host/shim/LPC214x.h -I host/shim -I src -I src/win_arm -I $(UAV_MSGS_INCLUDE) \
+ -D__VERSION_MAJOR=4 -D__VERSION_MINOR=0 -D__BUILD_CONFIG=0x00 -DHOST_BUILD -DCAPTURE_ENABLE=1 -DTRACE_ENABLE=1
+HOST_LDFLAGS := -lm
+
+# single instance tools keep a capture of a complete SIL run and a long trace
+HOST_SINGLE_CFLAGS := -DCAPTURE_BUFFER_SIZE=0x4000000 -DTRACE_RING_SIZE=0x100000
+HOST_MT_CFLAGS := -DHOST_MULTI_INSTANCE -pthread
+
+host_bench_objs := $(addprefix $(host_build_dir)/,$(host_bench_src:.c=.o))
+host_sil_objs := $(addprefix $(host_build_dir)/,$(host_sil_src:.c=.o))
+host_replay_objs := $(addprefix $(host_build_dir)/,$(host_replay_src:.c=.o))
+host_trace_objs := $(addprefix $(host_build_dir)/,$(host_trace_src:.c=.o))
+host_multi_objs := $(addprefix $(host_mt_build_dir)/,$(host_multi_src:.c=.o))
+
+.PHONY: host-bench host-sil host-replay host-trace host-multi host-clean
+
+$(host_build_dir)/%.o: %.c
+	@$(MKDIR) -p $(dir $@)
+	$(HOST_CC) $(HOST_CFLAGS) $(HOST_SINGLE_CFLAGS) -MMD -MP -c $< -o $@
+
+$(host_mt_build_dir)/%.o: %.c
+	@$(MKDIR) -p $(dir $@)
+	$(HOST_CC) $(HOST_CFLAGS) $(HOST_MT_CFLAGS) -MMD -MP -c $< -o $@
+
+$(host_bench): $(host_bench_objs)
+	$(HOST_CC) $^ $(HOST_LDFLAGS) -o $@
+
+$(host_sil): $(host_sil_objs)
+	$(HOST_CC) $^ $(HOST_LDFLAGS) -o $@
+
+$(host_replay): $(host_replay_objs)
+	$(HOST_CC) $^ $(HOST_LDFLAGS) -o $@
+
+$(host_trace): $(host_trace_objs)
+	$(HOST_CC) $^ $(HOST_LDFLAGS) -o $@
+
+$(host_multi): $(host_multi_objs)
+	$(HOST_CC) $^ $(HOST_LDFLAGS) -pthread -o $@
+
+host-bench: $(host_bench)
+	./$(host_bench)
+
+host-sil: $(host_sil)
+	./$(host_sil) $(SIL_ARGS)
+
+host-replay: $(host_replay)
+	./$(host_replay) $(REPLAY_ARGS)
+
+host-trace: $(host_trace)
+	./$(host_trace) $(TRACE_ARGS)
+
+host-multi: $(host_multi)
+	./$(host_multi) $(MULTI_ARGS)
+
+host-clean:
+	-$(RM) -rf $(host_build_dir)
+
+-include $(sort $(host_bench_objs:.o=.d) $(host_sil_objs:.o=.d) $(host_replay_objs:.o=.d) $(host_trace_objs:.o=.d) $(host_multi_objs:.o=.d))
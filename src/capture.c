@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2017 Intel Deutschland GmbH, Germany
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "capture.h"
+#include "context.h"
+
+#if CAPTURE_ENABLE
+
+#include "LPC214x.h"
+#include "hal/sys_time.h"
+#include <string.h>
+
+#define RING_NEXT(pos, n) (((pos) + (n)) % CAPTURE_BUFFER_SIZE)
+
+// All writers run in interrupt context and IRQs do not nest, so records are
+// written without locking. Start/stop only flip the running flag last/first.
+typedef struct _Capture
+{
+  uint8_t buffer[CAPTURE_BUFFER_SIZE];
+  uint32_t head;        // next write position
+  uint32_t tail;        // oldest record
+  uint32_t used;
+  int32_t openRecord;   // header position of the record that can still be extended, -1 = none
+  uint8_t pendingTicks;
+  volatile uint8_t running;
+  CaptureHeader header;
+} Capture;
+
+static CONTEXT_LOCAL Capture capture = {
+  .openRecord = -1,
+};
+
+static uint32_t recordSize(uint32_t pos)
+{
+  uint8_t hdr = capture.buffer[pos];
+
+  if((hdr >> 6) == CAPTURE_SRC_TICK)
+    return 1;
+
+  return 1 + (hdr & CAPTURE_MAX_COUNT);
+}
+
+// drop the oldest records until size bytes are free
+static void makeRoom(uint32_t size)
+{
+  while(CAPTURE_BUFFER_SIZE - capture.used < size)
+  {
+    uint8_t hdr = capture.buffer[capture.tail];
+    uint32_t dropped = recordSize(capture.tail);
+
+    if((hdr >> 6) == CAPTURE_SRC_TICK)
+      capture.header.firstTick += hdr & CAPTURE_MAX_COUNT;
+
+    if(capture.openRecord == (int32_t)capture.tail)
+      capture.openRecord = -1;
+
+    capture.tail = RING_NEXT(capture.tail, dropped);
+    capture.used -= dropped;
+    capture.header.overwritten += dropped;
+  }
+}
+
+static void put(uint8_t data)
+{
+  capture.buffer[capture.head] = data;
+  capture.head = RING_NEXT(capture.head, 1);
+  ++capture.used;
+}
+
+void CaptureStart(void)
+{
+  capture.running = 0;
+
+  capture.head = 0;
+  capture.tail = 0;
+  capture.used = 0;
+  capture.openRecord = -1;
+  capture.pendingTicks = 0;
+
+  memset(&capture.header, 0, sizeof(CaptureHeader));
+  capture.header.magic = CAPTURE_MAGIC;
+  capture.header.version = CAPTURE_VERSION;
+  capture.header.firmwareVersion = (__VERSION_MAJOR << 8) | __VERSION_MINOR;
+  capture.header.tickCycles = T0MR0 + 1;
+  capture.header.startTimeUs = SysTimeLongUSec();
+
+  capture.running = 1;
+}
+
+void CaptureStop(void)
+{
+  capture.running = 0;
+}
+
+uint8_t CaptureIsRunning(void)
+{
+  return capture.running;
+}
+
+void CaptureTick(uint8_t newCycle)
+{
+  if(!capture.running)
+    return;
+
+  if(capture.pendingTicks < CAPTURE_MAX_COUNT)
+    ++capture.pendingTicks;
+
+  if(!newCycle)
+    return;
+
+  makeRoom(1);
+  put((CAPTURE_SRC_TICK << 6) | capture.pendingTicks);
+  capture.openRecord = -1;
+  capture.pendingTicks = 0;
+}
+
+void CaptureByte(uint8_t source, uint8_t data)
+{
+  if(!capture.running)
+    return;
+
+  if(capture.openRecord >= 0)
+  {
+    uint8_t hdr = capture.buffer[capture.openRecord];
+
+    if((hdr >> 6) == source && (hdr & CAPTURE_MAX_COUNT) < CAPTURE_MAX_COUNT)
+    {
+      makeRoom(1);
+
+      // makeRoom() may have dropped the open record itself
+      if(capture.openRecord >= 0)
+      {
+        capture.buffer[capture.openRecord] = hdr + 1;
+        put(data);
+        return;
+      }
+    }
+  }
+
+  makeRoom(2);
+  capture.openRecord = capture.head;
+  put((source << 6) | 1);
+  put(data);
+}
+
+uint32_t CaptureImageSize(void)
+{
+  return sizeof(CaptureHeader) + capture.used;
+}
+
+uint32_t CaptureRead(uint32_t offset, uint8_t* pDst, uint32_t size)
+{
+  if(capture.running)
+    return 0;
+
+  capture.header.recordSize = capture.used;
+
+  uint32_t total = CaptureImageSize();
+  if(offset >= total)
+    return 0;
+
+  if(size > total - offset)
+    size = total - offset;
+
+  for(uint32_t i = 0; i < size; i++, offset++)
+  {
+    if(offset < sizeof(CaptureHeader))
+      pDst[i] = ((const uint8_t*)&capture.header)[offset];
+    else
+      pDst[i] = capture.buffer[RING_NEXT(capture.tail, offset - sizeof(CaptureHeader))];
+  }
+
+  return size;
+}
+
+#endif
@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2017 Intel Deutschland GmbH, Germany
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "config.h"
+#include <stdint.h>
+
+// Input capture for deterministic replay on the host (see host/replay).
+// Every byte entering SSP_rx_handler_HL() (low byte first), uBloxReceiveHandler() and the UART0
+// RX FIFO is recorded together with the timer0 ticks that start a mainloop()
+// cycle. Records go into a RAM ring, the oldest records are overwritten.
+//
+// Record format: one header byte, bits 7..6 source, bits 5..0 count.
+// CAPTURE_SRC_TICK: count = timer0 ticks since the previous mainloop() cycle, no payload
+// other sources:    count = number of payload bytes that follow (1..63)
+//
+// The downloadable image is a CaptureHeader followed by the records, oldest first.
+
+#define CAPTURE_SRC_TICK  0
+#define CAPTURE_SRC_SSP   1
+#define CAPTURE_SRC_GPS   2
+#define CAPTURE_SRC_UART0 3
+
+#define CAPTURE_MAX_COUNT 63
+
+#define CAPTURE_MAGIC   0x31504143 // "CAP1"
+#define CAPTURE_VERSION 1
+
+typedef struct _CaptureHeader
+{
+  uint32_t magic;
+  uint16_t version;
+  uint16_t firmwareVersion;   // major << 8 | minor
+  uint32_t tickCycles;        // timer0 period [CPU cycles]
+  uint32_t firstTick;         // ticks since CaptureStart() before the first record
+  int64_t startTimeUs;        // SysTimeLongUSec() at CaptureStart()
+  uint32_t recordSize;        // bytes of record data following this header
+  uint32_t overwritten;       // record bytes lost to ring overflow
+} CaptureHeader;
+
+#if CAPTURE_ENABLE
+
+void CaptureStart(void);
+void CaptureStop(void);
+uint8_t CaptureIsRunning(void);
+
+// called from the timer0 ISR, newCycle is set when this tick starts a new mainloop() cycle
+void CaptureTick(uint8_t newCycle);
+void CaptureByte(uint8_t source, uint8_t data);
+
+// Total size of the image (header + records). Only valid when stopped.
+uint32_t CaptureImageSize(void);
+
+// Copy part of the image. Returns the number of bytes copied, 0 while running.
+uint32_t CaptureRead(uint32_t offset, uint8_t* pDst, uint32_t size);
+
+#define CAPTURE_TICK(newCycle) CaptureTick(newCycle)
+#define CAPTURE_BYTE(source, data) CaptureByte(source, data)
+
+#else
+
+#define CAPTURE_TICK(newCycle)
+#define CAPTURE_BYTE(source, data)
+
+#endif
@@ -19,9 +19,28 @@
 #include "hal/buzzer.h"
 #include "hal/sys_time.h"
 #include "sdkio.h"
+#include "capture.h"
+#include "scheduler.h"
+#include "profiler.h"
+#include "trace.h"
+#include "phase_lock.h"
+#include "jobs.h"
+#include "stack_monitor.h"
+#include "load_shed.h"
+#include "ll_hl_comm.h"
+#include "hal/ssp.h"
+#include "slow_channel.h"
+#include "ll_events.h"
+#include "jeti_sync.h"
 #include <string.h>
 #include <inttypes.h>
 
+// CPU cycles to 0.1us
+static uint32_t cyclesToTenthUs(uint32_t cycles)
+{
+  return ((uint64_t)cycles*10000000)/CPU_CLOCK_HZ;
+}
+
 void CLIEscCallback(VT100Result* pResult)
 {
   switch(pResult->code)
@@ -86,4 +105,220 @@ void CLICmdCallback()
     int64_t time = SysTimeLongUSec();
     TerminalPrint("SysTimeLong: %u%010u\r\n", (uint32_t)(time >> 32), (uint32_t)(time & 0xFFFFFFFF));
   }
+
+  if(TerminalCmpCmd("tasks"))
+  {
+    TerminalPrint("worst tick estimate: %hu us\r\n", scheduler.worstTickCostUs);
+
+    for(uint8_t i = 0; i < scheduler.numTasks; i++)
+    {
+      const SchedulerTask* pTask = &scheduler.pTasks[i];
+      const SchedulerTaskState* pState = &scheduler.state[i];
+
+      TerminalPrint("%-8s period: %4hu phase: %4hu releases: %10u overruns: %u\r\n", pTask->pName,
+          pTask->period, pState->phase, pState->releases, pState->overruns);
+    }
+  }
+
+  if(TerminalCmpCmd("jobs"))
+  {
+    uint32_t maxChunk = cyclesToTenthUs(jobs.maxChunkCycles);
+
+    TerminalPrint("jobs queued: %hhu posted: %u dropped: %u chunks: %u overruns: %u deferrals: %u max chunk: %u.%u us\r\n",
+        jobs.count, jobs.posted, jobs.dropped, jobs.chunks, jobs.overruns, jobs.deferrals, maxChunk/10, maxChunk%10);
+
+    for(uint8_t i = 0; i < jobs.count; i++)
+    {
+      const Job* pJob = &jobs.queue[(jobs.head + i) % JOBS_MAX];
+      TerminalPrint("  %-12s cost: %hu us\r\n", pJob->pName, pJob->costUs);
+    }
+  }
+
+  if(TerminalCmpCmd("stack"))
+  {
+    TerminalPrint("stack high-water marks after %u scans:\r\n", stackMonitor.scans);
+
+    for(uint8_t i = 0; i < STACK_MONITOR_NUM; i++)
+    {
+      TerminalPrint("%-4s size: %5hu used: %5hu free: %5hu\r\n", StackMonitorName(i),
+          stackMonitor.size[i], stackMonitor.used[i], stackMonitor.size[i] - stackMonitor.used[i]);
+    }
+  }
+
+  if(TerminalCmpCmd("llrx"))
+  {
+    TerminalPrint("LL frames received: %u, parsed: %u, dropped: %u\r\n", llRxStats.frames,
+        llRxStats.parsed, llRxStats.dropped);
+    TerminalPrint("sync losses: %u, odd starts: %u, bad frames: %u, page errors: %u, pages: %u/%u/%u\r\n",
+        llRxStats.syncLosses, llRxStats.oddStarts, llRxStats.badFrames, llRxStats.pageErrors,
+        llRxStats.pages[0], llRxStats.pages[1], llRxStats.pages[2]);
+    uint32_t gapMin = cyclesToTenthUs(llRxStats.gapMinCycles);
+    uint32_t gapMax = cyclesToTenthUs(llRxStats.gapMaxCycles);
+
+    TerminalPrint("frame gap min %u.%u max %u.%u us, late: %u\r\n", gapMin/10, gapMin%10, gapMax/10, gapMax%10,
+        llRxStats.lateFrames);
+    TerminalPrint("LL frames sent: %u, queued: %u, skipped: %u\r\n", sspTxStats.frames, sspTxStats.queued,
+        sspTxStats.skipped);
+  }
+
+  if(TerminalCmpCmd("slowch"))
+  {
+    TerminalPrint("slow channel slots: %u, idle: %u\r\n", slowChannel.slots, slowChannel.idleSlots);
+
+    for(uint8_t i = 0; i < SLOW_CHANNEL_NUM_CLASSES; i++)
+    {
+      const SlowChannelClassStat* pStat = &slowChannel.stat[i];
+
+      TerminalPrint("%-11s posted: %u done: %u failed: %u dropped: %u\r\n", SlowChannelClassName(i),
+          pStat->posted, pStat->done, pStat->failed, pStat->dropped);
+      TerminalPrint("%-11s wait mean %u max %u us, done mean %u max %u us\r\n", "",
+          pStat->started ? (uint32_t)(pStat->waitSumUs/pStat->started) : 0, pStat->waitMaxUs,
+          pStat->done ? (uint32_t)(pStat->doneSumUs/pStat->done) : 0, pStat->doneMaxUs);
+    }
+  }
+
+  if(TerminalCmpCmd("llevents"))
+  {
+    TerminalPrint("slow up channel values: %u, events: %u, untracked: %u, sdk lost: %u\r\n",
+        llEvents.updates, llEvents.seq, llEvents.ignored, SDKEventsLost());
+
+    for(uint8_t i = 0; i < LL_EVENTS_NUM_CHANNELS; i++)
+    {
+      if(llEvents.seen & (1 << i))
+        TerminalPrint("SUDC 0x%02X: %hd, %u events\r\n", i, llEvents.last[i], llEvents.events[i]);
+    }
+  }
+
+  if(TerminalCmpCmd("jetisync"))
+  {
+    const JetiSyncStats* pStat = &jetiSync.stat;
+
+    TerminalPrint("jeti slots: %u, used: %u, refreshes: %u\r\n", pStat->slots, pStat->used, pStat->refreshes);
+    TerminalPrint("text updates: %u, latency mean %u max %u us\r\n", pStat->textUpdates,
+        pStat->textUpdates ? (uint32_t)(pStat->textLatencySumUs/pStat->textUpdates) : 0, pStat->textLatencyMaxUs);
+  }
+
+  if(TerminalCmpCmd("loadshed on"))
+  {
+    LoadShedSetMode(LOAD_SHED_ON);
+  }
+
+  if(TerminalCmpCmd("loadshed off"))
+  {
+    LoadShedSetMode(LOAD_SHED_OFF);
+  }
+
+  if(TerminalCmpCmd("loadshed auto"))
+  {
+    LoadShedSetMode(LOAD_SHED_AUTO);
+  }
+
+  if(TerminalCmpCmd("loadshed") || TerminalCmpCmd("loadshed on") || TerminalCmpCmd("loadshed off")
+      || TerminalCmpCmd("loadshed auto"))
+  {
+    static const char* const modes[] = { "auto", "on", "off" };
+
+    TerminalPrint("Load shedding: %s (%s), load %hu/1000, events: %u, active ticks: %u\r\n",
+        loadShed.active ? "active" : "inactive", modes[loadShed.mode], loadShed.load, loadShed.events,
+        loadShed.activeTicks);
+
+    for(uint8_t i = 0; i < LOAD_SHED_NUM; i++)
+      TerminalPrint("  %-10s skipped: %u\r\n", LoadShedName(i), loadShed.skipped[i]);
+  }
+
+#if PROFILER_ENABLE
+  if(TerminalCmpCmd("profile reset"))
+  {
+    ProfilerReset();
+  }
+
+  if(TerminalCmpCmd("profile"))
+  {
+    TerminalPrint("overhead: %u cycles per stage, times in us\r\n", profiler.overheadCycles);
+    TerminalPrint("stage         count    min   mean    p99     max\r\n");
+
+    ProfilerStats stats;
+    const char* pName;
+
+    for(uint8_t i = 0; (pName = ProfilerGetStats(i, &stats)) != 0; i++)
+    {
+      uint32_t t[4] = { stats.minCycles, stats.meanCycles, stats.p99Cycles, stats.maxCycles };
+
+      for(uint8_t j = 0; j < 4; j++)
+        t[j] = cyclesToTenthUs(t[j]);
+
+      TerminalPrint("%-8s %10u %4u.%u %4u.%u %4u.%u %5u.%u\r\n", pName, stats.count,
+          t[0]/10, t[0]%10, t[1]/10, t[1]%10, t[2]/10, t[2]%10, t[3]/10, t[3]%10);
+    }
+  }
+#endif
+
+  if(TerminalCmpCmd("phaselock on"))
+  {
+    PhaseLockEnable(1);
+  }
+
+  if(TerminalCmpCmd("phaselock off"))
+  {
+    PhaseLockEnable(0);
+  }
+
+  if(TerminalCmpCmd("phaselock reset"))
+  {
+    PhaseLockResetStat();
+  }
+
+  if(TerminalCmpCmd("phaselock") || TerminalCmpCmd("phaselock on") || TerminalCmpCmd("phaselock off"))
+  {
+    const PhaseLockStat* pStat = &phaseLock.stat;
+
+    TerminalPrint("Phase lock: %s, %s, trim %d cycles, frames: %u, error: %d .. %d cycles\r\n",
+        phaseLock.enabled ? "on" : "off", phaseLock.locked ? "locked" : "unlocked", phaseLock.trim,
+        pStat->frames, pStat->minError, pStat->maxError);
+
+    if(pStat->commands)
+    {
+      uint32_t t[3] = { pStat->minLatency, pStat->sumLatency/pStat->commands, pStat->maxLatency };
+
+      for(uint8_t j = 0; j < 3; j++)
+        t[j] = cyclesToTenthUs(t[j]);
+
+      TerminalPrint("frame to LL write: %u commands, min %u.%u mean %u.%u max %u.%u us\r\n", pStat->commands,
+          t[0]/10, t[0]%10, t[1]/10, t[1]%10, t[2]/10, t[2]%10);
+    }
+  }
+
+#if TRACE_ENABLE
+  if(TerminalCmpCmd("trace start"))
+  {
+    TraceStart();
+  }
+
+  if(TerminalCmpCmd("trace stop"))
+  {
+    TraceStop();
+  }
+
+  if(TerminalCmpCmd("trace status") || TerminalCmpCmd("trace start") || TerminalCmpCmd("trace stop"))
+  {
+    TerminalPrint("Trace: %s, %u bytes\r\n", TraceIsRunning() ? "running" : "stopped", TraceImageSize());
+  }
+#endif
+
+#if CAPTURE_ENABLE
+  if(TerminalCmpCmd("capture start"))
+  {
+    CaptureStart();
+  }
+
+  if(TerminalCmpCmd("capture stop"))
+  {
+    CaptureStop();
+  }
+
+  if(TerminalCmpCmd("capture status") || TerminalCmpCmd("capture start") || TerminalCmpCmd("capture stop"))
+  {
+    TerminalPrint("Capture: %s, %u bytes\r\n", CaptureIsRunning() ? "running" : "stopped", CaptureImageSize());
+  }
+#endif
 }
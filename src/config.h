@@ -37,6 +37,59 @@
 // EXT_COM
 #define EXT_COM_MAX_MSG_SIZE 128
 
+// Handle ExtCom messages as soon as they are complete (src/ext_com.h), initial state
+#ifndef EXT_COM_FAST_PATH
+#define EXT_COM_FAST_PATH 1
+#endif
+
+// Input capture for host replay, costs CAPTURE_BUFFER_SIZE bytes of RAM when enabled
+#ifndef CAPTURE_ENABLE
+#define CAPTURE_ENABLE 0
+#endif
+#ifndef CAPTURE_BUFFER_SIZE
+#define CAPTURE_BUFFER_SIZE 8192
+#endif
+
+// Main loop profiler (src/profiler.h), about 2kB of RAM
+#ifndef PROFILER_ENABLE
+#define PROFILER_ENABLE 1
+#endif
+
+// Interrupt latency and duration histograms (src/irq_stats.h)
+#ifndef IRQ_STATS_ENABLE
+#define IRQ_STATS_ENABLE 1
+#endif
+
+// Event trace (src/trace.h), costs 2*8*TRACE_RING_SIZE bytes of RAM when enabled
+#ifndef TRACE_ENABLE
+#define TRACE_ENABLE 0
+#endif
+#ifndef TRACE_RING_SIZE
+#define TRACE_RING_SIZE 256
+#endif
+
+// Phase lock timer 0 to the LL frames (src/phase_lock.h), initial state
+#ifndef PHASE_LOCK_ENABLE
+#define PHASE_LOCK_ENABLE 0
+#endif
+
+// Load shedding thresholds (src/load_shed.h) in 1/1000 CPU load
+#ifndef LOAD_SHED_HIGH
+#define LOAD_SHED_HIGH 900
+#endif
+#ifndef LOAD_SHED_LOW
+#define LOAD_SHED_LOW 700
+#endif
+
+// Jeti telemetry sync to the LL (src/jeti_sync.h) in page 0 frames, 2ms each:
+// full refresh period and minimum period of a value group
+#ifndef JETI_SYNC_REFRESH_SLOTS
+#define JETI_SYNC_REFRESH_SLOTS 500
+#endif
+#ifndef JETI_SYNC_VALUE_SLOTS
+#define JETI_SYNC_VALUE_SLOTS 5
+#endif
+
 
 #if VEHICLE_TYPE == VEHICLE_TYPE_HUMMINGBIRD
 #define MAX_THRUST 20.0f
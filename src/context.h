@@ -0,0 +1,27 @@
+/*
+ * Copyright (C) 2017 Intel Deutschland GmbH, Germany
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+// Storage class of all mutable firmware state (globals and function statics).
+// The target runs exactly one instance and CONTEXT_LOCAL is empty. Host
+// programs that run several independent vehicles in one process build with
+// HOST_MULTI_INSTANCE, which gives every thread its own copy of the state.
+#if defined(HOST_BUILD) && defined(HOST_MULTI_INSTANCE)
+#define CONTEXT_LOCAL __thread
+#else
+#define CONTEXT_LOCAL
+#endif
@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2017 Intel Deutschland GmbH, Germany
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "coroutine.h"
+#include "LPC214x.h"
+
+void CoroutineInit(Coroutine* pCo, uint16_t budgetUs)
+{
+  pCo->line = 0;
+  pCo->budgetCycles = budgetUs*(CPU_CLOCK_HZ/1000000);
+  pCo->startCycles = 0;
+  pCo->resumes = 0;
+  pCo->overruns = 0;
+  pCo->maxCycles = 0;
+}
+
+void CoroutineReset(Coroutine* pCo)
+{
+  pCo->line = 0;
+}
+
+uint8_t CoroutineRun(Coroutine* pCo, CoroutineFunc pFunc)
+{
+  pCo->startCycles = T1TC;
+
+  uint8_t result = (*pFunc)(pCo);
+
+  uint32_t cycles = SysTimeCyclesBetween(pCo->startCycles, T1TC);
+
+  ++pCo->resumes;
+  if(cycles > pCo->budgetCycles)
+    ++pCo->overruns;
+  if(cycles > pCo->maxCycles)
+    pCo->maxCycles = cycles;
+
+  return result;
+}
+
+uint8_t CoroutineOverBudget(const Coroutine* pCo)
+{
+  return SysTimeCyclesBetween(pCo->startCycles, T1TC) > pCo->budgetCycles;
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2017 Intel Deutschland GmbH, Germany
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "context.h"
+#include "hal/sys_time.h"
+#include <stdint.h>
+
+// Stackless coroutines for SDK user code (protothread style, no heap).
+// A coroutine is a function that is resumed once per tick by CoroutineRun()
+// and continues after the CO_* statement where it returned last time:
+//
+//   static uint8_t myTask(Coroutine* pCo)
+//   {
+//     CO_BEGIN(pCo);
+//     CO_WAIT_UNTIL(pCo, sdk.ro.waypoint.ackTrigger);
+//     ...
+//     CO_YIELD(pCo);  // continue in the next tick
+//     ...
+//     CO_END(pCo);
+//   }
+//
+// Local variables are lost at every yield, keep state in static CONTEXT_LOCAL
+// variables. Resume points are case labels named after the line: only one
+// CO_* statement per line and none inside a switch of the coroutine body.
+//
+// Each resume has a budget of CPU cycles. Long computations call
+// CO_YIELD_IF_OVER_BUDGET() between steps to continue in the next tick once
+// the budget is used up. Resumes that exceed it are counted as overruns.
+
+#define CO_WAITING  0
+#define CO_ENDED    1
+
+typedef struct _Coroutine
+{
+  uint16_t line;            // resume point, 0 = start of the body
+  uint32_t budgetCycles;
+  uint32_t startCycles;     // T1TC at the start of the current resume
+
+  uint32_t resumes;
+  uint32_t overruns;
+  uint32_t maxCycles;
+} Coroutine;
+
+typedef uint8_t(*CoroutineFunc)(Coroutine* pCo);
+
+// static initializer, same as CoroutineInit()
+#define COROUTINE_INIT(budgetUs) { 0, (budgetUs)*(CPU_CLOCK_HZ/1000000), 0, 0, 0, 0 }
+
+void CoroutineInit(Coroutine* pCo, uint16_t budgetUs);
+
+// next CoroutineRun() starts the body from the beginning
+void CoroutineReset(Coroutine* pCo);
+
+// resume pFunc once, returns CO_WAITING or CO_ENDED
+uint8_t CoroutineRun(Coroutine* pCo, CoroutineFunc pFunc);
+
+uint8_t CoroutineOverBudget(const Coroutine* pCo);
+
+#define CO_BEGIN(pCo) \
+  switch((pCo)->line) { case 0:
+
+// continue in the next tick
+#define CO_YIELD(pCo) \
+  do { (pCo)->line = __LINE__; return CO_WAITING; case __LINE__:; } while(0)
+
+// continue as soon as cond is true, checked once per tick
+#define CO_WAIT_UNTIL(pCo, cond) \
+  do { if(!(cond)) { (pCo)->line = __LINE__; return CO_WAITING; case __LINE__: if(!(cond)) return CO_WAITING; } } while(0)
+
+#define CO_YIELD_IF_OVER_BUDGET(pCo) \
+  do { if(CoroutineOverBudget(pCo)) CO_YIELD(pCo); } while(0)
+
+// start again from CO_BEGIN() in the next tick
+#define CO_RESTART(pCo) \
+  do { (pCo)->line = 0; return CO_WAITING; } while(0)
+
+#define CO_END(pCo) \
+  } (pCo)->line = 0; return CO_ENDED
@@ -18,8 +18,94 @@
 #include "../sdkio.h"
 #include "../sdk.h"
 #include "../util/gpsmath.h"
+#include "../coroutine.h"
+#include "context.h"
 
-WaypointExample wpExample;
+CONTEXT_LOCAL WaypointExample wpExample;
+
+// per tick budget of the waypoint flight, one xy2latlon() fits
+#define WAYPOINT_BUDGET_US 100
+
+static CONTEXT_LOCAL Coroutine waypointCo = COROUTINE_INIT(WAYPOINT_BUDGET_US);
+static CONTEXT_LOCAL double originLat, originLon;
+
+// command a waypoint north/east of the origin in meters at the current height
+static void sendWaypoint(double north, double east, int heading)
+{
+  double lat, lon;
+
+  //fill waypoint structure
+  sdk.cmd.wpAbsolute.maxSpeed = 100;
+  sdk.cmd.wpAbsolute.reachedTolerance = 3000; // 3m accuracy
+  sdk.cmd.wpAbsolute.timeToStay = 4000; // 4 seconds waiting time at each waypoint
+
+  sdk.cmd.wpAbsolute.heading = heading;
+  sdk.cmd.wpAbsolute.height = sdk.ro.height; //use current height
+
+  xy2latlon(originLat, originLon, east, north, &lat, &lon);
+
+  sdk.cmd.wpAbsolute.longitude = lon * 10000000;
+  sdk.cmd.wpAbsolute.latitude = lat * 10000000;
+
+  //send waypoint
+  sdk.cmd.wpAbsolute.updated = 1;
+}
+
+// command processed by the LL processor and waypoint reached (or pilot abort)
+static uint8_t waypointDone(void)
+{
+  return (sdk.cmd.wpAbsolute.updated == 0) && (sdk.ro.waypoint.ackTrigger)
+      && (sdk.ro.waypoint.navStatus & (WP_NAVSTAT_REACHED_POS_TIME | WP_NAVSTAT_PILOT_ABORT));
+}
+
+// rest of the 15m by 15m square in meters north/east of the origin
+static const double square[3][2] = { { 15.0, 15.0 }, { 0.0, 15.0 }, { 0.0, 0.0 } };
+
+static uint8_t waypointFlight(Coroutine* pCo)
+{
+  static CONTEXT_LOCAL uint8_t i;
+
+  CO_BEGIN(pCo);
+
+  // jeti Mx menu or aux channel can start example
+  CO_WAIT_UNTIL(pCo, wpExample.startEvent);
+  wpExample.startEvent = 0;
+  wpExample.state = 1;
+  CO_YIELD(pCo);
+
+  sdk.cmd.mode = SDK_CMD_MODE_GPS_WAYPOINT_ABS;
+
+  originLat = (double)sdk.ro.gps.latitude / 10000000.0;
+  originLon = (double)sdk.ro.gps.longitude / 10000000.0;
+
+  //first waypoint 15m north of us, use current height and yaw
+  wpExample.wpNr = 0;
+  sendWaypoint(15.0, 0.0, sdk.ro.attitude.yaw);
+
+  for(i = 0; i < 3; i++)
+  {
+    //wait until the cmd is sent to the LL processor, the waypoint was reached and the wait time is over
+    wpExample.state = i + 2;
+    CO_WAIT_UNTIL(pCo, waypointDone());
+
+    //next waypoint, the last one is the start point. Also sent if the pilot aborted at the same time.
+    if(sdk.ro.waypoint.navStatus & WP_NAVSTAT_REACHED_POS_TIME)
+    {
+      sendWaypoint(square[i][0], square[i][1], sdk.ro.attitude.angle[2]);
+      wpExample.wpNr++;
+    }
+
+    if(sdk.ro.waypoint.navStatus & WP_NAVSTAT_PILOT_ABORT)
+    {
+      wpExample.state = 0;
+      CO_RESTART(pCo);
+    }
+  }
+
+  wpExample.state = 0;
+
+  CO_END(pCo);
+}
 
 /* This function demonstrates simple waypoint command generation. To use this command set you
  * strictly require GPS reception. The UAV must be flying and in GPS mode prior to the start of this example.
@@ -44,10 +130,7 @@ WaypointExample wpExample;
  */
 void ExampleGPSWaypointControl()
 {
-//  static unsigned char wpExampleState = 0;
-  static double originLat, originLon;
-
-  static uint8_t auxState = 2;
+  static CONTEXT_LOCAL uint8_t auxState = 2;
 
   if(sdk.ro.rc.aux < 1600)
   {
@@ -65,7 +148,7 @@ void ExampleGPSWaypointControl()
     auxState = 1;
   }
 
-  // reset static variables if serial interface is off
+  // reset the flight if serial interface is off
   if(sdk.ro.serialInterfaceReady == 0 || wpExample.abortEvent)
   {
     auxState = 2;
@@ -73,173 +156,8 @@ void ExampleGPSWaypointControl()
     sdk.cmd.mode = SDK_CMD_MODE_OFF;
     wpExample.startEvent = 0;
     wpExample.abortEvent = 0;
+    CoroutineReset(&waypointCo);
   }
 
-
-  switch(wpExample.state)
-  {
-    case 0:
-    {
-      if(wpExample.startEvent) // jeti Mx menu or aux channel can start example
-      {
-        wpExample.startEvent = 0;
-        wpExample.state = 1;
-      }
-    }
-    break;
-
-    case 1:
-    {
-      double lat, lon;
-      //calculate and send first waypoint and switch state
-      sdk.cmd.mode = SDK_CMD_MODE_GPS_WAYPOINT_ABS;
-
-      //fill waypoint structure
-      sdk.cmd.wpAbsolute.maxSpeed = 100;
-      sdk.cmd.wpAbsolute.reachedTolerance = 3000; // 3m accuracy
-      sdk.cmd.wpAbsolute.timeToStay = 4000; // 4 seconds waiting time at each waypoint
-
-      //use current height and yaw
-      sdk.cmd.wpAbsolute.heading = sdk.ro.attitude.yaw; //use current yaw
-      sdk.cmd.wpAbsolute.height = sdk.ro.height; //use current height
-
-      originLat = (double)sdk.ro.gps.latitude / 10000000.0;
-      originLon = (double)sdk.ro.gps.longitude / 10000000.0;
-
-      //calculate a position 15m north of us
-      xy2latlon(originLat, originLon, 0.0, 15.0, &lat, &lon);
-
-      sdk.cmd.wpAbsolute.longitude = lon * 10000000;
-      sdk.cmd.wpAbsolute.latitude = lat * 10000000;
-
-      //send waypoint
-      sdk.cmd.wpAbsolute.updated = 1;
-
-      wpExample.wpNr = 0;
-      wpExample.state = 2;
-    }
-    break;
-
-    case 2:
-    {
-      //wait until cmd is processed and sent to LL processor
-      if((sdk.cmd.wpAbsolute.updated == 0) && (sdk.ro.waypoint.ackTrigger))
-      {
-        //check if waypoint was reached and wait time is over
-        if(sdk.ro.waypoint.navStatus & (WP_NAVSTAT_REACHED_POS_TIME))
-        {
-          //new waypoint
-          double lat, lon;
-
-          //fill waypoint structure
-          sdk.cmd.wpAbsolute.maxSpeed = 100;
-          sdk.cmd.wpAbsolute.reachedTolerance = 3000; // 3m accuracy
-          sdk.cmd.wpAbsolute.timeToStay = 4000; // 4 seconds waiting time at each waypoint
-
-          //use current height and yaw
-          sdk.cmd.wpAbsolute.heading = sdk.ro.attitude.angle[2]; //use current yaw
-          sdk.cmd.wpAbsolute.height = sdk.ro.height; //use current height
-
-          //calculate a position 15m north and 15m east of origin
-          xy2latlon(originLat, originLon, 15.0, 15.0, &lat, &lon);
-
-          sdk.cmd.wpAbsolute.longitude = lon * 10000000;
-          sdk.cmd.wpAbsolute.latitude = lat * 10000000;
-
-          //send waypoint
-          sdk.cmd.wpAbsolute.updated = 1;
-
-          wpExample.wpNr++;
-          wpExample.state = 3;
-        }
-
-        if(sdk.ro.waypoint.navStatus & WP_NAVSTAT_PILOT_ABORT)
-        {
-          wpExample.state = 0;
-        }
-      }
-    }
-    break;
-
-    case 3:
-    {
-      //wait until cmd is processed and sent to LL processor
-      if((sdk.cmd.wpAbsolute.updated == 0) && (sdk.ro.waypoint.ackTrigger))
-      {
-        //check if waypoint was reached and wait time is over
-        if(sdk.ro.waypoint.navStatus & (WP_NAVSTAT_REACHED_POS_TIME))
-        {
-          //new waypoint
-          double lat, lon;
-
-          //fill waypoint structure
-          sdk.cmd.wpAbsolute.maxSpeed = 100;
-          sdk.cmd.wpAbsolute.reachedTolerance = 3000; // 3m accuracy
-          sdk.cmd.wpAbsolute.timeToStay = 4000; // 4 seconds waiting time at each waypoint
-
-          //use current height and yaw
-          sdk.cmd.wpAbsolute.heading = sdk.ro.attitude.angle[2]; //use current yaw
-          sdk.cmd.wpAbsolute.height = sdk.ro.height; //use current height
-
-          //calculate a position 15m east of origin
-          xy2latlon(originLat, originLon, 15.0, 0.0, &lat, &lon);
-
-          sdk.cmd.wpAbsolute.longitude = lon * 10000000;
-          sdk.cmd.wpAbsolute.latitude = lat * 10000000;
-
-          //send waypoint
-          sdk.cmd.wpAbsolute.updated = 1;
-
-          wpExample.wpNr++;
-          wpExample.state = 4;
-        }
-
-        if(sdk.ro.waypoint.navStatus & WP_NAVSTAT_PILOT_ABORT)
-        {
-          wpExample.state = 0;
-        }
-      }
-    }
-    break;
-
-    case 4:
-    {
-      //wait until cmd is processed and sent to LL processor
-      if((sdk.cmd.wpAbsolute.updated == 0) && (sdk.ro.waypoint.ackTrigger))
-      {
-        //check if waypoint was reached and wait time is over
-        if(sdk.ro.waypoint.navStatus & (WP_NAVSTAT_REACHED_POS_TIME))
-        {
-          //fill waypoint structure
-          sdk.cmd.wpAbsolute.maxSpeed = 100;
-          sdk.cmd.wpAbsolute.reachedTolerance = 3000; // 3m accuracy
-          sdk.cmd.wpAbsolute.timeToStay = 4000; // 4 seconds waiting time at each waypoint
-
-          //use current height and yaw
-          sdk.cmd.wpAbsolute.heading = sdk.ro.attitude.angle[2]; //use current yaw
-          sdk.cmd.wpAbsolute.height = sdk.ro.height; //use current height
-
-          //go to the start point
-          sdk.cmd.wpAbsolute.longitude = originLon * 10000000;
-          sdk.cmd.wpAbsolute.latitude = originLat * 10000000;
-
-          //send waypoint
-          sdk.cmd.wpAbsolute.updated = 1;
-
-          wpExample.wpNr++;
-          wpExample.state = 0;
-        }
-
-        if(sdk.ro.waypoint.navStatus & WP_NAVSTAT_PILOT_ABORT)
-        {
-          wpExample.state = 0;
-        }
-      }
-    }
-    break;
-
-    default:
-      wpExample.state = 0;
-      break;
-  }
+  CoroutineRun(&waypointCo, &waypointFlight);
 }
@@ -16,6 +16,7 @@
 
 #include "motor_on_off.h"
 #include "../sdkio.h"
+#include "context.h"
 
 /**
  * This example shows you how to turn on and off the motors via SDK code.
@@ -30,8 +31,8 @@
  */
 void ExampleMotorsOnOff()
 {
-  static uint8_t state = 0;
-  static uint16_t timer;
+  static CONTEXT_LOCAL uint8_t state = 0;
+  static CONTEXT_LOCAL uint16_t timer;
 
   sdk.cmd.mode = SDK_CMD_MODE_RPY_THRUST;
 
@@ -16,6 +16,7 @@
 
 #include "terminal_print.h"
 #include "../sdkio.h"
+#include "context.h"
 
 /**
  * This example simply prints out all information in the sdk.ro.* fields
@@ -27,7 +28,7 @@
  */
 void ExampleRegularTerminalPrint()
 {
-  static uint32_t cnt = 0;
+  static CONTEXT_LOCAL uint32_t cnt = 0;
 
   ++cnt;
   if(cnt == 100) // print out all SDK read-only data every 100ms
@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2017 Intel Deutschland GmbH, Germany
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "update_callbacks.h"
+#include "../sdkio.h"
+#include "context.h"
+
+static CONTEXT_LOCAL UpdateCallbacksExample example;
+
+static void onHeightUpdate(uint8_t group, uint32_t seq)
+{
+  (void)group;
+  (void)seq;
+
+  example.height += (sdk.ro.height - example.height)/8;
+  example.climbRate += (sdk.ro.verticalSpeed - example.climbRate)/8;
+  ++example.heightUpdates;
+}
+
+static void onGPSUpdate(uint8_t group, uint32_t seq)
+{
+  (void)group;
+  (void)seq;
+
+  if(sdk.ro.gps.raw.hasLock)
+    ++example.gpsUpdates;
+}
+
+/**
+ * This example shows you how to run code only when its input data changed.
+ *
+ * SDKMainloop() runs at 1kHz, but only the attitude is new on every call. Height,
+ * vertical speed and motor data arrive at 333Hz and GPS data at about 5Hz. The
+ * functions subscribed here run once for each new sample, right before SDKMainloop(),
+ * so the filter below is not fed the same height three times.
+ *
+ * Call ExampleUpdateCallbacksInit() once from SDKInit().
+ */
+void ExampleUpdateCallbacksInit()
+{
+  SDKSubscribe(SDK_GROUP_MASK(SDK_GROUP_HEIGHT_MOTORS), &onHeightUpdate);
+  SDKSubscribe(SDK_GROUP_MASK(SDK_GROUP_GPS_RAW), &onGPSUpdate);
+}
@@ -0,0 +1,29 @@
+/*
+ * Copyright (C) 2017 Intel Deutschland GmbH, Germany
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+typedef struct _UpdateCallbacksExample
+{
+  int32_t height;         // low pass filtered height [mm]
+  int32_t climbRate;      // low pass filtered vertical speed [mm/s]
+  uint32_t heightUpdates;
+  uint32_t gpsUpdates;
+} UpdateCallbacksExample;
+
+void ExampleUpdateCallbacksInit();
@@ -22,10 +22,25 @@
 #include "asctec_uav_msgs/transport_definitions.h"
 #include "sdkio.h"
 #include "sdk.h"
+#include "capture.h"
+#include "profiler.h"
+#include "irq_stats.h"
+#include "trace.h"
+#include "stack_monitor.h"
+#include "load_shed.h"
+#include "ll_hl_comm.h"
+#include "slow_channel.h"
+#include "ll_events.h"
+#include "ext_msgs.h"
 #include <math.h>
 #include <string.h>
+#include "context.h"
 
-ExtCom extCom;
+CONTEXT_LOCAL ExtCom extCom;
+
+static CONTEXT_LOCAL uint8_t fastPath = EXT_COM_FAST_PATH;
+
+static CONTEXT_LOCAL LLEventReader llEventReader;
 
 static void msgImu();
 static void msgVehicleStatus();
@@ -33,6 +48,17 @@ static void msgRcData();
 static void msgMotorState();
 static void msgGpsData();
 static void msgFilteredSensorData();
+#if PROFILER_ENABLE
+static void msgProfilerNextStage();
+#endif
+#if IRQ_STATS_ENABLE
+static void msgIrqStatsNext();
+#endif
+static void msgStackUsage();
+static void msgLoadShed();
+static void msgLLLink();
+static void msgSlowChannel();
+static void msgLLEvents();
 
 typedef void(*ExtTxFunc)();
 
@@ -44,13 +70,24 @@ typedef struct _MsgTxConfig
   uint16_t cnt;
 } MsgTxConfig;
 
-static MsgTxConfig wireCfg[] = {
+static CONTEXT_LOCAL MsgTxConfig wireCfg[] = {
   { MESSAGE_ID_IMU,                  &msgImu,                0, 0 },
   { MESSAGE_ID_VEHICLE_STATUS,       &msgVehicleStatus,      0, 0 },
   { MESSAGE_ID_RC_DATA,              &msgRcData,             0, 0 },
   { MESSAGE_ID_MOTOR_STATE,          &msgMotorState,         0, 0 },
   { MESSAGE_ID_GPS_DATA,             &msgGpsData,            0, 0 },
   { MESSAGE_ID_FILTERED_SENSOR_DATA, &msgFilteredSensorData, 0, 0 },
+#if PROFILER_ENABLE
+  { EXT_MSG_ID_PROFILER_STAGE,       &msgProfilerNextStage,  0, 0 },
+#endif
+#if IRQ_STATS_ENABLE
+  { EXT_MSG_ID_IRQ_STATS,            &msgIrqStatsNext,       0, 0 },
+#endif
+  { EXT_MSG_ID_STACK_USAGE,          &msgStackUsage,         0, 0 },
+  { EXT_MSG_ID_LOAD_SHED,            &msgLoadShed,           0, 0 },
+  { EXT_MSG_ID_LL_LINK,              &msgLLLink,             0, 0 },
+  { EXT_MSG_ID_SLOW_CHANNEL,         &msgSlowChannel,        0, 0 },
+  { EXT_MSG_ID_LL_EVENTS,            &msgLLEvents,           0, 0 },
 };
 
 int16_t ExtComSend(void* _pData, uint32_t dataSize)
@@ -96,6 +133,314 @@ int16_t ExtComSendMessage(TransportHeader* pHeader, void* pData, uint32_t dataSi
   return ExtComSend(extCom.sendBuffer, sizeof(TransportHeader)+dataSize);
 }
 
+// Spread the enabled messages over their periods, so that messages with the
+// same divisor do not all go out in the same main loop cycle.
+static void staggerWireCfg()
+{
+  const uint16_t numMsgs = sizeof(wireCfg) / sizeof(wireCfg[0]);
+
+  for(uint16_t i = 0; i < numMsgs; i++)
+    wireCfg[i].cnt = (uint32_t)wireCfg[i].div * i / numMsgs;
+}
+
+#if CAPTURE_ENABLE
+static void msgCaptureStatus()
+{
+  TransportHeader header;
+  ExtMsgCaptureStatus status;
+
+  header.flags = 0;
+  header.id = EXT_MSG_ID_CAPTURE_STATUS;
+  header.ackId = 0;
+
+  memset(&status, 0, sizeof(status));
+  status.running = CaptureIsRunning();
+  status.imageSize = CaptureImageSize();
+
+  ExtComSendMessage(&header, &status, sizeof(status));
+}
+
+static void msgCaptureData(uint32_t offset)
+{
+  TransportHeader header;
+  ExtMsgCaptureData data;
+
+  header.flags = 0;
+  header.id = EXT_MSG_ID_CAPTURE_DATA;
+  header.ackId = 0;
+
+  data.offset = offset;
+  data.imageSize = CaptureImageSize();
+  data.length = CaptureRead(offset, data.data, EXT_MSG_CAPTURE_DATA_SIZE);
+  data.reserved = 0;
+
+  ExtComSendMessage(&header, &data, sizeof(data) - EXT_MSG_CAPTURE_DATA_SIZE + data.length);
+}
+#endif
+
+#if PROFILER_ENABLE
+static CONTEXT_LOCAL uint8_t profilerTxStage;
+
+static void msgProfilerStage(uint8_t stage)
+{
+  TransportHeader header;
+  ExtMsgProfilerStage msg;
+  ProfilerStats stats;
+
+  header.flags = 0;
+  header.id = EXT_MSG_ID_PROFILER_STAGE;
+  header.ackId = 0;
+
+  const char* pName = ProfilerGetStats(stage, &stats);
+  if(!pName)
+    return;
+
+  memset(&msg, 0, sizeof(msg));
+  msg.stage = stage;
+  msg.numStages = ProfilerNumStages();
+  uint32_t nameLength = strlen(pName);
+  memcpy(msg.name, pName, nameLength < EXT_MSG_PROFILER_NAME_SIZE ? nameLength : EXT_MSG_PROFILER_NAME_SIZE);
+  msg.count = stats.count;
+  msg.minCycles = stats.minCycles;
+  msg.meanCycles = stats.meanCycles;
+  msg.p99Cycles = stats.p99Cycles;
+  msg.maxCycles = stats.maxCycles;
+  msg.overheadCycles = profiler.overheadCycles;
+
+  ExtComSendMessage(&header, &msg, sizeof(msg));
+}
+
+static void msgProfilerNextStage()
+{
+  if(profilerTxStage >= ProfilerNumStages())
+    profilerTxStage = 0;
+
+  msgProfilerStage(profilerTxStage++);
+}
+#endif
+
+#if IRQ_STATS_ENABLE
+static CONTEXT_LOCAL uint8_t irqStatsTxIrq;
+
+static void msgIrqStats(uint8_t irq)
+{
+  TransportHeader header;
+  ExtMsgIrqStats msg;
+
+  header.flags = 0;
+  header.id = EXT_MSG_ID_IRQ_STATS;
+  header.ackId = 0;
+
+  const char* pName = IRQStatsName(irq);
+  if(!pName)
+    return;
+
+  // handlers keep updating, the copy may mix two of their calls
+  const IRQStatsEntry* pEntry = &irqStats.irq[irq];
+
+  memset(&msg, 0, sizeof(msg));
+  msg.irq = irq;
+  msg.numIrqs = IRQ_STATS_NUM;
+  uint32_t nameLength = strlen(pName);
+  memcpy(msg.name, pName, nameLength < EXT_MSG_IRQ_STATS_NAME_SIZE ? nameLength : EXT_MSG_IRQ_STATS_NAME_SIZE);
+  msg.count = pEntry->count;
+  msg.maxLatencyCycles = pEntry->maxLatencyCycles;
+  msg.maxDurationCycles = pEntry->maxDurationCycles;
+  memcpy(msg.latency, pEntry->latency, sizeof(msg.latency));
+  memcpy(msg.duration, pEntry->duration, sizeof(msg.duration));
+
+  ExtComSendMessage(&header, &msg, sizeof(msg));
+}
+
+static void msgIrqStatsNext()
+{
+  if(irqStatsTxIrq >= IRQ_STATS_NUM)
+    irqStatsTxIrq = 0;
+
+  msgIrqStats(irqStatsTxIrq++);
+}
+#endif
+
+static void msgStackUsage()
+{
+  TransportHeader header;
+  ExtMsgStackUsage msg;
+
+  header.flags = 0;
+  header.id = EXT_MSG_ID_STACK_USAGE;
+  header.ackId = 0;
+
+  msg.scans = stackMonitor.scans;
+  memcpy(msg.size, stackMonitor.size, sizeof(msg.size));
+  memcpy(msg.used, stackMonitor.used, sizeof(msg.used));
+
+  ExtComSendMessage(&header, &msg, sizeof(msg));
+}
+
+static void msgLoadShed()
+{
+  TransportHeader header;
+  ExtMsgLoadShed msg;
+
+  header.flags = 0;
+  header.id = EXT_MSG_ID_LOAD_SHED;
+  header.ackId = 0;
+
+  msg.active = loadShed.active;
+  msg.mode = loadShed.mode;
+  msg.loadPerMill = loadShed.load;
+  msg.events = loadShed.events;
+  msg.activeTicks = loadShed.activeTicks;
+  memcpy(msg.skipped, loadShed.skipped, sizeof(msg.skipped));
+
+  ExtComSendMessage(&header, &msg, sizeof(msg));
+}
+
+static void msgLLLink()
+{
+  TransportHeader header;
+  ExtMsgLLLink msg;
+
+  header.flags = 0;
+  header.id = EXT_MSG_ID_LL_LINK;
+  header.ackId = 0;
+
+  msg.frames = llRxStats.frames;
+  msg.dropped = llRxStats.dropped;
+  msg.syncLosses = llRxStats.syncLosses;
+  msg.badFrames = llRxStats.badFrames;
+  msg.pageErrors = llRxStats.pageErrors;
+  memcpy(msg.pages, llRxStats.pages, sizeof(msg.pages));
+  msg.lateFrames = llRxStats.lateFrames;
+  msg.gapMinUs = SysTimeCyclesToUSec(llRxStats.gapMinCycles);
+  msg.gapMaxUs = SysTimeCyclesToUSec(llRxStats.gapMaxCycles);
+
+  ExtComSendMessage(&header, &msg, sizeof(msg));
+}
+
+static void msgSlowChannel()
+{
+  TransportHeader header;
+  ExtMsgSlowChannel msg;
+
+  header.flags = 0;
+  header.id = EXT_MSG_ID_SLOW_CHANNEL;
+  header.ackId = 0;
+
+  msg.slots = slowChannel.slots;
+  msg.idleSlots = slowChannel.idleSlots;
+
+  for(uint8_t i = 0; i < EXT_MSG_SLOW_CHANNEL_NUM; i++)
+  {
+    const SlowChannelClassStat* pStat = &slowChannel.stat[i];
+
+    msg.posted[i] = pStat->posted;
+    msg.done[i] = pStat->done;
+    msg.failed[i] = pStat->failed;
+    msg.waitMeanUs[i] = pStat->started ? pStat->waitSumUs/pStat->started : 0;
+    msg.waitMaxUs[i] = pStat->waitMaxUs;
+    msg.doneMeanUs[i] = pStat->done ? pStat->doneSumUs/pStat->done : 0;
+    msg.doneMaxUs[i] = pStat->doneMaxUs;
+  }
+
+  ExtComSendMessage(&header, &msg, sizeof(msg));
+}
+
+static void msgLLEvents()
+{
+  TransportHeader header;
+  ExtMsgLLEvents msg;
+  LLEvent event;
+
+  header.flags = 0;
+  header.id = EXT_MSG_ID_LL_EVENTS;
+  header.ackId = 0;
+
+  memset(&msg, 0, sizeof(msg));
+
+  while(msg.numEvents < EXT_MSG_LL_EVENTS_NUM && LLEventRead(&llEventReader, &event))
+  {
+    ExtMsgLLEvent* pEvent = &msg.events[msg.numEvents++];
+
+    pEvent->timeUs = event.timeUs;
+    pEvent->seq = event.seq;
+    pEvent->value = event.value;
+    pEvent->previous = event.previous;
+    pEvent->select = event.select;
+    pEvent->first = event.first;
+  }
+
+  if(!msg.numEvents)
+    return;
+
+  msg.lost = llEventReader.lost;
+
+  ExtComSendMessage(&header, &msg, sizeof(msg) - sizeof(msg.events) + msg.numEvents*sizeof(ExtMsgLLEvent));
+}
+
+#if TRACE_ENABLE
+typedef struct _TraceDownload
+{
+  uint32_t offset;
+  uint32_t end;
+} TraceDownload;
+
+static CONTEXT_LOCAL TraceDownload traceDownload;
+
+static void msgTraceStatus()
+{
+  TransportHeader header;
+  ExtMsgTraceStatus status;
+
+  header.flags = 0;
+  header.id = EXT_MSG_ID_TRACE_STATUS;
+  header.ackId = 0;
+
+  memset(&status, 0, sizeof(status));
+  status.running = TraceIsRunning();
+  status.imageSize = TraceImageSize();
+
+  ExtComSendMessage(&header, &status, sizeof(status));
+}
+
+// stream the requested image range while there is room in the UART0 TX FIFO
+static void sendTraceData()
+{
+  TransportHeader header;
+  ExtMsgTraceData data;
+
+  header.flags = 0;
+  header.id = EXT_MSG_ID_TRACE_DATA;
+  header.ackId = 0;
+
+  while(traceDownload.offset < traceDownload.end
+      && FifoBytesFree(&uart0.txFifo) >= EXT_COM_MAX_ENCODED_MSG_SIZE)
+  {
+    uint32_t size = traceDownload.end - traceDownload.offset;
+    if(size > EXT_MSG_TRACE_DATA_SIZE)
+      size = EXT_MSG_TRACE_DATA_SIZE;
+
+    data.offset = traceDownload.offset;
+    data.imageSize = TraceImageSize();
+    data.length = TraceRead(traceDownload.offset, data.data, size);
+    data.reserved = 0;
+
+    if(data.length == 0)
+    {
+      // running or past the end, tell the receiver and stop
+      traceDownload.end = 0;
+      traceDownload.offset = 0;
+    }
+    else
+    {
+      traceDownload.offset += data.length;
+    }
+
+    ExtComSendMessage(&header, &data, sizeof(data) - EXT_MSG_TRACE_DATA_SIZE + data.length);
+  }
+}
+#endif
+
 static int16_t handleExtMsg(uint8_t* pData, uint32_t dataSize)
 {
   TransportHeader header;
@@ -112,6 +457,8 @@ static int16_t handleExtMsg(uint8_t* pData, uint32_t dataSize)
     dataSize -= sizeof(TransportHeader);
   }
 
+  TRACE(TRACE_EV_EXTCOM_MSG, header.id);
+
   switch(header.id)
   {
     case MESSAGE_ID_COMMAND_MOTOR_SPEED:
@@ -211,13 +558,108 @@ static int16_t handleExtMsg(uint8_t* pData, uint32_t dataSize)
         {
           if(wireCfg[i].msgId == msgId)
           {
+            // forward events from now on, not the backlog
+            if(msgId == EXT_MSG_ID_LL_EVENTS && !wireCfg[i].div)
+              LLEventReaderInit(&llEventReader);
+
             wireCfg[i].div = div;
             break;
           }
         }
       }
+
+      staggerWireCfg();
+    }
+    break;
+#if CAPTURE_ENABLE
+    case EXT_MSG_ID_CAPTURE_CONTROL:
+    {
+      if(dataSize < sizeof(ExtMsgCaptureControl))
+        break;
+
+      ExtMsgCaptureControl* pCtrl = (ExtMsgCaptureControl*)pData;
+
+      if(pCtrl->command == EXT_MSG_CAPTURE_CMD_START)
+        CaptureStart();
+      else if(pCtrl->command == EXT_MSG_CAPTURE_CMD_STOP)
+        CaptureStop();
+
+      msgCaptureStatus();
     }
     break;
+    case EXT_MSG_ID_CAPTURE_READ:
+    {
+      if(dataSize < sizeof(ExtMsgCaptureRead))
+        break;
+
+      ExtMsgCaptureRead read;
+      memcpy(&read, pData, sizeof(read));
+
+      msgCaptureData(read.offset);
+    }
+    break;
+#endif
+#if PROFILER_ENABLE
+    case EXT_MSG_ID_PROFILER_CONTROL:
+    {
+      if(dataSize < sizeof(ExtMsgProfilerControl))
+        break;
+
+      ExtMsgProfilerControl* pCtrl = (ExtMsgProfilerControl*)pData;
+
+      if(pCtrl->command == EXT_MSG_PROFILER_CMD_RESET)
+        ProfilerReset();
+      else if(pCtrl->command == EXT_MSG_PROFILER_CMD_READ)
+        msgProfilerStage(pCtrl->stage);
+    }
+    break;
+#endif
+#if IRQ_STATS_ENABLE
+    case EXT_MSG_ID_IRQ_STATS_CONTROL:
+    {
+      if(dataSize < sizeof(ExtMsgIrqStatsControl))
+        break;
+
+      ExtMsgIrqStatsControl* pCtrl = (ExtMsgIrqStatsControl*)pData;
+
+      if(pCtrl->command == EXT_MSG_IRQ_STATS_CMD_RESET)
+        IRQStatsReset();
+      else if(pCtrl->command == EXT_MSG_IRQ_STATS_CMD_READ)
+        msgIrqStats(pCtrl->irq);
+    }
+    break;
+#endif
+#if TRACE_ENABLE
+    case EXT_MSG_ID_TRACE_CONTROL:
+    {
+      if(dataSize < sizeof(ExtMsgTraceControl))
+        break;
+
+      ExtMsgTraceControl* pCtrl = (ExtMsgTraceControl*)pData;
+
+      if(pCtrl->command == EXT_MSG_TRACE_CMD_START)
+        TraceStart();
+      else if(pCtrl->command == EXT_MSG_TRACE_CMD_STOP)
+        TraceStop();
+
+      msgTraceStatus();
+    }
+    break;
+    case EXT_MSG_ID_TRACE_READ:
+    {
+      if(dataSize < sizeof(ExtMsgTraceRead))
+        break;
+
+      ExtMsgTraceRead read;
+      memcpy(&read, pData, sizeof(read));
+
+      traceDownload.offset = read.offset;
+      traceDownload.end = read.offset + read.length;
+      if(traceDownload.end < read.offset)
+        traceDownload.end = 0xFFFFFFFF;
+    }
+    break;
+#endif
     default:
     {
       SDKProcessUserMsg(&header, pData, dataSize);
@@ -285,6 +727,24 @@ static void eulerRPY2Quaternion(const float* pRPY, Quaternion* pQuat)
   pQuat->z = t1 * t2 * t4 - t0 * t3 * t5;
 }
 
+// sample times for messages without timestamp, right after the message
+static void sendSampleTimes(uint32_t msgId)
+{
+  TransportHeader header;
+  ExtMsgSampleTimes msg;
+
+  header.flags = 0;
+  header.id = EXT_MSG_ID_SAMPLE_TIMES;
+  header.ackId = 0;
+
+  msg.msgId = msgId;
+  msg.attitudeUs = sdk.ro.sampleTimeUs.attitude;
+  memcpy(msg.pageUs, sdk.ro.sampleTimeUs.page, sizeof(msg.pageUs));
+  msg.gpsUs = sdk.ro.gps.raw.timestampUs;
+
+  ExtComSendMessage(&header, &msg, sizeof(msg));
+}
+
 static void msgImu()
 {
   TransportHeader header;
@@ -294,7 +754,7 @@ static void msgImu()
   header.flags = 0;
   header.ackId = 0;
 
-  imu.timestampUs = SysTimeLongUSec();
+  imu.timestampUs = sdk.ro.sampleTimeUs.attitude;
   imu.angularVelocity.x = sdk.ro.attitude.angularVelocity[0]*0.001f*((float)M_PI)/180.0f;
   imu.angularVelocity.y = sdk.ro.attitude.angularVelocity[1]*0.001f*((float)M_PI)/180.0f;
   imu.angularVelocity.z = sdk.ro.attitude.angularVelocity[2]*0.001f*((float)M_PI)/180.0f;
@@ -320,7 +780,7 @@ static void msgVehicleStatus()
   header.ackId = 0;
 
   VehicleStatus vStatus;
-  vStatus.timestampUs = SysTimeLongUSec();
+  vStatus.timestampUs = sdk.ro.sampleTimeUs.page[2];
   vStatus.batteryVoltageMv = sdk.ro.sensors.battery;
   vStatus.cpuLoadPerMill = sdk.ro.cpuLoad;
   vStatus.flightMode = sdk.ro.flightMode;
@@ -340,7 +800,7 @@ static void msgRcData()
   header.ackId = 0;
 
   RcData rc;
-  rc.timestampUs = SysTimeLongUSec();
+  rc.timestampUs = sdk.ro.sampleTimeUs.page[0];
   rc.hasLock = sdk.ro.rc.hasLock;
   rc.aux = sdk.ro.rc.aux*8;
   rc.stickPitch = sdk.ro.rc.pitch*8;
@@ -363,7 +823,7 @@ static void msgMotorState()
   header.ackId = 0;
 
   MotorState motor;
-  motor.timestampUs = SysTimeLongUSec();
+  motor.timestampUs = sdk.ro.sampleTimeUs.page[1];
   memset(motor.commadedRpm, 0, sizeof(motor.commadedRpm));
   memcpy(motor.commadedRpm, sdk.cmd.dimc.rpm, sizeof(sdk.cmd.dimc.rpm));
   memset(motor.measuredRpm, 0, sizeof(motor.measuredRpm));
@@ -396,6 +856,7 @@ static void msgGpsData()
   gps.status = sdk.ro.gps.raw.hasLock ? 0x03 : 0x00;
 
   ExtComSendMessage(&header, &gps, sizeof(GpsData));
+  sendSampleTimes(MESSAGE_ID_GPS_DATA);
 }
 
 static void msgFilteredSensorData()
@@ -419,29 +880,15 @@ static void msgFilteredSensorData()
   data.baroHeight = sdk.ro.height*0.001f;
 
   ExtComSendMessage(&header, &data, sizeof(FilteredSensorData));
+  sendSampleTimes(MESSAGE_ID_FILTERED_SENSOR_DATA);
 }
 
-void ExtComSpinOnce()
+static void receiveMessages()
 {
   uint8_t data;
 
-  ++extCom.cmdTimeout;
-
-  if(extCom.cmdTimeout > 200)
-  {
-    extCom.cmdTimeout = 200;
-
-    if(extCom.active)
-    {
-      sdk.cmd.mode = SDK_CMD_MODE_OFF;
-      extCom.active = 0;
-    }
-  }
-
-  if(extCom.cmdTimeout < 200)
-  {
-    extCom.active = 1;
-  }
+  // messages completed after this are pending for the fast path
+  extCom.rxDelimiters = uart0.rxDelimiters;
 
   // check RX data
   while(FifoGet(&uart0.rxFifo, &data) == 0)
@@ -465,10 +912,53 @@ void ExtComSpinOnce()
       }
     }
   }
+}
+
+uint8_t ExtComFastPath(void)
+{
+  if(!fastPath || extCom.rxDelimiters == uart0.rxDelimiters)
+    return 0;
+
+  receiveMessages();
+
+  return 1;
+}
+
+void ExtComSetFastPath(uint8_t enable)
+{
+  fastPath = enable;
+}
+
+void ExtComSpinOnce()
+{
+  ++extCom.cmdTimeout;
+
+  if(extCom.cmdTimeout > 200)
+  {
+    extCom.cmdTimeout = 200;
+
+    if(extCom.active)
+    {
+      sdk.cmd.mode = SDK_CMD_MODE_OFF;
+      extCom.active = 0;
+    }
+  }
+
+  if(extCom.cmdTimeout < 200)
+  {
+    extCom.active = 1;
+  }
+
+  receiveMessages();
+
+  // do regular transmissions, only the load shedding state while shedding
+  uint8_t shed = !LoadShedAllow(LOAD_SHED_TELEMETRY);
 
-  // do regular transmissions
   for(uint16_t i = 0; i < sizeof(wireCfg) / sizeof(wireCfg[0]); i++)
   {
+    if(shed && wireCfg[i].msgId != EXT_MSG_ID_LOAD_SHED)
+      continue;
+
     ++wireCfg[i].cnt;
 
     if(wireCfg[i].cnt >= wireCfg[i].div && wireCfg[i].div > 0)
@@ -477,4 +967,8 @@ void ExtComSpinOnce()
       (*wireCfg[i].pTxFunc)();
     }
   }
+
+#if TRACE_ENABLE
+  sendTraceData();
+#endif
 }
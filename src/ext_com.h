@@ -20,6 +20,7 @@
 #include "util/cobs.h"
 #include "asctec_uav_msgs/transport_definitions.h"
 #include <stdint.h>
+#include "context.h"
 
 #define EXT_COM_HEADER_SIZE sizeof(uint16_t)
 #define EXT_COM_CHECKSUM_SIZE sizeof(uint16_t)
@@ -31,6 +32,7 @@ typedef struct _ExtCom
 
   uint8_t rxProcBuffer[EXT_COM_MAX_ENCODED_MSG_SIZE];
   uint16_t rxProcUsed;
+  uint16_t rxDelimiters;  // uart0.rxDelimiters when the Rx fifo was last drained
 
   uint8_t sendBuffer[EXT_COM_MAX_MSG_SIZE];
 
@@ -56,8 +58,16 @@ typedef struct _ExtCom
   uint8_t active;
 } ExtCom;
 
-extern ExtCom extCom;
+extern CONTEXT_LOCAL ExtCom extCom;
 
 void ExtComSpinOnce();
+
+// Command fast path. The UART0 Rx interrupt counts frame delimiters, so a
+// complete message is noticed without draining the fifo. ExtComFastPath()
+// handles all complete messages right away, called from the idle loop and
+// before the SDK task. Commands then go out with the next HL2LL_write_cycle()
+// instead of the one after it. Returns 1 if messages were pending.
+uint8_t ExtComFastPath(void);
+void ExtComSetFastPath(uint8_t enable);
 int16_t ExtComSend(void* _pData, uint32_t dataSize);
 int16_t ExtComSendMessage(TransportHeader* pHeader, void* pData, uint32_t dataSize);
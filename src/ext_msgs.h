@@ -0,0 +1,259 @@
+/*
+ * Copyright (C) 2017 Intel Deutschland GmbH, Germany
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+// Firmware specific messages on the ExtCom link.
+// IDs start at 0x8000 to stay clear of asctec_uav_msgs.
+
+#define EXT_MSG_ID_CAPTURE_CONTROL 0x8001
+#define EXT_MSG_ID_CAPTURE_STATUS  0x8002
+#define EXT_MSG_ID_CAPTURE_READ    0x8003
+#define EXT_MSG_ID_CAPTURE_DATA    0x8004
+#define EXT_MSG_ID_PROFILER_CONTROL 0x8005
+#define EXT_MSG_ID_PROFILER_STAGE   0x8006
+#define EXT_MSG_ID_IRQ_STATS_CONTROL 0x8007
+#define EXT_MSG_ID_IRQ_STATS        0x8008
+#define EXT_MSG_ID_TRACE_CONTROL    0x8009
+#define EXT_MSG_ID_TRACE_STATUS     0x800A
+#define EXT_MSG_ID_TRACE_READ       0x800B
+#define EXT_MSG_ID_TRACE_DATA       0x800C
+#define EXT_MSG_ID_STACK_USAGE      0x800D
+#define EXT_MSG_ID_LOAD_SHED        0x800E
+#define EXT_MSG_ID_LL_LINK          0x800F
+#define EXT_MSG_ID_SAMPLE_TIMES     0x8010
+#define EXT_MSG_ID_SLOW_CHANNEL     0x8011
+#define EXT_MSG_ID_LL_EVENTS        0x8012
+
+#define EXT_MSG_CAPTURE_CMD_STOP   0
+#define EXT_MSG_CAPTURE_CMD_START  1
+#define EXT_MSG_CAPTURE_CMD_STATUS 2
+
+#define EXT_MSG_CAPTURE_DATA_SIZE 64
+
+#define EXT_MSG_PROFILER_CMD_RESET 0
+#define EXT_MSG_PROFILER_CMD_READ  1
+
+#define EXT_MSG_PROFILER_NAME_SIZE 8
+
+#define EXT_MSG_IRQ_STATS_CMD_RESET 0
+#define EXT_MSG_IRQ_STATS_CMD_READ  1
+
+#define EXT_MSG_IRQ_STATS_NAME_SIZE 8
+#define EXT_MSG_IRQ_STATS_BUCKETS  16
+
+#define EXT_MSG_TRACE_CMD_STOP   0
+#define EXT_MSG_TRACE_CMD_START  1
+#define EXT_MSG_TRACE_CMD_STATUS 2
+
+#define EXT_MSG_TRACE_DATA_SIZE 96
+
+#define EXT_MSG_STACK_USAGE_NUM 6
+
+#define EXT_MSG_LOAD_SHED_NUM 4
+
+#define EXT_MSG_SLOW_CHANNEL_NUM 4
+
+#define EXT_MSG_LL_EVENTS_NUM 4
+
+typedef struct __attribute__((packed)) _ExtMsgCaptureControl
+{
+  uint8_t command;
+} ExtMsgCaptureControl;
+
+typedef struct __attribute__((packed)) _ExtMsgCaptureStatus
+{
+  uint8_t running;
+  uint8_t reserved[3];
+  uint32_t imageSize;
+} ExtMsgCaptureStatus;
+
+typedef struct __attribute__((packed)) _ExtMsgCaptureRead
+{
+  uint32_t offset;
+} ExtMsgCaptureRead;
+
+typedef struct __attribute__((packed)) _ExtMsgCaptureData
+{
+  uint32_t offset;
+  uint32_t imageSize;
+  uint16_t length;
+  uint16_t reserved;
+  uint8_t data[EXT_MSG_CAPTURE_DATA_SIZE];
+} ExtMsgCaptureData;
+
+typedef struct __attribute__((packed)) _ExtMsgProfilerControl
+{
+  uint8_t command;
+  uint8_t stage;              // for EXT_MSG_PROFILER_CMD_READ
+} ExtMsgProfilerControl;
+
+// Execution time of one main loop stage, all times in CPU cycles (58.9824MHz).
+// Sent round robin over all stages at the rate divisor of EXT_MSG_ID_PROFILER_STAGE.
+typedef struct __attribute__((packed)) _ExtMsgProfilerStage
+{
+  uint8_t stage;
+  uint8_t numStages;
+  uint16_t reserved;
+  char name[EXT_MSG_PROFILER_NAME_SIZE];
+  uint32_t count;
+  uint32_t minCycles;
+  uint32_t meanCycles;
+  uint32_t p99Cycles;
+  uint32_t maxCycles;
+  uint32_t overheadCycles;    // instrumentation cost per stage and pass
+} ExtMsgProfilerStage;
+
+typedef struct __attribute__((packed)) _ExtMsgIrqStatsControl
+{
+  uint8_t command;
+  uint8_t irq;                // for EXT_MSG_IRQ_STATS_CMD_READ
+} ExtMsgIrqStatsControl;
+
+// Latency and duration histograms of one interrupt handler in CPU cycles.
+// Bucket n counts [2^n, 2^(n+1)) cycles, the last one everything above.
+// Sent round robin over all handlers at the rate divisor of EXT_MSG_ID_IRQ_STATS.
+typedef struct __attribute__((packed)) _ExtMsgIrqStats
+{
+  uint8_t irq;
+  uint8_t numIrqs;
+  uint16_t reserved;
+  char name[EXT_MSG_IRQ_STATS_NAME_SIZE];
+  uint32_t count;
+  uint32_t maxLatencyCycles;
+  uint32_t maxDurationCycles;
+  uint16_t latency[EXT_MSG_IRQ_STATS_BUCKETS];
+  uint16_t duration[EXT_MSG_IRQ_STATS_BUCKETS];
+} ExtMsgIrqStats;
+
+typedef struct __attribute__((packed)) _ExtMsgTraceControl
+{
+  uint8_t command;
+} ExtMsgTraceControl;
+
+typedef struct __attribute__((packed)) _ExtMsgTraceStatus
+{
+  uint8_t running;
+  uint8_t reserved[3];
+  uint32_t imageSize;
+} ExtMsgTraceStatus;
+
+// Bulk read: the image range [offset, offset+length) is streamed as
+// EXT_MSG_ID_TRACE_DATA messages as fast as UART0 allows.
+// A new read replaces a running one, length 0 stops it.
+typedef struct __attribute__((packed)) _ExtMsgTraceRead
+{
+  uint32_t offset;
+  uint32_t length;
+} ExtMsgTraceRead;
+
+typedef struct __attribute__((packed)) _ExtMsgTraceData
+{
+  uint32_t offset;
+  uint32_t imageSize;
+  uint16_t length;
+  uint16_t reserved;
+  uint8_t data[EXT_MSG_TRACE_DATA_SIZE];
+} ExtMsgTraceData;
+
+// Stack high-water marks in bytes, in the order usr, svc, irq, fiq, abt, und.
+// Sent at the rate divisor of EXT_MSG_ID_STACK_USAGE.
+typedef struct __attribute__((packed)) _ExtMsgStackUsage
+{
+  uint32_t scans;             // complete scans so far
+  uint16_t size[EXT_MSG_STACK_USAGE_NUM];
+  uint16_t used[EXT_MSG_STACK_USAGE_NUM];
+} ExtMsgStackUsage;
+
+// Load shedding state (src/load_shed.h), skipped calls in the order telemetry,
+// jeti, ptu, firefly. Sent at the rate divisor of EXT_MSG_ID_LOAD_SHED, also
+// while telemetry is shed.
+typedef struct __attribute__((packed)) _ExtMsgLoadShed
+{
+  uint8_t active;
+  uint8_t mode;               // 0 auto, 1 forced on, 2 forced off
+  uint16_t loadPerMill;       // short term average
+  uint32_t events;            // times shedding started
+  uint32_t activeTicks;
+  uint32_t skipped[EXT_MSG_LOAD_SHED_NUM];
+} ExtMsgLoadShed;
+
+// Health of the SPI link from the LL (LLRxStats in src/ll_hl_comm.h), counts
+// since startup. Sent at the rate divisor of EXT_MSG_ID_LL_LINK.
+typedef struct __attribute__((packed)) _ExtMsgLLLink
+{
+  uint32_t frames;            // complete frames received
+  uint32_t dropped;           // replaced before the main loop parsed them
+  uint32_t syncLosses;
+  uint32_t badFrames;         // no end marker or invalid page
+  uint32_t pageErrors;        // page out of sequence
+  uint32_t pages[3];
+  uint32_t lateFrames;        // more than 1.5ms after the previous frame
+  uint32_t gapMinUs;
+  uint32_t gapMaxUs;
+} ExtMsgLLLink;
+
+// Sample times of the data in the message with msgId, sent right after GpsData
+// and FilteredSensorData which have no timestamp field. HL arrival times of the
+// LL frames and of the GPS solution in us since boot, see sdk.ro.sampleTimeUs.
+typedef struct __attribute__((packed)) _ExtMsgSampleTimes
+{
+  uint32_t msgId;
+  int64_t attitudeUs;
+  int64_t pageUs[3];
+  int64_t gpsUs;
+} ExtMsgSampleTimes;
+
+// Slow data channel to the LL (src/slow_channel.h), per item class in the order
+// em mode, declination, build info, sdk. Latencies from posting to the first
+// slot (wait) and to completion or confirmation (done). Sent at the rate
+// divisor of EXT_MSG_ID_SLOW_CHANNEL.
+typedef struct __attribute__((packed)) _ExtMsgSlowChannel
+{
+  uint32_t slots;
+  uint32_t idleSlots;
+  uint32_t posted[EXT_MSG_SLOW_CHANNEL_NUM];
+  uint32_t done[EXT_MSG_SLOW_CHANNEL_NUM];
+  uint32_t failed[EXT_MSG_SLOW_CHANNEL_NUM];
+  uint32_t waitMeanUs[EXT_MSG_SLOW_CHANNEL_NUM];
+  uint32_t waitMaxUs[EXT_MSG_SLOW_CHANNEL_NUM];
+  uint32_t doneMeanUs[EXT_MSG_SLOW_CHANNEL_NUM];
+  uint32_t doneMaxUs[EXT_MSG_SLOW_CHANNEL_NUM];
+} ExtMsgSlowChannel;
+
+typedef struct __attribute__((packed)) _ExtMsgLLEvent
+{
+  int64_t timeUs;             // arrival of the LL frame, us since boot
+  uint32_t seq;
+  int16_t value;
+  int16_t previous;           // 0 if first is set
+  uint8_t select;             // SUDC_*
+  uint8_t first;              // first value seen on this channel
+} ExtMsgLLEvent;
+
+// Changes on the slow up channel of the LL (src/ll_events.h), oldest first.
+// Checked at the rate divisor of EXT_MSG_ID_LL_EVENTS and only sent if there are
+// new events, with divisor 1 in the main loop cycle after they were received.
+// Only numEvents entries are transmitted.
+typedef struct __attribute__((packed)) _ExtMsgLLEvents
+{
+  uint32_t lost;              // events overwritten before they were sent, since startup
+  uint8_t numEvents;
+  uint8_t reserved[3];
+  ExtMsgLLEvent events[EXT_MSG_LL_EVENTS_NUM];
+} ExtMsgLLEvents;
@@ -19,8 +19,6 @@
 #include "target.h"
 #include "adc.h"
 
-#define ADC_OFFSET         0x10
-#define ADC_INDEX          4
 
 #define ADC_DONE           0x80000000
 #define ADC_OVERRUN        0x40000000
@@ -48,7 +46,7 @@ uint32_t ADC0GetRawValue(uint8_t index)
     return 0;
 
   uint32_t channelVal;
-  uint32_t regVal = *(volatile uint32_t*)(AD0_BASE_ADDR + ADC_OFFSET + ADC_INDEX * index);
+  uint32_t regVal = (&AD0DR0)[index];
 
   if((regVal & (ADC_OVERRUN | ADC_DONE)) == 0)
     channelVal = 0;
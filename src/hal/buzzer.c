@@ -23,6 +23,7 @@
 #include "LPC214x.h"
 #include "i2c1.h"
 #include "led.h"
+#include "context.h"
 
 //Buzzer active defines
 #define BU_INIT             0x01
@@ -51,16 +52,16 @@
 void BuzzerHandler(unsigned int vbat, uint8_t gpsLock, uint8_t rcInGPSMode, uint16_t llError)	//needs to be triggered at 100 Hz
 {
   unsigned int buz_active = 0;
-  static unsigned short error_cnt_mag_fs;
-  static unsigned short error_cnt_mag_inc;
-  static unsigned short error_cnt_compass;
+  static CONTEXT_LOCAL unsigned short error_cnt_mag_fs;
+  static CONTEXT_LOCAL unsigned short error_cnt_mag_inc;
+  static CONTEXT_LOCAL unsigned short error_cnt_compass;
 
   unsigned int buz_priority = 0;
-  static unsigned short buz_cnt = 0;
+  static CONTEXT_LOCAL unsigned short buz_cnt = 0;
 
-  static unsigned int bat_div = 5;
-  static int bat_cnt = 0, bat_warning = 0;
-  static char bat_warning_enabled = 0;
+  static CONTEXT_LOCAL unsigned int bat_div = 5;
+  static CONTEXT_LOCAL int bat_cnt = 0, bat_warning = 0;
+  static CONTEXT_LOCAL char bat_warning_enabled = 0;
 
   unsigned char i;
 
@@ -18,15 +18,16 @@
 
 #include "LPC214x.h"
 #include <string.h>
+#include "context.h"
 
 #define SECTOR_NUMBER 14
 #define FLASH_ADDR 0x00038000
 #define FLASH_SIZE 0x8000
 #define SYSCLK_KHZ 58982
 
-Flash flash;
+CONTEXT_LOCAL Flash flash;
 
-static uint8_t wrBuf[FLASH_PAGE_SIZE] __attribute__((aligned (4)));
+static CONTEXT_LOCAL uint8_t wrBuf[FLASH_PAGE_SIZE] __attribute__((aligned (4)));
 
 #define IAP_LOCATION      0x7ffffff1
 typedef void (*IAP)(uint32_t[], uint32_t[]);
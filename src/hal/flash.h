@@ -17,6 +17,7 @@
 #pragma once
 
 #include <stdint.h>
+#include "context.h"
 
 #define FLASH_PAGE_SIZE 256
 #define FLASH_MAX_PAGES 4
@@ -36,7 +37,7 @@ typedef struct _Flash
   FlashPage pageBackup[FLASH_MAX_PAGES];
 } Flash;
 
-extern Flash flash;
+extern CONTEXT_LOCAL Flash flash;
 
 int16_t FlashRead(uint8_t id, void* pDest, uint8_t size);
 void    FlashWrite(uint8_t id, const void* pData, uint8_t size);
@@ -18,6 +18,8 @@
 #include "LPC214x.h"
 #include "type.h"
 #include "irq.h"
+#include "context.h"
+#include "irq_stats.h"
 
 #define BUFSIZE       0x20
 #define MAX_TIMEOUT   0x00FFFFFF
@@ -49,13 +51,13 @@
 #define I2SCLH_SCLH         0x00000080  // I2C SCL Duty Cycle High Reg
 #define I2SCLL_SCLL         0x00000080  // I2C SCL Duty Cycle Low Reg
 
-static DWORD I2CMasterState = I2C_IDLE;
-static DWORD I2CCmd;
-static BYTE I2CMasterBuffer[BUFSIZE];
-static DWORD I2CReadLength;
-static DWORD I2CWriteLength;
-static DWORD RdIndex = 0;
-static DWORD WrIndex = 0;
+static CONTEXT_LOCAL DWORD I2CMasterState = I2C_IDLE;
+static CONTEXT_LOCAL DWORD I2CCmd;
+static CONTEXT_LOCAL BYTE I2CMasterBuffer[BUFSIZE];
+static CONTEXT_LOCAL DWORD I2CReadLength;
+static CONTEXT_LOCAL DWORD I2CWriteLength;
+static CONTEXT_LOCAL DWORD RdIndex = 0;
+static CONTEXT_LOCAL DWORD WrIndex = 0;
 
 /* 
  From device to device, the I2C communication protocol may vary,
@@ -79,6 +81,8 @@ static DWORD WrIndex = 0;
  *****************************************************************************/
 void I2C0MasterHandler(void) __irq
 {
+  IRQ_STATS_ENTER(IRQ_STATS_I2C0);
+
   BYTE StatValue;
 
   /* this handler deals with master read and master write only */
@@ -181,6 +185,7 @@ void I2C0MasterHandler(void) __irq
       break;
   }
 
+  IRQ_STATS_EXIT(IRQ_STATS_I2C0);
   IDISABLE;
   VICVectAddr = 0; /* Acknowledge Interrupt */
 }
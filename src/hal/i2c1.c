@@ -24,6 +24,8 @@
 #include "util/gpsmath.h"
 #include "system.h"
 #include "../sdkio.h"
+#include "context.h"
+#include "irq_stats.h"
 
 #define BUFSIZE 0x20
 
@@ -60,11 +62,11 @@
 #define I2C_ERROR_BUSBUSY         0x05
 #define I2C_ERROR_NODATA          0x06
 
-static DWORD I2C1MasterState = I2C_IDLE;
-static BYTE I2C1MasterBuffer[BUFSIZE];
-static DWORD I2C1WriteLength;
-static DWORD WrIndex1 = 0;
-static unsigned char lastI2c1Error = I2C_ERROR_NONE;
+static CONTEXT_LOCAL DWORD I2C1MasterState = I2C_IDLE;
+static CONTEXT_LOCAL BYTE I2C1MasterBuffer[BUFSIZE];
+static CONTEXT_LOCAL DWORD I2C1WriteLength;
+static CONTEXT_LOCAL DWORD WrIndex1 = 0;
+static CONTEXT_LOCAL unsigned char lastI2c1Error = I2C_ERROR_NONE;
 
 /*
  From device to device, the I2C communication protocol may vary,
@@ -89,6 +91,8 @@ static unsigned char lastI2c1Error = I2C_ERROR_NONE;
 
 void I2C1MasterHandler(void) __irq
 {
+  IRQ_STATS_ENTER(IRQ_STATS_I2C1);
+
   BYTE StatValue;
 
   /* this handler deals with master read and master write only */
@@ -155,6 +159,7 @@ void I2C1MasterHandler(void) __irq
       break;
   }
 
+  IRQ_STATS_EXIT(IRQ_STATS_I2C1);
   IDISABLE;
   VICVectAddr = 0; /* Acknowledge Interrupt */
 }
@@ -163,10 +168,10 @@ void fireFlyLedHandler(uint8_t gpsStatus) 	//called with 100Hz
 {
   unsigned char r, g, b;
   unsigned short errorFlags;
-  static unsigned short cnt = 0;
-  static unsigned char mfsCnt = 0;
-  static unsigned char mincCnt = 0;
-  static unsigned char ceCnt = 0;
+  static CONTEXT_LOCAL unsigned short cnt = 0;
+  static CONTEXT_LOCAL unsigned char mfsCnt = 0;
+  static CONTEXT_LOCAL unsigned char mincCnt = 0;
+  static CONTEXT_LOCAL unsigned char ceCnt = 0;
 
   errorFlags = 0;
 
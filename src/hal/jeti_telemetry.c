@@ -16,16 +16,20 @@
 
 #include <string.h>
 #include "jeti_telemetry.h"
+#include "sys_time.h"
+#include "context.h"
 
-struct JETI_VALUE jetiValues[15];
-unsigned char jetiName[10];
-unsigned char jetiDisplayText[33];
-unsigned char jetiAlarm = 0;
-unsigned char jetiAlarmType = 0;
-unsigned char jetiTriggerTextSync = 0;
+CONTEXT_LOCAL struct JETI_VALUE jetiValues[15];
+CONTEXT_LOCAL unsigned char jetiName[10];
+CONTEXT_LOCAL unsigned char jetiDisplayText[33];
+CONTEXT_LOCAL unsigned char jetiAlarm = 0;
+CONTEXT_LOCAL unsigned char jetiAlarmType = 0;
 
-unsigned char jetiKeyChanged = 0;
-unsigned char jetiKey = 0;
+CONTEXT_LOCAL uint32_t jetiDirty = JETI_DIRTY_ALL;
+CONTEXT_LOCAL uint32_t jetiTextChangedCycles;
+
+CONTEXT_LOCAL unsigned char jetiKeyChanged = 0;
+CONTEXT_LOCAL unsigned char jetiKey = 0;
 
 void jetiSetKeyChanged(unsigned char key)
 {
@@ -44,6 +48,21 @@ unsigned char jetiCheckForKeyChange(void)
   return 0;
 }
 
+static void setValue(unsigned char id, int value, unsigned char varType)
+{
+  if(jetiValues[id].value != value)
+  {
+    jetiValues[id].value = value;
+    jetiDirty |= JETI_DIRTY_VALUES(id);
+  }
+
+  if(jetiValues[id].varType != varType)
+  {
+    jetiValues[id].varType = varType;
+    jetiDirty |= JETI_DIRTY_SENSOR(id);
+  }
+}
+
 unsigned char jetiSetAlarm(unsigned char alarm, unsigned alarmType)
 {
   if(((alarm < 'A') || (alarm > 'Z')) && (alarm))
@@ -52,6 +71,9 @@ unsigned char jetiSetAlarm(unsigned char alarm, unsigned alarmType)
   if(alarmType > 1)
     return JETI_ERROR_ALARM_TYPE;
 
+  if(jetiAlarm != alarm || jetiAlarmType != alarmType)
+    jetiDirty |= JETI_DIRTY_ALARM;
+
   jetiAlarm = alarm;
   jetiAlarmType = alarmType;
 
@@ -75,6 +97,9 @@ unsigned char jetiSetDeviceName(const char * name)
 
   nameLength = i;
 
+  if(memcmp(&jetiName[0], name, nameLength))
+    jetiDirty |= JETI_DIRTY_NAME;
+
   memcpy(&jetiName[0], name, nameLength);
 
   return error;
@@ -85,6 +110,9 @@ unsigned char jetiActivateValue(unsigned char id)
   if(id > 14)
     return JETI_ERROR_ID_RANGE;
 
+  if(jetiValues[id].active != id + 1)
+    jetiDirty |= JETI_DIRTY_SENSOR(id);
+
   jetiValues[id].active = id + 1;
 
   return JETI_NO_ERROR;
@@ -96,6 +124,7 @@ unsigned char jetiDeactivateValue(unsigned char id)
     return JETI_ERROR_ID_RANGE;
 
   jetiValues[id].active = 0;
+  jetiDirty &= ~JETI_DIRTY_SENSOR(id);
 
   return JETI_NO_ERROR;
 }
@@ -108,6 +137,9 @@ unsigned char jetiSetDecimalPoint(unsigned char id, unsigned char decimalPoint)
   if(decimalPoint > 3)
     return JETI_ERROR_DECPOINT_RANGE;
 
+  if(jetiValues[id].decPoint != decimalPoint)
+    jetiDirty |= JETI_DIRTY_SENSOR(id);
+
   jetiValues[id].decPoint = decimalPoint;
 
   return JETI_NO_ERROR;
@@ -121,11 +153,7 @@ unsigned char jetiSetValue30B(unsigned char id, int value)
   if((value >= (1 << 30)) || (value <= -(1 << 30)))
     return JETI_ERROR_VALUE_RANGE;
 
-  jetiValues[id].value = value;
-  if(jetiValues[id].varType != JETI_VART_30B)
-  {
-    jetiValues[id].varType = JETI_VART_30B;
-  }
+  setValue(id, value, JETI_VART_30B);
 
   return JETI_NO_ERROR;
 }
@@ -138,11 +166,7 @@ unsigned char jetiSetValue22B(unsigned char id, int value)
   if((value >= (1 << 23)) || (value <= -(1 << 23)))
     return JETI_ERROR_VALUE_RANGE;
 
-  jetiValues[id].value = value;
-  if(jetiValues[id].varType != JETI_VART_22B)
-  {
-    jetiValues[id].varType = JETI_VART_22B;
-  }
+  setValue(id, value, JETI_VART_22B);
 
   return JETI_NO_ERROR;
 }
@@ -155,11 +179,7 @@ unsigned char jetiSetValue6B(unsigned char id, int value)
   if((value >= (1 << 7)) || (value <= -(1 << 7)))
     return JETI_ERROR_VALUE_RANGE;
 
-  jetiValues[id].value = value;
-  if(jetiValues[id].varType != JETI_VART_6B)
-  {
-    jetiValues[id].varType = JETI_VART_6B;
-  }
+  setValue(id, value, JETI_VART_6B);
 
   return JETI_NO_ERROR;
 }
@@ -172,11 +192,7 @@ unsigned char jetiSetValue14B(unsigned char id, int value)
   if((value >= (1 << 15)) || (value <= -(1 << 15)))
     return JETI_ERROR_VALUE_RANGE;
 
-  jetiValues[id].value = value;
-  if(jetiValues[id].varType != JETI_VART_14B)
-  {
-    jetiValues[id].varType = JETI_VART_14B;
-  }
+  setValue(id, value, JETI_VART_14B);
 
   return JETI_NO_ERROR;
 }
@@ -201,9 +217,8 @@ unsigned char jetiSetValueTime(unsigned char id, unsigned char hours, unsigned c
   value |= minutes << 8;
   value |= hours << 16;
 
-  jetiValues[id].value = value;
   jetiSetDecimalPoint(id, 0); //time
-  jetiValues[id].varType = JETI_VART_DATETIME;
+  setValue(id, value, JETI_VART_DATETIME);
 
   return JETI_NO_ERROR;
 }
@@ -231,9 +246,8 @@ unsigned char jetiSetValueDate(unsigned char id, unsigned char day, unsigned cha
   value |= month << 8;
   value |= day << 16;
 
-  jetiValues[id].value = value;
   jetiSetDecimalPoint(id, 1); //time
-  jetiValues[id].varType = JETI_VART_DATETIME;
+  setValue(id, value, JETI_VART_DATETIME);
 
   return JETI_NO_ERROR;
 }
@@ -266,8 +280,12 @@ unsigned char jetiSetTextDisplay(const char * text)
     }
   }
 
-  if(textChanged)
-    jetiTriggerTextSync = 1;
+  // latency is measured from the oldest change not sent yet
+  if(textChanged && !(jetiDirty & JETI_DIRTY_TEXT))
+  {
+    jetiDirty |= JETI_DIRTY_TEXT;
+    jetiTextChangedCycles = SysTimeCycles();
+  }
 
   return error;
 }
@@ -308,6 +326,7 @@ unsigned char jetiInitValue(unsigned char id, const char * description, const ch
   jetiValues[id].active = id + 1;
   memcpy(&jetiValues[id].name[0], description, descLength);
   memcpy(&jetiValues[id].unit[0], unit, unitLength);
+  jetiDirty |= JETI_DIRTY_SENSOR(id);
   jetiSetValue6B(id, 0);
   jetiSetDecimalPoint(id, 0);
 
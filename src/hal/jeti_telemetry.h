@@ -16,6 +16,9 @@
 
 #pragma once
 
+#include "context.h"
+#include <stdint.h>
+
 //JETI ERROR CODES
 //are returned by most functions and indicate parameter range problems.
 //In case of the JETI_ERROR_STRING_* return values the function executed anyway, but the string got truncated
@@ -106,9 +109,19 @@ extern void jetiSetKeyChanged(unsigned char key);
 //user function to check for a key change. Returns JETI_KEY_ value or 0 for no change
 extern unsigned char jetiCheckForKeyChange(void);
 
-extern unsigned char jetiName[10];
-extern struct JETI_VALUE jetiValues[15];
-extern unsigned char jetiDisplayText[33];
-extern unsigned char jetiAlarm;
-extern unsigned char jetiAlarmType;
-extern unsigned char jetiTriggerTextSync;
+extern CONTEXT_LOCAL unsigned char jetiName[10];
+extern CONTEXT_LOCAL struct JETI_VALUE jetiValues[15];
+extern CONTEXT_LOCAL unsigned char jetiDisplayText[33];
+extern CONTEXT_LOCAL unsigned char jetiAlarm;
+extern CONTEXT_LOCAL unsigned char jetiAlarmType;
+
+//items changed since they were last sent to the LL, see src/jeti_sync.h
+#define JETI_DIRTY_NAME       (1UL << 0)
+#define JETI_DIRTY_ALARM      (1UL << 1)
+#define JETI_DIRTY_TEXT       (1UL << 2)
+#define JETI_DIRTY_VALUES(id) (1UL << (3 + (id)/3)) //values are sent in groups of 3
+#define JETI_DIRTY_SENSOR(id) (1UL << (8 + (id)))   //active, name, unit, type and decimal point
+#define JETI_DIRTY_ALL        ((1UL << 23) - 1)
+
+extern CONTEXT_LOCAL uint32_t jetiDirty;
+extern CONTEXT_LOCAL uint32_t jetiTextChangedCycles; //SysTimeCycles() of the first unsent text change
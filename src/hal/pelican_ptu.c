@@ -22,14 +22,15 @@
 #include "../ll_hl_comm.h"
 #include "../sdkio.h"
 #include "LPC214x.h"
+#include "context.h"
 
-struct CAMERA_PTU CAMERA_ptu;
-struct CAMERA_COMMANDS CAMERA_Commands;
+CONTEXT_LOCAL struct CAMERA_PTU CAMERA_ptu;
+CONTEXT_LOCAL struct CAMERA_COMMANDS CAMERA_Commands;
 
-int PTU_cam_angle_roll_offset = 0;
-int PTU_cam_angle_pitch_offset = 0;
+CONTEXT_LOCAL int PTU_cam_angle_roll_offset = 0;
+CONTEXT_LOCAL int PTU_cam_angle_pitch_offset = 0;
 
-unsigned char PTU_enable_plain_ch7_to_servo = 0; // channel 7 is mapped plain to 1-2ms servo output
+CONTEXT_LOCAL unsigned char PTU_enable_plain_ch7_to_servo = 0; // channel 7 is mapped plain to 1-2ms servo output
 
 void PTU_init(void)
 {
@@ -56,81 +57,75 @@ void PTU_init(void)
 #endif
 }
 
-void PTU_update(void)
+void PTU_update(void) //called at 100Hz by the main loop scheduler
 {
-  static int ptu_cnt = 0;
-  if(++ptu_cnt > 9)	//generate 100Hz
+  if(PTU_enable_plain_ch7_to_servo)
   {
-    ptu_cnt = 0;
+    int value;
 
-    if(PTU_enable_plain_ch7_to_servo)
-    {
-      int value;
-
-      value = 88473 + (((int)sdk.ro.rc.channels[4] - 2048) * 29491) / 2048;
+    value = 88473 + (((int)sdk.ro.rc.channels[4] - 2048) * 29491) / 2048;
 
-      PWMMR5 = value;
-      PWMLER = LER5_EN | LER1_EN | LER2_EN;
+    PWMMR5 = value;
+    PWMLER = LER5_EN | LER1_EN | LER2_EN;
 
-      return;
-    }
+    return;
+  }
 
-    int angle_pitch, angle_roll;
+  int angle_pitch, angle_roll;
 
-    PTU_update_middle_positions_by_stick();
+  PTU_update_middle_positions_by_stick();
 
 #ifdef CAMMOUNT_XCONFIG	//rotate pitch/roll tiltcompensation for 45
 #ifndef CAM_FACING_FRONT_RIGHT
-    angle_pitch = sdk.ro.attitude.angle[1]*707/1000 + sdk.ro.attitude.angle[0]*707/1000;
-    angle_roll = sdk.ro.attitude.angle[0]*707/1000 - sdk.ro.attitude.angle[1]*707/1000;
+  angle_pitch = sdk.ro.attitude.angle[1]*707/1000 + sdk.ro.attitude.angle[0]*707/1000;
+  angle_roll = sdk.ro.attitude.angle[0]*707/1000 - sdk.ro.attitude.angle[1]*707/1000;
 #else
-    angle_roll = sdk.ro.attitude.angle[0] * 707 / 1000 + sdk.ro.attitude.angle[1] * 707 / 1000;
-    angle_pitch = -sdk.ro.attitude.angle[1] * 707 / 1000 + sdk.ro.attitude.angle[0] * 707 / 1000;
+  angle_roll = sdk.ro.attitude.angle[0] * 707 / 1000 + sdk.ro.attitude.angle[1] * 707 / 1000;
+  angle_pitch = -sdk.ro.attitude.angle[1] * 707 / 1000 + sdk.ro.attitude.angle[0] * 707 / 1000;
 #endif
 #else
-    angle_pitch = sdk.ro.attitude.angle[1];
-    angle_roll = sdk.ro.attitude.angle[0];
+  angle_pitch = sdk.ro.attitude.angle[1];
+  angle_roll = sdk.ro.attitude.angle[0];
 #endif
 
-    static int cam_angle_pitch = 0;
+  static CONTEXT_LOCAL int cam_angle_pitch = 0;
 #ifdef SET_CAMERA_ANGLE_INCREMENTAL
-    if(LL_1khz_attitude_data.RC_data[4]>192) cam_angle_pitch+=200;
-    else if(LL_1khz_attitude_data.RC_data[4]<64) cam_angle_pitch-=200;
-    if(cam_angle_pitch>55000) cam_angle_pitch=55000;
-    if(cam_angle_pitch<-55000) cam_angle_pitch=-55000;
+  if(LL_1khz_attitude_data.RC_data[4]>192) cam_angle_pitch+=200;
+  else if(LL_1khz_attitude_data.RC_data[4]<64) cam_angle_pitch-=200;
+  if(cam_angle_pitch>55000) cam_angle_pitch=55000;
+  if(cam_angle_pitch<-55000) cam_angle_pitch=-55000;
 #else
-    //example for camera to react on serial interface ON/OFF switch:
-    if(sdk.ro.rc.serialSwitch > 3000)
-      CAMERA_Commands.desired_angle_pitch = 90000;
-    else
-      CAMERA_Commands.desired_angle_pitch = 0;
-    //<-example
+  //example for camera to react on serial interface ON/OFF switch:
+  if(sdk.ro.rc.serialSwitch > 3000)
+    CAMERA_Commands.desired_angle_pitch = 90000;
+  else
+    CAMERA_Commands.desired_angle_pitch = 0;
+  //<-example
 
-    cam_angle_pitch = CAMERA_Commands.desired_angle_pitch;
-    if(cam_angle_pitch > 90000)
-      cam_angle_pitch = 90000;
-    else if(cam_angle_pitch < 0)
-      cam_angle_pitch = 0;
+  cam_angle_pitch = CAMERA_Commands.desired_angle_pitch;
+  if(cam_angle_pitch > 90000)
+    cam_angle_pitch = 90000;
+  else if(cam_angle_pitch < 0)
+    cam_angle_pitch = 0;
 #endif
 
-    if(CAMERA_Commands.status & 0x02)	//no tilt compensation
-    {
-      SERVO_pitch_move(
-          (CAMERA_OFFSET_HUMMINGBIRD_PITCH + cam_angle_pitch + PTU_cam_angle_pitch_offset)
-              * HUMMINGBIRD_SERVO_DIRECTION_PITCH);
-      SERVO_roll_move(
-          (CAMERA_OFFSET_HUMMINGBIRD_ROLL + CAMERA_Commands.desired_angle_roll + PTU_cam_angle_roll_offset)
-              * HUMMINGBIRD_SERVO_DIRECTION_ROLL);
-    }
-    else
-    {
-      SERVO_pitch_move(
-          (CAMERA_OFFSET_HUMMINGBIRD_PITCH + cam_angle_pitch + angle_pitch + PTU_cam_angle_pitch_offset)
-              * HUMMINGBIRD_SERVO_DIRECTION_PITCH);
-      SERVO_roll_move(
-          (CAMERA_OFFSET_HUMMINGBIRD_ROLL + CAMERA_Commands.desired_angle_roll + angle_roll + PTU_cam_angle_roll_offset)
-              * HUMMINGBIRD_SERVO_DIRECTION_ROLL);
-    }
+  if(CAMERA_Commands.status & 0x02)	//no tilt compensation
+  {
+    SERVO_pitch_move(
+        (CAMERA_OFFSET_HUMMINGBIRD_PITCH + cam_angle_pitch + PTU_cam_angle_pitch_offset)
+            * HUMMINGBIRD_SERVO_DIRECTION_PITCH);
+    SERVO_roll_move(
+        (CAMERA_OFFSET_HUMMINGBIRD_ROLL + CAMERA_Commands.desired_angle_roll + PTU_cam_angle_roll_offset)
+            * HUMMINGBIRD_SERVO_DIRECTION_ROLL);
+  }
+  else
+  {
+    SERVO_pitch_move(
+        (CAMERA_OFFSET_HUMMINGBIRD_PITCH + cam_angle_pitch + angle_pitch + PTU_cam_angle_pitch_offset)
+            * HUMMINGBIRD_SERVO_DIRECTION_PITCH);
+    SERVO_roll_move(
+        (CAMERA_OFFSET_HUMMINGBIRD_ROLL + CAMERA_Commands.desired_angle_roll + angle_roll + PTU_cam_angle_roll_offset)
+            * HUMMINGBIRD_SERVO_DIRECTION_ROLL);
   }
 }
 
@@ -171,8 +166,8 @@ void PTU_update_middle_positions_by_stick(void)
 #define THRESHOLD 300
   //set roll offset
   int roll_offset_inc = 0;
-  static unsigned char roll_offset_changed = 0;
-  static int reset_timeout_roll = 0;
+  static CONTEXT_LOCAL unsigned char roll_offset_changed = 0;
+  static CONTEXT_LOCAL int reset_timeout_roll = 0;
   if(!(sdk.ro.flightMode & FLIGHTMODE_FLYING)) //flying?
   {
     if(reset_timeout_roll)
@@ -221,8 +216,8 @@ void PTU_update_middle_positions_by_stick(void)
 
   //set pitch offset
   int pitch_offset_inc = 0;
-  static unsigned char pitch_offset_changed = 0;
-  static int reset_timeout_pitch;
+  static CONTEXT_LOCAL unsigned char pitch_offset_changed = 0;
+  static CONTEXT_LOCAL int reset_timeout_pitch;
   if(!(sdk.ro.flightMode & FLIGHTMODE_FLYING)) //flying?
   {
     if(reset_timeout_pitch)
@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include "context.h"
+
 #define HUMMINGBIRD_ROLL_SERVO	//generate roll servo output and use HL serial 0 TX for PWM 1
 #define HUMMINGBIRD_ROLL_SERVO_ON_SSEL0	//SSEL0 is used for Roll servo, serial 0 TX stays TX pin!
 #define CAMMOUNT_XCONFIG // turn roll/pitch commands for camera compensation by 45
@@ -35,11 +37,11 @@ void PTU_update_middle_positions_by_stick(void);
 void SERVO_pitch_move(int);
 void SERVO_roll_move(int);
 
-extern int PTU_cam_angle_roll_offset;
-extern int PTU_cam_angle_pitch_offset;
-extern unsigned char PTU_enable_plain_ch7_to_servo; // =1->channel 7 is mapped plain to 1-2ms servo output
+extern CONTEXT_LOCAL int PTU_cam_angle_roll_offset;
+extern CONTEXT_LOCAL int PTU_cam_angle_pitch_offset;
+extern CONTEXT_LOCAL unsigned char PTU_enable_plain_ch7_to_servo; // =1->channel 7 is mapped plain to 1-2ms servo output
 
-extern unsigned char PTU_cam_option_4_version;
+extern CONTEXT_LOCAL unsigned char PTU_cam_option_4_version;
 
 //Pan Tilt Unit Data
 struct CAMERA_PTU
@@ -57,7 +59,7 @@ struct CAMERA_PTU
   int servo_roll_max;
 };
 
-extern struct CAMERA_PTU CAMERA_ptu;
+extern CONTEXT_LOCAL struct CAMERA_PTU CAMERA_ptu;
 
 struct CAMERA_COMMANDS
 {
@@ -67,4 +69,4 @@ struct CAMERA_COMMANDS
   int desired_angle_roll;
 };
 
-extern struct CAMERA_COMMANDS CAMERA_Commands;
+extern CONTEXT_LOCAL struct CAMERA_COMMANDS CAMERA_Commands;
@@ -19,6 +19,8 @@
 #include "ssp.h"
 
 #include "../ll_hl_comm.h"
+#include "../irq_stats.h"
+#include "context.h"
 
 /* SPI read and write buffer size */
 #define FIFOSIZE  8
@@ -65,14 +67,25 @@
 #define SSPICR_RORIC  1 << 0
 #define SSPICR_RTIC 1 << 1
 
-static char SPIWRData[128];
-static int CurrentTxIndex;
-static unsigned int SPIWR_num_bytes;
+#define SSP_TX_NONE 0xFF
+#define SSP_TX_IDLE (SSP_TX_FRAME_WORDS + 1)
 
-volatile uint8_t SSPDataSentToLL = 1;
+// Two framed Tx buffers. The interrupt shifts out txActive and switches to
+// txPending at the end of a frame, the main loop only writes to the other one.
+static CONTEXT_LOCAL uint16_t txFrames[2][SSP_TX_FRAME_WORDS] = {
+  { '>' | ('*' << 8) },
+  { '>' | ('*' << 8) },
+};
+static CONTEXT_LOCAL volatile uint8_t txActive;
+static CONTEXT_LOCAL volatile uint8_t txPending = SSP_TX_NONE;
+static CONTEXT_LOCAL volatile uint8_t txIndex = SSP_TX_IDLE; // next word of txActive
+
+CONTEXT_LOCAL SSPTxStats sspTxStats;
 
 void SSPHandler() __irq
 {
+  IRQ_STATS_ENTER(IRQ_STATS_SSP);
+
   int regValue;
   unsigned short input_data;
 
@@ -95,32 +108,41 @@ void SSPHandler() __irq
     {
       input_data = SSPDR;
 
-      SSP_rx_handler_HL(input_data & 0xFF);
-      SSP_rx_handler_HL(input_data >> 8);
+      SSP_rx_handler_HL(input_data);
 
     }
   }
 
   if(regValue & SSPMIS_TXMIS) /* Tx at least half empty */
   {
+    uint8_t index = txIndex;
+
     /* transmit until it's full */
     while((SSPSR & SSPSR_TNF))
     {
-      if(CurrentTxIndex < SPIWR_num_bytes)
+      if(index == SSP_TX_IDLE && txPending != SSP_TX_NONE)
+      {
+        txActive = txPending;
+        txPending = SSP_TX_NONE;
+        index = 0;
+      }
+
+      if(index < SSP_TX_FRAME_WORDS)
       {
-        SSPDR = SPIWRData[CurrentTxIndex] | (SPIWRData[CurrentTxIndex + 1] << 8);
-        CurrentTxIndex += 2;
+        SSPDR = txFrames[txActive][index++];
       }
       else
       {
-        CurrentTxIndex = 0;
-        SPIWR_num_bytes = 0;
-        SSPDataSentToLL = 1;
+        // one zero word separates back to back frames
         SSPDR = 0;
+        index = SSP_TX_IDLE;
       }
     }
+
+    txIndex = index;
   }
 
+  IRQ_STATS_EXIT(IRQ_STATS_SSP);
   IDISABLE;
   VICVectAddr = 0; /* Acknowledge Interrupt */
 }
@@ -157,43 +179,53 @@ void SSPInitIRQ()
   SSPCR1 |= SSPCR1_SSE;
 }
 
-void SSPWriteToLL(uint8_t page, uint8_t* dataptr)
+uint8_t SSPTxPending(void)
+{
+  return txPending != SSP_TX_NONE;
+}
+
+uint8_t SSPWriteToLL(uint8_t page, uint8_t* dataptr)
 {
-  uint16_t i;
-  uint16_t spi_chksum;
+  // LL_CONTROL_INPUT is word aligned: page 0 sends words 0..18, page 1 words 0..9 and 19..27
+  const uint16_t* pSrc = (const uint16_t*)dataptr;
+  const uint16_t* pPage = pSrc + (page ? 19 : 10);
+  uint32_t sum = 0;
+  uint32_t sumHigh = 0;
+
+  // only the interrupt clears txPending, so a free buffer stays free
+  if(txPending != SSP_TX_NONE)
+  {
+    ++sspTxStats.skipped;
+    return 1;
+  }
 
-  //initialize syncbytes
-  SPIWRData[0] = '>';
-  SPIWRData[1] = '*';
+  ++sspTxStats.frames;
+  if(txIndex != SSP_TX_IDLE)
+    ++sspTxStats.queued;
 
-  spi_chksum = 0xAAAA;
+  uint8_t buffer = txActive ^ 1;
+  uint16_t* pDst = &txFrames[buffer][1];
 
-  if(!page)
+  for(uint8_t i = 0; i < 10; i++)
   {
-    for(i = 2; i < 40; i++)
-    {
-      SPIWRData[i] = *dataptr++;
-      spi_chksum += SPIWRData[i];
-    }
+    uint16_t word = pSrc[i];
+    sum += word;
+    sumHigh += word >> 8;
+    *pDst++ = word;
   }
-  else
+
+  for(uint8_t i = 0; i < 9; i++)
   {
-    for(i = 2; i < 22; i++)
-    {
-      SPIWRData[i] = *dataptr++;
-      spi_chksum += SPIWRData[i];
-    }
-    dataptr += 18;
-    for(i = 22; i < 40; i++)
-    {
-      SPIWRData[i] = *dataptr++;
-      spi_chksum += SPIWRData[i];
-    }
+    uint16_t word = pPage[i];
+    sum += word;
+    sumHigh += word >> 8;
+    *pDst++ = word;
   }
 
-  SPIWRData[40] = spi_chksum; //chksum LSB
-  SPIWRData[41] = (spi_chksum >> 8); //chksum MSB
+  // sum of all bytes: each word is low + 256*high
+  *pDst = 0xAAAA + sum - 255*sumHigh;
+
+  txPending = buffer;
 
-  SPIWR_num_bytes = 42;
-  SSPDataSentToLL = 0;
+  return 0;
 }
@@ -17,11 +17,33 @@
 #pragma once
 
 #include <stdint.h>
+#include "context.h"
 
 void SSPHandler();
 void SSPInit();
 void SSPInitIRQ();
 
-void SSPWriteToLL(uint8_t page, uint8_t* dataptr);
+// Frames to the LL are double buffered: '>' '*', 19 data words and the checksum.
+// SSPWriteToLL() packs the page into the buffer that is not shifted out and
+// queues it. The interrupt starts it at once, or after the current frame and one
+// zero word, so a write while the previous frame is still shifting out is sent
+// right after it instead of being skipped. A queued frame that has not started
+// yet is never replaced: it already carries one-shot content (slow channel slot,
+// Jeti command, page), so the caller checks SSPTxPending() before it fills the
+// next one.
+#define SSP_TX_FRAME_WORDS 21
 
-extern volatile uint8_t SSPDataSentToLL;
+typedef struct _SSPTxStats
+{
+  uint32_t frames;            // frames written
+  uint32_t queued;            // previous frame was still shifting out
+  uint32_t skipped;           // writes refused, a queued frame had not started
+} SSPTxStats;
+
+extern CONTEXT_LOCAL SSPTxStats sspTxStats;
+
+// 1 while a written frame waits for the current one to go out
+uint8_t SSPTxPending(void);
+
+// Returns 1 without writing if a frame is still pending.
+uint8_t SSPWriteToLL(uint8_t page, uint8_t* dataptr);
@@ -17,16 +17,21 @@
 #include "sys_time.h"
 #include "../LPC214x.h"
 #include "../win_arm/irq.h"
+#include "context.h"
+#include "irq_stats.h"
 
-volatile int64_t sysTimeLong;
+CONTEXT_LOCAL volatile uint32_t sysTimeSeconds;
 
 static void timer1IRQ(void) __irq
 {
+  IRQ_STATS_ENTER(IRQ_STATS_TIMER1);
+
   T1IR = 0x01;      //Clear the timer 1 interrupt
   IENABLE;
 
-  sysTimeLong += 1000000;
+  ++sysTimeSeconds;
 
+  IRQ_STATS_EXIT(IRQ_STATS_TIMER1);
   IDISABLE;
   VICVectAddr = 0;    // Acknowledge Interrupt
 }
@@ -47,10 +52,45 @@ void SysTimeInitIRQ()
   install_irq(TIMER1_INT, (void *)timer1IRQ);
 }
 
+void SysTimeCapture(SysTimeStamp* pStamp)
+{
+  uint32_t seconds;
+  uint32_t cycles;
+
+  do
+  {
+    seconds = sysTimeSeconds;
+    cycles = T1TC;
+
+    // wrapped, but the interrupt did not run yet (IRQs disabled or in a handler).
+    // A small T1TC was read after the wrap, a large one before it.
+    if((T1IR & 0x01) && cycles < CPU_CLOCK_HZ/2)
+      pStamp->seconds = seconds + 1;
+    else
+      pStamp->seconds = seconds;
+  }
+  while(seconds != sysTimeSeconds); // timer 1 interrupt in between
+
+  pStamp->cycles = cycles;
+}
+
+int64_t SysTimeStampToUSec(const SysTimeStamp* pStamp)
+{
+  return (int64_t)pStamp->seconds*1000000 + SysTimeCyclesToUSec(pStamp->cycles);
+}
+
 int64_t SysTimeLongUSec()
 {
-  int64_t time = sysTimeLong;
-  int64_t timer = T1TC;
+  SysTimeStamp stamp;
+  SysTimeCapture(&stamp);
+
+  return SysTimeStampToUSec(&stamp);
+}
+
+uint32_t SysTimeCycles(void)
+{
+  SysTimeStamp stamp;
+  SysTimeCapture(&stamp);
 
-  return time + (timer*1000000)/CPU_CLOCK_HZ;
+  return stamp.seconds*CPU_CLOCK_HZ + stamp.cycles;
 }
@@ -20,6 +20,51 @@
 
 #define CPU_CLOCK_HZ 58982400UL
 
+// Timer 1 counts CPU cycles and resets every second (T1TC < CPU_CLOCK_HZ), its
+// interrupt counts the seconds.
+
+typedef struct _SysTimeStamp
+{
+  uint32_t seconds;
+  uint32_t cycles;    // T1TC
+} SysTimeStamp;
+
 void SysTimeInit();
 void SysTimeInitIRQ();
+
+// Consistent seconds and T1TC without locking. Safe in the main loop and in
+// interrupt handlers, also when the timer 1 interrupt is still pending.
+void SysTimeCapture(SysTimeStamp* pStamp);
+
+// us since boot, monotonic
 int64_t SysTimeLongUSec();
+int64_t SysTimeStampToUSec(const SysTimeStamp* pStamp);
+
+// CPU cycles since boot modulo 2^32 for hot paths, differences are valid up to 72s
+uint32_t SysTimeCycles(void);
+
+// x/9 for all 32 bit x, one UMULL
+static inline uint32_t sysTimeDiv9(uint32_t x)
+{
+  return ((uint64_t)x*0x38E38E39UL) >> 33;
+}
+
+// cycles*1000000/CPU_CLOCK_HZ = cycles*625/(9*4096) without division,
+// bit exact for all 32 bit cycles
+static inline uint32_t SysTimeCyclesToUSec(uint32_t cycles)
+{
+  uint32_t high = cycles >> 12;
+  uint32_t blocks = sysTimeDiv9(high);  // 36864 cycles = 625us each
+  uint32_t rest = ((high - 9*blocks) << 12) | (cycles & 4095);
+
+  return blocks*625 + (sysTimeDiv9(rest*625) >> 12);
+}
+
+// cycles from one T1TC reading to a later one less than a second apart
+static inline uint32_t SysTimeCyclesBetween(uint32_t start, uint32_t end)
+{
+  if(end < start)
+    end += CPU_CLOCK_HZ;
+
+  return end - start;
+}
@@ -25,6 +25,7 @@
 #include "uart1.h"
 #include "sys_time.h"
 #include "../config.h"
+#include "../irq_stats.h"
 
 #define EXT_NCS 7   //CS outputs on P0
 
@@ -57,6 +58,10 @@ void init(void)
 
 void IRQInit(void)
 {
+#if IRQ_STATS_ENABLE
+  IRQStatsReset();
+#endif
+
   init_VIC();
 
   //Timer0 interrupt
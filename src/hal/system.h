@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include "context.h"
+
 // PWM defines
 #define PWM_CYCLE   1200
 #define PWM_OFFSET    200
@@ -84,4 +86,4 @@ struct HL_STATUS
   short cpu_load;
 };
 
-extern struct HL_STATUS HL_Status;
+extern CONTEXT_LOCAL struct HL_STATUS HL_Status;
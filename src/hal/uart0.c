@@ -19,11 +19,16 @@
 #include "LPC214x.h"
 #include "irq.h"
 #include "system.h"
+#include "capture.h"
+#include "irq_stats.h"
+#include "context.h"
 
-UART0Data uart0;
+CONTEXT_LOCAL UART0Data uart0;
 
 static void uart0IRQ(void) __irq
 {
+  IRQ_STATS_ENTER(IRQ_STATS_UART0);
+
   // Read IIR to clear interrupt and find out the cause
   IENABLE;
   uint32_t iir = U0IIR;
@@ -53,7 +58,10 @@ static void uart0IRQ(void) __irq
     {
       // RDA interrupt
       uint8_t c = U0RBR;
+      CAPTURE_BYTE(CAPTURE_SRC_UART0, c);
       FifoPut(&uart0.rxFifo, c);
+      if(c == 0)
+        ++uart0.rxDelimiters;
     }
     break;
     case 3:
@@ -63,6 +71,7 @@ static void uart0IRQ(void) __irq
       // CTI interrupt (disabled)
       break;
   }
+  IRQ_STATS_EXIT(IRQ_STATS_UART0);
   IDISABLE;
   VICVectAddr = 0;    // Acknowledge Interrupt
 }
@@ -18,6 +18,7 @@
 
 #include <stdint.h>
 #include "util/fifo.h"
+#include "context.h"
 
 #define UART0_BUFFER_SIZE 1024
 
@@ -28,9 +29,11 @@ typedef struct _UART0Data
 
   Fifo txFifo;
   Fifo rxFifo;
+
+  volatile uint16_t rxDelimiters; // received 0 bytes, the ExtCom frame delimiter
 } UART0Data;
 
-extern UART0Data uart0;
+extern CONTEXT_LOCAL UART0Data uart0;
 
 void UART0Init(uint32_t baud);
 void UART0InitIRQ();
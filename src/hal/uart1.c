@@ -23,6 +23,7 @@
 #include "string.h"
 #include "../sdkio.h"
 #include "uart1.h"
+#include "irq_stats.h"
 
 #define RBREAD 0
 #define RBWRITE 1
@@ -30,6 +31,7 @@
 
 static void uart1IRQ(void) __irq
 {
+  IRQ_STATS_ENTER(IRQ_STATS_UART1);
   IENABLE;
   uint32_t iir = U1IIR;
   // Handle UART interrupt
@@ -49,6 +51,7 @@ static void uart1IRQ(void) __irq
       // CTI interrupt (disabled)
       break;
   }
+  IRQ_STATS_EXIT(IRQ_STATS_UART1);
   IDISABLE;
   VICVectAddr = 0; // Acknowledge Interrupt
 }
@@ -19,6 +19,10 @@
 #include "util/gpsmath.h"
 #include "ublox.h"
 #include "uart1.h"
+#include "capture.h"
+#include "sys_time.h"
+#include "context.h"
+#include <string.h>
 
 // used by: uBloxReceiveEngine
 #define UR_MAX_RETRYS 80
@@ -119,21 +123,24 @@ const unsigned char urCfgGNSS[] =
 const unsigned char urCfgPwr[] =
   { 0x09, 0x00 };
 
-GPSData gps = {
+CONTEXT_LOCAL GPSData gps = {
   .version = UBX_UNKNOWN,
 };
 
-static unsigned int urTimeCnt = 0;
-static volatile unsigned char urAckReceived = 0;
-static volatile unsigned char urAckClass = 0;
-static volatile unsigned char urAckId = 0;
-static unsigned char urConfigCnt;
-static unsigned char * urCfgIdList;
-static volatile unsigned char urConfigMessageReceived = 0;
-static volatile unsigned char urVersionCheck = 0;
-static unsigned char urRecData[UR_MAX_DATA_LENGTH];
-static unsigned char urEngineState = URES_IDLE;
-static unsigned short urMsgCnt = 0;
+static CONTEXT_LOCAL unsigned int urTimeCnt = 0;
+static CONTEXT_LOCAL volatile unsigned char urAckReceived = 0;
+static CONTEXT_LOCAL volatile unsigned char urAckClass = 0;
+static CONTEXT_LOCAL volatile unsigned char urAckId = 0;
+static CONTEXT_LOCAL unsigned char urConfigCnt;
+static CONTEXT_LOCAL unsigned char * urCfgIdList;
+static CONTEXT_LOCAL volatile unsigned char urConfigMessageReceived = 0;
+static CONTEXT_LOCAL volatile unsigned char urVersionCheck = 0;
+static CONTEXT_LOCAL unsigned char urRecData[UR_MAX_DATA_LENGTH];
+static CONTEXT_LOCAL unsigned char urEngineState = URES_IDLE;
+static CONTEXT_LOCAL unsigned short urMsgCnt = 0;
+static CONTEXT_LOCAL SysTimeStamp urStamp; // sync byte of the current message
+static CONTEXT_LOCAL unsigned int urNavITow = 0xFFFFFFFF;
+static CONTEXT_LOCAL int64_t urNavEpochUs = 0;
 
 static void sendMessage(unsigned char urClass, unsigned char urId, unsigned char * urData, unsigned char urLength)
 {
@@ -206,9 +213,7 @@ static void resetConfiguration(void)
 
 static void handleMessage(unsigned char urClass, unsigned char urId, unsigned char * urData, unsigned short urLength)
 {
-  (void)urLength;
-
-  static int sacc_filter = 0;
+  static CONTEXT_LOCAL int sacc_filter = 0;
 
   urMsgCnt++;
 
@@ -216,6 +221,17 @@ static void handleMessage(unsigned char urClass, unsigned char urId, unsigned ch
   {
     case 0x01:
     {
+      // all NAV messages of one solution share iTow, the first one to arrive dates it
+      unsigned int iTow = urNavITow;
+      if(urLength >= sizeof(iTow))
+        memcpy(&iTow, urData, sizeof(iTow));
+
+      if(iTow != urNavITow)
+      {
+        urNavITow = iTow;
+        urNavEpochUs = SysTimeStampToUSec(&urStamp);
+      }
+
       switch(urId)
       {
         case 0x02: //NAV-POSLLH
@@ -262,6 +278,7 @@ static void handleMessage(unsigned char urClass, unsigned char urId, unsigned ch
             gps.status &= ~0x03;
             gps.data.hasLock = 0;
           }
+          gps.data.timestampUs = urNavEpochUs;
           gps.newForLL = 1;
           gps.dataUpdated = 1;
           GPS_timeout = 0;
@@ -342,20 +359,25 @@ static void handleMessage(unsigned char urClass, unsigned char urId, unsigned ch
 
 void uBloxReceiveHandler(unsigned char recByte)
 {
-  static unsigned char urState = URS_SYNC1;
-  static unsigned char urClass;
-  static unsigned char urId;
-  static unsigned short urLength;
-  static unsigned short urCnt = 0;
-  static unsigned char urCkARec, urCkBRec;
-  static unsigned char urCkA, urCkB;
+  static CONTEXT_LOCAL unsigned char urState = URS_SYNC1;
+  static CONTEXT_LOCAL unsigned char urClass;
+  static CONTEXT_LOCAL unsigned char urId;
+  static CONTEXT_LOCAL unsigned short urLength;
+  static CONTEXT_LOCAL unsigned short urCnt = 0;
+  static CONTEXT_LOCAL unsigned char urCkARec, urCkBRec;
+  static CONTEXT_LOCAL unsigned char urCkA, urCkB;
+
+  CAPTURE_BYTE(CAPTURE_SRC_GPS, recByte);
 
   switch(urState)
   {
     case URS_SYNC1:
     {
       if(recByte == 0xB5)
+      {
+        SysTimeCapture(&urStamp);
         urState = URS_SYNC2;
+      }
     }
     break;
     case URS_SYNC2:
@@ -457,13 +479,13 @@ void uBloxReceiveHandler(unsigned char recByte)
 
 void uBloxReceiveEngine(void)
 {
-  static unsigned char urTimeOut;
-  static unsigned char urReconfigurationRetries = UR_MAX_RETRYS;
-  static unsigned int currentBaudrate = 115200;
-  static unsigned short startup_timeout = 400;
+  static CONTEXT_LOCAL unsigned char urTimeOut;
+  static CONTEXT_LOCAL unsigned char urReconfigurationRetries = UR_MAX_RETRYS;
+  static CONTEXT_LOCAL unsigned int currentBaudrate = 115200;
+  static CONTEXT_LOCAL unsigned short startup_timeout = 400;
   const unsigned int baudrateList[MAX_BR_CNT] =
     { 9600, 57600, 115200 };
-  static unsigned char baudrateCnt = 0;
+  static CONTEXT_LOCAL unsigned char baudrateCnt = 0;
   int i;
 
   urTimeCnt++;
@@ -17,6 +17,7 @@
 #pragma once
 
 #include <stdint.h>
+#include "context.h"
 
 #pragma pack(push,1)
 
@@ -190,6 +191,7 @@ typedef struct _GPSRawData
   uint16_t speedAccuracy; // [mm/s]
   uint16_t numSatellites;
   uint8_t hasLock;
+  int64_t timestampUs; // arrival of the first NAV message of this solution [us since boot]
 } GPSRawData;
 
 typedef struct _GPSTime
@@ -209,7 +211,7 @@ typedef struct _GPSData
   GPSTime time;
 } GPSData;
 
-extern GPSData gps;
+extern CONTEXT_LOCAL GPSData gps;
 
 void uBloxReceiveHandler(unsigned char recByte);
 void uBloxReceiveEngine(void); //call with 200ms
@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2017 Intel Deutschland GmbH, Germany
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "irq_stats.h"
+
+#if IRQ_STATS_ENABLE
+
+#include "LPC214x.h"
+#include "irq.h"
+#include "hal/sys_time.h"
+#include <string.h>
+
+#define IRQ_STATS_NOT_PENDING 0xFFFFFFFF
+
+CONTEXT_LOCAL IRQStats irqStats;
+
+static const uint8_t vicChannel[IRQ_STATS_NUM] = {
+  TIMER0_INT, TIMER1_INT, UART0_INT, UART1_INT, SPI1_INT, I2C0_INT, I2C1_INT
+};
+
+static const char* const irqNames[IRQ_STATS_NUM] = IRQ_STATS_NAMES;
+
+#define VIC_MASK ((1UL << TIMER0_INT) | (1UL << TIMER1_INT) | (1UL << UART0_INT) | (1UL << UART1_INT) \
+    | (1UL << SPI1_INT) | (1UL << I2C0_INT) | (1UL << I2C1_INT))
+
+static inline void histAdd(uint16_t* pHist, uint32_t cycles)
+{
+  uint8_t bucket = cycles ? 31 - __builtin_clz(cycles) : 0;
+
+  if(bucket >= IRQ_STATS_BUCKETS)
+    bucket = IRQ_STATS_BUCKETS - 1;
+
+  if(pHist[bucket] == 0xFFFF)
+  {
+    for(uint8_t i = 0; i < IRQ_STATS_BUCKETS; i++)
+      pHist[i] >>= 1;
+  }
+
+  ++pHist[bucket];
+}
+
+// stamp all other sources waiting behind the running handler
+static void markPending(uint8_t self, uint32_t stamp)
+{
+  uint32_t raw = VICRawIntr & VICIntEnable & VIC_MASK & ~(1UL << vicChannel[self]);
+
+  if(!raw)
+    return;
+
+  for(uint8_t i = 0; i < IRQ_STATS_NUM; i++)
+  {
+    if((raw & (1UL << vicChannel[i])) && irqStats.pendingSince[i] == IRQ_STATS_NOT_PENDING)
+      irqStats.pendingSince[i] = stamp;
+  }
+}
+
+void IRQStatsReset(void)
+{
+  memset(irqStats.irq, 0, sizeof(irqStats.irq));
+
+  for(uint8_t i = 0; i < IRQ_STATS_NUM; i++)
+    irqStats.pendingSince[i] = IRQ_STATS_NOT_PENDING;
+}
+
+uint32_t IRQStatsEnter(uint8_t irq)
+{
+  TRACE_ISR(TRACE_EV_IRQ_ENTER, irq);
+
+  uint32_t now = T1TC;
+  uint32_t latency;
+
+  if(irq == IRQ_STATS_TIMER0)
+    latency = T0TC;
+  else if(irq == IRQ_STATS_TIMER1)
+    latency = now;
+  else if(irqStats.pendingSince[irq] != IRQ_STATS_NOT_PENDING)
+    latency = SysTimeCyclesBetween(irqStats.pendingSince[irq], now);
+  else
+    latency = 0;
+
+  irqStats.pendingSince[irq] = IRQ_STATS_NOT_PENDING;
+
+  IRQStatsEntry* pEntry = &irqStats.irq[irq];
+
+  if(latency > pEntry->maxLatencyCycles)
+    pEntry->maxLatencyCycles = latency;
+
+  histAdd(pEntry->latency, latency);
+
+  markPending(irq, now);
+
+  return now;
+}
+
+void IRQStatsExit(uint8_t irq, uint32_t entryCycles)
+{
+  uint32_t duration = SysTimeCyclesBetween(entryCycles, T1TC);
+  IRQStatsEntry* pEntry = &irqStats.irq[irq];
+
+  ++pEntry->count;
+
+  if(duration > pEntry->maxDurationCycles)
+    pEntry->maxDurationCycles = duration;
+
+  histAdd(pEntry->duration, duration);
+
+  markPending(irq, entryCycles);
+
+  TRACE_ISR(TRACE_EV_IRQ_EXIT, irq);
+}
+
+const char* IRQStatsName(uint8_t irq)
+{
+  if(irq >= IRQ_STATS_NUM)
+    return 0;
+
+  return irqNames[irq];
+}
+
+#endif
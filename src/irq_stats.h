@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2017 Intel Deutschland GmbH, Germany
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "config.h"
+#include "context.h"
+#include "trace.h"
+#include <stdint.h>
+
+// Entry latency and execution time of every interrupt handler.
+// Handlers call IRQ_STATS_ENTER() first and IRQ_STATS_EXIT() last, both
+// timestamp with timer 1 (CPU cycles). Histogram bucket n counts times of
+// [2^n, 2^(n+1)) cycles, bucket 0 includes 0 and the last bucket everything
+// above. A bucket about to overflow halves its histogram.
+//
+// Latency of the timer interrupts is exact, their counter is reset by the
+// match that raises the interrupt. Other sources have no hardware timestamp:
+// a source seen pending in the VIC at entry or exit of another handler gets
+// that handler's entry time, so its latency is an upper bound. A source that
+// is not seen pending counts as 0 (VIC and core latency only).
+//
+// Both macros also emit TRACE_EV_IRQ_ENTER/EXIT, with or without the histograms.
+
+#define IRQ_STATS_TIMER0 0
+#define IRQ_STATS_TIMER1 1
+#define IRQ_STATS_UART0  2
+#define IRQ_STATS_UART1  3
+#define IRQ_STATS_SSP    4
+#define IRQ_STATS_I2C0   5
+#define IRQ_STATS_I2C1   6
+#define IRQ_STATS_NUM    7
+
+#define IRQ_STATS_NAMES { "timer0", "timer1", "uart0", "uart1", "ssp", "i2c0", "i2c1" }
+
+#define IRQ_STATS_BUCKETS 16
+
+typedef struct _IRQStatsEntry
+{
+  uint32_t count;
+  uint32_t maxLatencyCycles;
+  uint32_t maxDurationCycles;
+  uint16_t latency[IRQ_STATS_BUCKETS];
+  uint16_t duration[IRQ_STATS_BUCKETS];
+} IRQStatsEntry;
+
+typedef struct _IRQStats
+{
+  uint32_t pendingSince[IRQ_STATS_NUM];   // timer 1 value, IRQ_STATS_NOT_PENDING if not seen
+  IRQStatsEntry irq[IRQ_STATS_NUM];
+} IRQStats;
+
+#if IRQ_STATS_ENABLE
+
+extern CONTEXT_LOCAL IRQStats irqStats;
+
+void IRQStatsReset(void);
+
+// return/take the entry timestamp
+uint32_t IRQStatsEnter(uint8_t irq);
+void IRQStatsExit(uint8_t irq, uint32_t entryCycles);
+
+const char* IRQStatsName(uint8_t irq);
+
+#define IRQ_STATS_ENTER(irq) uint32_t irqStatsEntry = IRQStatsEnter(irq)
+#define IRQ_STATS_EXIT(irq) IRQStatsExit(irq, irqStatsEntry)
+
+#else
+
+#define IRQ_STATS_ENTER(irq) TRACE_ISR(TRACE_EV_IRQ_ENTER, irq)
+#define IRQ_STATS_EXIT(irq) TRACE_ISR(TRACE_EV_IRQ_EXIT, irq)
+
+#endif
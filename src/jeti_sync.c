@@ -0,0 +1,208 @@
+/*
+ * Copyright (C) 2017 Intel Deutschland GmbH, Germany
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jeti_sync.h"
+#include "main.h"
+#include "hal/jeti_telemetry.h"
+#include "hal/sys_time.h"
+#include "config.h"
+#include <string.h>
+
+CONTEXT_LOCAL JetiSync jetiSync;
+
+#define ITEM_NAME   0
+#define ITEM_ALARM  1
+#define ITEM_TEXT   2
+#define ITEM_VALUES 3 // 5 groups of 3 values
+#define ITEM_SENSOR 8 // 15 sensors
+
+void JetiSyncInit(void)
+{
+  memset(&jetiSync, 0, sizeof(JetiSync));
+  jetiDirty = JETI_DIRTY_ALL;
+}
+
+static void fillSecondPart(struct LL_CONTROL_INPUT* pCtrl, uint8_t item)
+{
+  if(item == ITEM_TEXT)
+  {
+    pCtrl->status = PD_JETI_SETTEXT2;
+    memcpy(&pCtrl->latitude, &jetiDisplayText[16], 4);
+    memcpy(&pCtrl->longitude, &jetiDisplayText[20], 4);
+    memcpy(&pCtrl->height, &jetiDisplayText[24], 4);
+    memcpy(&pCtrl->speed_x, &jetiDisplayText[28], 2);
+    memcpy(&pCtrl->speed_y, &jetiDisplayText[30], 2);
+
+    if(jetiSync.textTimed)
+    {
+      uint32_t us = SysTimeCyclesToUSec(SysTimeCycles() - jetiTextChangedCycles);
+
+      ++jetiSync.stat.textUpdates;
+      jetiSync.stat.textLatencySumUs += us;
+      if(us > jetiSync.stat.textLatencyMaxUs)
+        jetiSync.stat.textLatencyMaxUs = us;
+    }
+  }
+  else
+  {
+    const struct JETI_VALUE* pValue = &jetiValues[item - ITEM_SENSOR];
+
+    pCtrl->status = PD_JETI_SETSENSOR2;
+    pCtrl->height = pValue->active;
+    memcpy(&pCtrl->latitude, &pValue->unit[0], 4);
+    pCtrl->speed_x = pValue->unit[4];
+    pCtrl->speed_y = pValue->varType;
+    pCtrl->longitude = pValue->value;
+  }
+}
+
+static void fillItem(struct LL_CONTROL_INPUT* pCtrl, uint8_t item)
+{
+  if(item == ITEM_NAME)
+  {
+    pCtrl->status = PD_JETI_SETNAME;
+    memcpy(&pCtrl->latitude, &jetiName[0], 4);
+    memcpy(&pCtrl->longitude, &jetiName[4], 4);
+    memcpy(&pCtrl->speed_x, &jetiName[8], 2);
+  }
+  else if(item == ITEM_ALARM)
+  {
+    pCtrl->status = PD_JETI_SETALARM;
+    pCtrl->speed_x = jetiAlarm;
+    pCtrl->speed_y = jetiAlarmType;
+  }
+  else if(item == ITEM_TEXT)
+  {
+    pCtrl->status = PD_JETI_SETTEXT;
+    memcpy(&pCtrl->latitude, &jetiDisplayText[0], 4);
+    memcpy(&pCtrl->longitude, &jetiDisplayText[4], 4);
+    memcpy(&pCtrl->height, &jetiDisplayText[8], 4);
+    memcpy(&pCtrl->speed_x, &jetiDisplayText[12], 2);
+    memcpy(&pCtrl->speed_y, &jetiDisplayText[14], 2);
+    jetiSync.part2 = item;
+  }
+  else if(item < ITEM_SENSOR)
+  {
+    uint8_t group = item - ITEM_VALUES;
+    const struct JETI_VALUE* pValue = &jetiValues[3*group];
+
+    pCtrl->status = PD_JETI_UPDATESDATA;
+    pCtrl->height = group;
+    pCtrl->latitude = pValue[0].value;
+    pCtrl->longitude = pValue[1].value;
+    memcpy(&pCtrl->speed_y, ((unsigned char *)&pValue[2].value) + 2, 2);
+    memcpy(&pCtrl->speed_x, &pValue[2].value, 2);
+    jetiSync.valueSlot[group] = jetiSync.stat.slots;
+  }
+  else
+  {
+    const struct JETI_VALUE* pValue = &jetiValues[item - ITEM_SENSOR];
+
+    pCtrl->status = PD_JETI_SETSENSOR;
+    pCtrl->height = pValue->active;
+    memcpy(&pCtrl->latitude, &pValue->name[0], 4);
+    memcpy(&pCtrl->longitude, &pValue->name[4], 4);
+    memcpy(&pCtrl->speed_x, &pValue->name[8], 2);
+    pCtrl->speed_y = pValue->decPoint;
+    jetiSync.part2 = item;
+  }
+}
+
+// next changed item that may be sent now, JETI_SYNC_ITEMS if there is none
+static uint8_t nextItem(void)
+{
+  if(jetiDirty & JETI_DIRTY_ALARM)
+    return ITEM_ALARM;
+
+  if((jetiDirty & JETI_DIRTY_TEXT) || jetiSync.refreshText)
+    return ITEM_TEXT;
+
+  uint8_t item = jetiSync.next;
+
+  for(uint8_t n = 0; n < JETI_SYNC_ITEMS; n++, item++)
+  {
+    if(item == JETI_SYNC_ITEMS)
+      item = 0;
+
+    if(!(jetiDirty & (1UL << item)))
+      continue;
+
+    if(item >= ITEM_SENSOR)
+    {
+      // inactive sensors are not sent
+      if(!jetiValues[item - ITEM_SENSOR].active)
+      {
+        jetiDirty &= ~(1UL << item);
+        continue;
+      }
+    }
+    else if(item >= ITEM_VALUES)
+    {
+      if(jetiSync.stat.slots - jetiSync.valueSlot[item - ITEM_VALUES] < JETI_SYNC_VALUE_SLOTS)
+        continue;
+    }
+
+    jetiSync.next = item + 1;
+    return item;
+  }
+
+  return JETI_SYNC_ITEMS;
+}
+
+uint8_t JetiSyncFill(struct LL_CONTROL_INPUT* pCtrl)
+{
+  ++jetiSync.stat.slots;
+
+  if(++jetiSync.refreshCnt >= JETI_SYNC_REFRESH_SLOTS)
+  {
+    jetiSync.refreshCnt = 0;
+    ++jetiSync.stat.refreshes;
+
+    // a pending text change keeps its latency measurement
+    if(!(jetiDirty & JETI_DIRTY_TEXT))
+      jetiSync.refreshText = 1;
+    jetiDirty |= JETI_DIRTY_ALL & ~JETI_DIRTY_TEXT;
+  }
+
+  pCtrl->status = 0;
+
+  if(jetiSync.part2)
+  {
+    fillSecondPart(pCtrl, jetiSync.part2);
+    jetiSync.part2 = 0;
+    ++jetiSync.stat.used;
+    return 1;
+  }
+
+  uint8_t item = nextItem();
+
+  if(item == JETI_SYNC_ITEMS)
+    return 0;
+
+  // changes from now on are sent again
+  if(item == ITEM_TEXT)
+  {
+    jetiSync.textTimed = (jetiDirty & JETI_DIRTY_TEXT) != 0;
+    jetiSync.refreshText = 0;
+  }
+  jetiDirty &= ~(1UL << item);
+
+  fillItem(pCtrl, item);
+  ++jetiSync.stat.items[item];
+  ++jetiSync.stat.used;
+
+  return 1;
+}
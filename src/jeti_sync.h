@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2017 Intel Deutschland GmbH, Germany
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "ll_hl_comm.h"
+#include "context.h"
+#include <stdint.h>
+
+// Change driven sync of the Jeti telemetry to the LL.
+// Page 0 frames without GPS data can carry one PD_JETI_* command. JetiSyncFill()
+// only sends the items marked in jetiDirty by the jeti*() setters
+// (hal/jeti_telemetry.h): the alarm and the display text first, then name,
+// value groups and sensor descriptions round robin. A value group is sent at
+// most every JETI_SYNC_VALUE_SLOTS slots, so values that change every tick do
+// not take all slots. Every JETI_SYNC_REFRESH_SLOTS slots all items are sent
+// again in case the LL restarted or missed a frame.
+// Slots without a changed item carry no command and are free for other data.
+
+#define JETI_SYNC_ITEMS 23 // bits of jetiDirty
+
+typedef struct _JetiSyncStats
+{
+  uint32_t slots;             // page 0 frames without GPS data
+  uint32_t used;              // carried a Jeti command
+  uint32_t refreshes;
+  uint32_t items[JETI_SYNC_ITEMS]; // sent per jetiDirty bit
+  uint32_t textUpdates;       // display text changes sent completely
+  uint32_t textLatencyMaxUs;  // text change to its second half sent
+  uint64_t textLatencySumUs;
+} JetiSyncStats;
+
+typedef struct _JetiSync
+{
+  uint8_t next;               // round robin position
+  uint8_t part2;              // item with the second half pending, 0 = none
+  uint8_t refreshText;        // text not changed, but due for the refresh
+  uint8_t textTimed;          // text being sent was changed by the user
+  uint16_t refreshCnt;
+  uint32_t valueSlot[5];      // stat.slots when the value group was last sent
+  JetiSyncStats stat;
+} JetiSync;
+
+extern CONTEXT_LOCAL JetiSync jetiSync;
+
+void JetiSyncInit(void);
+
+// Sets the Jeti command of a page 0 frame without GPS data, returns 1 if there
+// was one. status is 0 otherwise.
+uint8_t JetiSyncFill(struct LL_CONTROL_INPUT* pCtrl);
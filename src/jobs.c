@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2017 Intel Deutschland GmbH, Germany
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jobs.h"
+#include "LPC214x.h"
+#include "hal/sys_time.h"
+#include <string.h>
+
+#define CYCLES_PER_US (CPU_CLOCK_HZ/1000000)
+
+CONTEXT_LOCAL Jobs jobs;
+
+void JobsInit(void)
+{
+  memset(&jobs, 0, sizeof(Jobs));
+}
+
+uint8_t JobPost(const char* pName, JobFunc pFunc, void* pArg, uint16_t costUs)
+{
+  if(jobs.count == JOBS_MAX)
+  {
+    ++jobs.dropped;
+    return 1;
+  }
+
+  Job* pJob = &jobs.queue[(jobs.head + jobs.count) % JOBS_MAX];
+  pJob->pName = pName;
+  pJob->pFunc = pFunc;
+  pJob->pArg = pArg;
+  pJob->costUs = costUs;
+
+  ++jobs.count;
+  ++jobs.posted;
+
+  return 0;
+}
+
+uint8_t JobsRunIdle(volatile uint8_t* pTickPending)
+{
+  if(!jobs.count)
+    return 0;
+
+  // read the timer before the trigger, a tick in between is then seen
+  uint32_t tc = T0TC;
+  uint32_t match = T0MR0;
+
+  if(*pTickPending || tc >= match)
+    return 0;
+
+  uint32_t freeUs = (match - tc)/CYCLES_PER_US;
+  uint8_t i = 0;
+
+  while(jobs.queue[(jobs.head + i) % JOBS_MAX].costUs > freeUs)
+  {
+    if(++i == jobs.count)
+      return 0;
+  }
+
+  Job* pJob = &jobs.queue[(jobs.head + i) % JOBS_MAX];
+
+  uint32_t start = T1TC;
+  uint8_t result = (*pJob->pFunc)(pJob->pArg);
+  uint32_t cycles = SysTimeCyclesBetween(start, T1TC);
+
+  ++jobs.chunks;
+  if(cycles > jobs.maxChunkCycles)
+    jobs.maxChunkCycles = cycles;
+  if(*pTickPending)
+    ++jobs.overruns;
+  if(i)
+    ++jobs.deferrals;
+
+  if(result == JOB_DONE)
+  {
+    // close the gap, the order of the remaining jobs is kept
+    for(; i + 1 < jobs.count; i++)
+      jobs.queue[(jobs.head + i) % JOBS_MAX] = jobs.queue[(jobs.head + i + 1) % JOBS_MAX];
+
+    --jobs.count;
+  }
+
+  return 1;
+}
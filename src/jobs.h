@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2017 Intel Deutschland GmbH, Germany
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "context.h"
+#include <stdint.h>
+
+// Background jobs for deferrable work in the idle time between two ticks.
+// A job is a function that does one bounded chunk of work per call and returns
+// JOB_MORE until it is finished. The idle loop starts a chunk only if its
+// costUs still fits before the next timer 0 match, so jobs are preempted by
+// the tick at chunk boundaries and never delay the 1kHz loop as long as the
+// cost estimates hold. Chunks that still run into a tick count as overruns.
+// A job that does not fit the remaining time is passed over for the next one
+// that does, so one expensive job does not block the cheap ones behind it.
+//
+// Job time is not idle time, it shows up in cpu_load.
+// JobPost() is for the main loop only, not for interrupts.
+
+#define JOBS_MAX 8
+
+#define JOB_DONE 0
+#define JOB_MORE 1
+
+typedef uint8_t(*JobFunc)(void* pArg);
+
+typedef struct _Job
+{
+  const char* pName;
+  JobFunc pFunc;
+  void* pArg;
+  uint16_t costUs;    // worst case time of one call
+} Job;
+
+typedef struct _Jobs
+{
+  Job queue[JOBS_MAX];
+  uint8_t head;
+  uint8_t count;
+
+  uint32_t posted;
+  uint32_t dropped;         // queue full
+  uint32_t chunks;
+  uint32_t overruns;        // chunks that ran into the next tick
+  uint32_t deferrals;       // chunks run ahead of an older job that did not fit
+  uint32_t maxChunkCycles;
+} Jobs;
+
+extern CONTEXT_LOCAL Jobs jobs;
+
+void JobsInit(void);
+
+// Queue a job, returns 1 if the queue is full.
+uint8_t JobPost(const char* pName, JobFunc pFunc, void* pArg, uint16_t costUs);
+
+// Idle loop. Runs one chunk of the oldest job that fits before the next tick
+// if *pTickPending is not set yet. Returns 1 if a chunk ran.
+uint8_t JobsRunIdle(volatile uint8_t* pTickPending);
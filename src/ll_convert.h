@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2017 Intel Deutschland GmbH, Germany
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "config.h"
+
+// Unit conversions between sdk and the LL without division. The ARM7TDMI has
+// no divider, with -Os a division by a constant is a call to the division routine.
+//
+// x/d is computed as x*m >> (32 + log2d) with m = ceil(2^(32 + log2d)/d) and
+// log2d = floor(log2(d)). This is exact for all 0 <= x < 2^31. Signed values
+// are truncated toward zero like C division. Every conversion below is bit
+// exact with the division it replaces wherever that does not overflow.
+#define LL_CONV_RECIP(d, log2d) ((uint32_t)(((1ULL << (32 + (log2d))) + (d) - 1)/(d)))
+
+// command scaling to the LL range of +-2048
+#define LL_CONV_ANGLE_DIV   1625    // 2048/52000 = 64/1625, 52 deg
+#define LL_CONV_ANGLE_LOG2  10
+#define LL_CONV_SPEED_DIV   375     // 2048/3000 = 256/375, 3 m/s
+#define LL_CONV_SPEED_LOG2  8
+#define LL_CONV_THRUST_DIV  125     // 4096/4000 = 128/125
+#define LL_CONV_THRUST_LOG2 6
+
+#if VEHICLE_TYPE == VEHICLE_TYPE_HUMMINGBIRD
+#define LL_CONV_YAW_MUL     64      // 2048/300000 = 64/9375, 300 deg/s
+#define LL_CONV_YAW_DIV     9375
+#define LL_CONV_YAW_LOG2    13
+#else
+#define LL_CONV_YAW_MUL     32      // 2048/200000 = 32/3125, 200 deg/s
+#define LL_CONV_YAW_DIV     3125
+#define LL_CONV_YAW_LOG2    11
+#endif
+
+#define LL_CONV_MOTOR_DIV   301     // Hummingbird and Pelican
+#define LL_CONV_MOTOR_LOG2  8
+#define LL_CONV_MOTOR_FIREFLY_DIV  175
+#define LL_CONV_MOTOR_FIREFLY_LOG2 7
+#define LL_CONV_ACC_DIV     100
+#define LL_CONV_ACC_LOG2    6
+#define LL_CONV_BAT_DIV     579
+#define LL_CONV_BAT_LOG2    9
+#define LL_CONV_BAT_FILTER_DIV  15
+#define LL_CONV_BAT_FILTER_LOG2 3
+
+// x/d for 0 <= x < 2^31, m = LL_CONV_RECIP(d, log2d)
+static inline uint32_t llConvDivU(uint32_t x, uint32_t m, uint8_t log2d)
+{
+  return ((uint64_t)x*m) >> (32 + log2d);
+}
+
+// x/d truncated toward zero for -2^31 < x < 2^31
+static inline int32_t llConvDivS(int32_t x, uint32_t m, uint8_t log2d)
+{
+  if(x < 0)
+    return -(int32_t)llConvDivU(-x, m, log2d);
+
+  return llConvDivU(x, m, log2d);
+}
+
+// [deg*1000] to LL pitch/roll, (angle*2048)/52000
+static inline int32_t LLConvAngleCmd(int32_t angle)
+{
+  return llConvDivS(angle*64, LL_CONV_RECIP(LL_CONV_ANGLE_DIV, LL_CONV_ANGLE_LOG2), LL_CONV_ANGLE_LOG2);
+}
+
+// [deg/s*1000] to LL yaw, (yawRate*2048)/300000 on the Hummingbird, /200000 otherwise
+static inline int32_t LLConvYawRateCmd(int32_t yawRate)
+{
+  return llConvDivS(yawRate*LL_CONV_YAW_MUL, LL_CONV_RECIP(LL_CONV_YAW_DIV, LL_CONV_YAW_LOG2), LL_CONV_YAW_LOG2);
+}
+
+// [mm/s] to LL pitch/roll, (speed*2048)/3000
+static inline int32_t LLConvSpeedCmd(int32_t speed)
+{
+  return llConvDivS(speed*256, LL_CONV_RECIP(LL_CONV_SPEED_DIV, LL_CONV_SPEED_LOG2), LL_CONV_SPEED_LOG2);
+}
+
+// [mm/s] to LL thrust, ((climbRate+2000)*4096)/4000
+static inline int32_t LLConvClimbRateCmd(int32_t climbRate)
+{
+  return llConvDivS((climbRate + 2000)*128, LL_CONV_RECIP(LL_CONV_THRUST_DIV, LL_CONV_THRUST_LOG2),
+      LL_CONV_THRUST_LOG2);
+}
+
+// [RPM] to LL motor command before limiting, (8*rpm-8600)/301 on Hummingbird and Pelican
+static inline int32_t LLConvMotorCmd(int32_t rpm)
+{
+  return llConvDivS(8*rpm - 8600, LL_CONV_RECIP(LL_CONV_MOTOR_DIV, LL_CONV_MOTOR_LOG2), LL_CONV_MOTOR_LOG2);
+}
+
+// [RPM] to LL motor command before limiting, (4*rpm-500)/175 on the Firefly
+static inline int32_t LLConvMotorCmdFirefly(int32_t rpm)
+{
+  return llConvDivS(4*rpm - 500, LL_CONV_RECIP(LL_CONV_MOTOR_FIREFLY_DIV, LL_CONV_MOTOR_FIREFLY_LOG2),
+      LL_CONV_MOTOR_FIREFLY_LOG2);
+}
+
+// LL acceleration [mg] to [m/s^2*1000], (acc*981)/100
+static inline int32_t LLConvAcc(int16_t acc)
+{
+  return llConvDivS(acc*981, LL_CONV_RECIP(LL_CONV_ACC_DIV, LL_CONV_ACC_LOG2), LL_CONV_ACC_LOG2);
+}
+
+// battery ADC value to [mV], raw*9872/579
+static inline uint32_t LLConvBatteryMV(uint32_t raw)
+{
+  return llConvDivU(raw*9872, LL_CONV_RECIP(LL_CONV_BAT_DIV, LL_CONV_BAT_LOG2), LL_CONV_BAT_LOG2);
+}
+
+// battery low pass [mV], (filtered*14 + mV)/15
+static inline uint32_t LLConvBatteryFilter(uint32_t filtered, uint32_t mV)
+{
+  return llConvDivU(filtered*14 + mV, LL_CONV_RECIP(LL_CONV_BAT_FILTER_DIV, LL_CONV_BAT_FILTER_LOG2),
+      LL_CONV_BAT_FILTER_LOG2);
+}
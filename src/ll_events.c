@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2017 Intel Deutschland GmbH, Germany
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ll_events.h"
+#include <string.h>
+
+CONTEXT_LOCAL LLEvents llEvents;
+
+void LLEventsInit(void)
+{
+  memset(&llEvents, 0, sizeof(LLEvents));
+}
+
+void LLEventsUpdate(uint8_t select, int16_t value, int64_t timeUs)
+{
+  ++llEvents.updates;
+
+  if(select >= LL_EVENTS_NUM_CHANNELS)
+  {
+    ++llEvents.ignored;
+    return;
+  }
+
+  uint16_t bit = 1 << select;
+  uint8_t first = !(llEvents.seen & bit);
+
+  if(!first && llEvents.last[select] == value)
+    return;
+
+  LLEvent* pEvent = &llEvents.queue[llEvents.seq & (LL_EVENTS_QUEUE_SIZE-1)];
+
+  pEvent->timeUs = timeUs;
+  pEvent->seq = llEvents.seq;
+  pEvent->value = value;
+  pEvent->previous = llEvents.last[select];
+  pEvent->select = select;
+  pEvent->first = first;
+
+  llEvents.last[select] = value;
+  llEvents.seen |= bit;
+  ++llEvents.events[select];
+  ++llEvents.seq;
+}
+
+void LLEventReaderInit(LLEventReader* pReader)
+{
+  pReader->next = llEvents.seq;
+  pReader->lost = 0;
+}
+
+uint8_t LLEventRead(LLEventReader* pReader, LLEvent* pEvent)
+{
+  uint32_t behind = llEvents.seq - pReader->next;
+
+  if(!behind)
+    return 0;
+
+  if(behind > LL_EVENTS_QUEUE_SIZE)
+  {
+    pReader->lost += behind - LL_EVENTS_QUEUE_SIZE;
+    pReader->next = llEvents.seq - LL_EVENTS_QUEUE_SIZE;
+  }
+
+  *pEvent = llEvents.queue[pReader->next & (LL_EVENTS_QUEUE_SIZE-1)];
+  ++pReader->next;
+
+  return 1;
+}
+
+uint32_t LLEventReaderLost(const LLEventReader* pReader)
+{
+  uint32_t behind = llEvents.seq - pReader->next;
+
+  return pReader->lost + (behind > LL_EVENTS_QUEUE_SIZE ? behind - LL_EVENTS_QUEUE_SIZE : 0);
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2017 Intel Deutschland GmbH, Germany
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "context.h"
+#include <stdint.h>
+
+// Event queue for the slow up channel of the LL.
+// Page 2 frames carry one SUDC_* value each. SDKParseLLData() passes them to
+// LLEventsUpdate(), which queues a value as an event when it differs from the
+// last one on its channel, or is the first one, with the arrival time of the
+// frame. Short transitions like a WP_NAVSTAT_REACHED_POS or an ackTrigger edge
+// are kept until read, no polling of sdk.ro needed.
+//
+// Every reader keeps its own position, so user code and ExtCom both see all
+// events. A reader more than LL_EVENTS_QUEUE_SIZE events behind loses the
+// oldest ones, they are counted in its lost field.
+//
+// Main loop only, not for interrupts.
+
+#define LL_EVENTS_QUEUE_SIZE   16 // power of two
+#define LL_EVENTS_NUM_CHANNELS 16 // SUDC_* values up to this are tracked
+
+typedef struct _LLEvent
+{
+  int64_t timeUs;             // arrival of the LL frame [us since boot, see SysTimeLongUSec()]
+  uint32_t seq;               // event number since startup
+  int16_t value;
+  int16_t previous;           // last value on this channel, 0 for the first one
+  uint8_t select;             // SUDC_*
+  uint8_t first;              // first value seen on this channel
+} LLEvent;
+
+typedef struct _LLEventReader
+{
+  uint32_t next;              // seq of the next event to read
+  uint32_t lost;              // overwritten before they were read
+} LLEventReader;
+
+typedef struct _LLEvents
+{
+  LLEvent queue[LL_EVENTS_QUEUE_SIZE];
+  uint32_t seq;               // events queued so far
+  int16_t last[LL_EVENTS_NUM_CHANNELS];
+  uint16_t seen;              // bit per channel
+  uint32_t updates;           // values received
+  uint32_t ignored;           // select not tracked
+  uint32_t events[LL_EVENTS_NUM_CHANNELS];
+} LLEvents;
+
+extern CONTEXT_LOCAL LLEvents llEvents;
+
+void LLEventsInit(void);
+
+// SUDC_* value from a page 2 frame received at timeUs
+void LLEventsUpdate(uint8_t select, int16_t value, int64_t timeUs);
+
+// Starts reading with the next event queued.
+void LLEventReaderInit(LLEventReader* pReader);
+
+// Copies the oldest unread event, returns 0 if there is none.
+uint8_t LLEventRead(LLEventReader* pReader, LLEvent* pEvent);
+
+// Events the reader lost so far, including those overwritten but not yet noticed.
+uint32_t LLEventReaderLost(const LLEventReader* pReader);
+
+// Bits of mask set by this event, e.g. LLEventRising(&ev, WP_NAVSTAT_REACHED_POS)
+static inline uint16_t LLEventRising(const LLEvent* pEvent, uint16_t mask)
+{
+  return (uint16_t)pEvent->value & ~(uint16_t)pEvent->previous & mask;
+}
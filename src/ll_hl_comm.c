@@ -15,6 +15,7 @@
  */
 
 #include "main.h"
+#include "LPC214x.h"
 #include "hal/system.h"
 #include "util/gpsmath.h"
 #include "util/declination.h"
@@ -26,15 +27,40 @@
 #include "ll_hl_comm.h"
 #include "sdkio.h"
 #include "util/build_info.h"
+#include "capture.h"
+#include "trace.h"
+#include "phase_lock.h"
+#include "context.h"
+#include "slow_channel.h"
+#include "jeti_sync.h"
 
-static struct LL_ATTITUDE_DATA LL_1khz_attitude_data;
-static struct LL_CONTROL_INPUT LL_1khz_control_input;
-static volatile unsigned char transmitBuildInfoTrigger = 0;
+#define LL_RX_SYNC 0
+#define LL_RX_DATA 1
+#define LL_RX_END  2
+
+#define LL_RX_START       ('>' | ('*' << 8))
+#define LL_RX_DATA_WORDS  20
+#define LL_RX_LATE_CYCLES ((uint32_t)(CPU_CLOCK_HZ*3/2000)) // 1.5ms
+
+static CONTEXT_LOCAL struct LL_ATTITUDE_DATA LL_1khz_attitude_data;
+static CONTEXT_LOCAL struct LL_CONTROL_INPUT LL_1khz_control_input;
+static CONTEXT_LOCAL volatile unsigned char transmitBuildInfoTrigger = 0;
+static CONTEXT_LOCAL uint8_t emModePosted = 0;
+
+// Raw frames from the LL, a triple buffer without read-modify-write: the SSP
+// interrupt publishes complete frames in llRxLatest and never writes into the
+// latest or the llRxReading buffer, the main loop only writes llRxReading.
+static CONTEXT_LOCAL volatile LLRxFrame llRxFrames[3];
+static CONTEXT_LOCAL volatile uint8_t llRxLatest = 0;
+static CONTEXT_LOCAL volatile uint8_t llRxReading = 0;
+static CONTEXT_LOCAL uint32_t llRxLastSeq = 0;
+
+CONTEXT_LOCAL LLRxStats llRxStats;
 
 void SSP_data_distribution_HL(void)
 {
   unsigned char current_page = LL_1khz_attitude_data.system_flags & 0x03;
-  static unsigned char oldKey = 0;
+  static CONTEXT_LOCAL unsigned char oldKey = 0;
 
   SDKParseLLData(&LL_1khz_attitude_data);
 
@@ -66,15 +92,138 @@ void SSP_data_distribution_HL(void)
 
 
 
+uint8_t LLRxProcess(void)
+{
+  uint8_t i;
+
+  // mark the newest frame as being read, retry if the interrupt published another one meanwhile
+  do
+  {
+    i = llRxLatest;
+    llRxReading = i;
+  }
+  while(i != llRxLatest);
+
+  volatile LLRxFrame* pFrame = &llRxFrames[i];
+  volatile uint8_t* pData = (volatile uint8_t*)pFrame->data;
+  uint32_t seq = pFrame->seq;
+
+  if(seq == llRxLastSeq)
+    return 0;
+
+  llRxStats.dropped += seq - llRxLastSeq - 1;
+  llRxStats.parsed++;
+  llRxLastSeq = seq;
+
+  // 1kHz part and the page received in this frame
+  uint8_t* pDst = (uint8_t*)&LL_1khz_attitude_data;
+  uint8_t page = pData[0] & 0x03;
+
+  for(uint8_t j = 0; j < 14; j++)
+    pDst[j] = pData[j];
+
+  pDst += 14 + 26*page;
+  for(uint8_t j = 14; j < 40; j++)
+    *pDst++ = pData[j];
+
+  SysTimeStamp stamp = { pFrame->stamp.seconds, pFrame->stamp.cycles };
+  int64_t us = SysTimeStampToUSec(&stamp);
+
+  sdk.ro.sampleTimeUs.attitude = us;
+  sdk.ro.sampleTimeUs.page[page] = us;
+
+  SSP_data_distribution_HL();
+
+  return 1;
+}
+
+// build info to the LL, one byte per slot
+static uint8_t buildInfoFill(SlowChannelSlot* pSlot, void* pArg)
+{
+  uint16_t* pCnt = (uint16_t*)pArg;
+
+  pSlot->select = SDC_BUILDINFO;
+  pSlot->dataShort = *pCnt;
+  pSlot->dataChar = ((unsigned char *)&buildInfo.version_major)[*pCnt];
+
+  return ++*pCnt == sizeof(buildInfo);
+}
+
+// Each trigger is only consumed once its items are queued, a full queue is tried
+// again with the next page 1 frame.
+static void postSlowChannelItems(void)
+{
+  static CONTEXT_LOCAL uint16_t buildInfoCnt;
+  SlowChannelItem item;
+
+  memset(&item, 0, sizeof(item));
+
+  if(declinationAvailable == 1)
+  {
+    item.itemClass = SLOW_CHANNEL_CLASS_DECLINATION;
+    item.priority = SLOW_CHANNEL_PRIO_DECLINATION;
+    item.slot.select = SDC_DECLINATION;
+    item.slot.dataShort = estimatedDeclination;
+    uint8_t full = SlowChannelPost(&item);
+
+    // a queued declination is replaced by the next attempt
+    item.slot.select = SDC_INCLINATION;
+    item.slot.dataShort = estimatedInclination;
+    full |= SlowChannelPost(&item);
+
+    if(!full)
+      declinationAvailable = 3;
+  }
+
+  if(transmitBuildInfoTrigger == 1)
+  {
+    buildInfoCnt = 0;
+
+    memset(&item, 0, sizeof(item));
+    item.itemClass = SLOW_CHANNEL_CLASS_BUILD_INFO;
+    item.priority = SLOW_CHANNEL_PRIO_BUILD_INFO;
+    item.pFill = &buildInfoFill;
+    item.pArg = &buildInfoCnt;
+
+    if(!SlowChannelPost(&item))
+      transmitBuildInfoTrigger = 2;
+  }
+
+  // repeated until the LL reports the new mode, which clears newEmergencyMode
+  if(sdk.cmd.newEmergencyMode != emModePosted)
+  {
+    if(sdk.cmd.newEmergencyMode)
+    {
+      memset(&item, 0, sizeof(item));
+      item.itemClass = SLOW_CHANNEL_CLASS_EM_MODE;
+      item.priority = SLOW_CHANNEL_PRIO_EM_MODE;
+      item.slot.select = SDC_EM_MODE;
+      item.slot.dataShort = sdk.cmd.newEmergencyMode;
+      item.ackSelect = SUDC_EM_MODE;
+      item.retries = SLOW_CHANNEL_RETRY_FOREVER;
+      item.retryInterval = 1;
+
+      if(!SlowChannelPost(&item))
+        emModePosted = sdk.cmd.newEmergencyMode;
+    }
+    else
+    {
+      emModePosted = 0;
+    }
+  }
+}
+
 int HL2LL_write_cycle(void) //write data to low-level processor
 {
-  static char pageselect = 0;
-  static unsigned char jetiValuePartialSyncPending = 0;
-  static unsigned char * transmitPtr;
-  static unsigned short transmitCnt = 0;
+  static CONTEXT_LOCAL char pageselect = 0;
 
-  if(!SSPDataSentToLL)
-    return (0);
+  // the frame of the last cycle has not started yet and goes out next: it keeps
+  // its page, slow channel slot and Jeti command, this cycle writes nothing
+  if(SSPTxPending())
+  {
+    ++sspTxStats.skipped;
+    return 0;
+  }
 
   if(SYSTEM_initialized && (!transmitBuildInfoTrigger))
     transmitBuildInfoTrigger = 1;
@@ -102,141 +251,14 @@ int HL2LL_write_cycle(void) //write data to low-level processor
     }
     else
     {
-      //default is no command
-      LL_1khz_control_input.status = 0;
-
-      if(LL_1khz_control_input.system_flags & SF_GPS_NEW)
-      {
-        //fill struct with 500Hz data
-        LL_1khz_control_input.latitude = gps.data.latitude;
-        LL_1khz_control_input.longitude = gps.data.longitude;
-        LL_1khz_control_input.height = gps.data.height;
-        LL_1khz_control_input.speed_x = gps.data.speedEastWest;
-        LL_1khz_control_input.speed_y = gps.data.speedNorthSouth;
-        LL_1khz_control_input.heading = gps.data.heading;
-        LL_1khz_control_input.status = gps.status;
-      }
-      else
-      {
-        static unsigned char jetiSyncState = 0;
-        static unsigned char jetiSensorCnt = 0;
-        static unsigned char jetiSensorValCnt = 0;
-        static unsigned char jetiSensorValUpdateTimeout = 0;
-
-        //default is no command
-        LL_1khz_control_input.status = 0;
-
-        //data fields are used for jeti commands
-        if(jetiValuePartialSyncPending == 1)
-        {
-          jetiValuePartialSyncPending = 0;
-          LL_1khz_control_input.status = PD_JETI_SETSENSOR2;
-
-          LL_1khz_control_input.height = jetiValues[jetiSensorCnt].active;
-          memcpy(&LL_1khz_control_input.latitude, &jetiValues[jetiSensorCnt].unit[0], 4);
-          LL_1khz_control_input.speed_x = jetiValues[jetiSensorCnt].unit[4];
-          LL_1khz_control_input.speed_y = jetiValues[jetiSensorCnt].varType;
-          LL_1khz_control_input.longitude = jetiValues[jetiSensorCnt].value;
-          jetiSensorCnt++;
-          if(jetiSensorCnt == 15)
-            jetiSensorCnt = 0;
-          jetiSyncState++;
-          jetiSensorValCnt = 0;
-          jetiSensorValUpdateTimeout = 0;
-        }
-        else
-        {
-          switch(jetiSyncState)
-          {
-            case 0:
-              //sync name
-              LL_1khz_control_input.status = PD_JETI_SETNAME;
-              memcpy(&LL_1khz_control_input.latitude, &jetiName[0], 4);
-              memcpy(&LL_1khz_control_input.longitude, &jetiName[4], 4);
-              memcpy(&LL_1khz_control_input.speed_x, &jetiName[8], 2);
-              jetiSyncState++;
-              break;
-            case 1:
-              //sync alarm
-              LL_1khz_control_input.status = PD_JETI_SETALARM;
-              LL_1khz_control_input.speed_x = jetiAlarm;
-              LL_1khz_control_input.speed_y = jetiAlarmType;
-              jetiSyncState++;
-              break;
-            case 2:
-              //sync complete sensor fields
-              if(jetiValues[jetiSensorCnt].active)
-              {
-                LL_1khz_control_input.status = PD_JETI_SETSENSOR;
-                LL_1khz_control_input.height = jetiValues[jetiSensorCnt].active;
-                memcpy(&LL_1khz_control_input.latitude, &jetiValues[jetiSensorCnt].name[0], 4);
-                memcpy(&LL_1khz_control_input.longitude, &jetiValues[jetiSensorCnt].name[4], 4);
-                memcpy(&LL_1khz_control_input.speed_x, &jetiValues[jetiSensorCnt].name[8], 2);
-                LL_1khz_control_input.speed_y = jetiValues[jetiSensorCnt].decPoint;
-                jetiValuePartialSyncPending = 1;
-              }
-              else
-              {
-                jetiSensorCnt++;
-                if(jetiSensorCnt == 15)
-                  jetiSensorCnt = 0;
-
-                jetiSyncState++;
-                jetiSensorValCnt = 0;
-                jetiSensorValUpdateTimeout = 0;
-              }
-              break;
-            case 3:
-              //sync text
-              LL_1khz_control_input.status = PD_JETI_SETTEXT;
-              memcpy(&LL_1khz_control_input.latitude, &jetiDisplayText[0], 4);
-              memcpy(&LL_1khz_control_input.longitude, &jetiDisplayText[4], 4);
-              memcpy(&LL_1khz_control_input.height, &jetiDisplayText[8], 4);
-              memcpy(&LL_1khz_control_input.speed_x, &jetiDisplayText[12], 2);
-              memcpy(&LL_1khz_control_input.speed_y, &jetiDisplayText[14], 2);
-              jetiSyncState++;
-              break;
-            case 4:
-              //sync text2
-              LL_1khz_control_input.status = PD_JETI_SETTEXT2;
-              memcpy(&LL_1khz_control_input.latitude, &jetiDisplayText[16], 4);
-              memcpy(&LL_1khz_control_input.longitude, &jetiDisplayText[20], 4);
-              memcpy(&LL_1khz_control_input.height, &jetiDisplayText[24], 4);
-              memcpy(&LL_1khz_control_input.speed_x, &jetiDisplayText[28], 2);
-              memcpy(&LL_1khz_control_input.speed_y, &jetiDisplayText[30], 2);
-              jetiSyncState++;
-              break;
-            case 5:
-              //sync all sensor values for 75ms
-              LL_1khz_control_input.status = PD_JETI_UPDATESDATA;
-              LL_1khz_control_input.height = jetiSensorValCnt;
-              LL_1khz_control_input.latitude = jetiValues[3 * jetiSensorValCnt].value;
-              LL_1khz_control_input.longitude = jetiValues[3 * jetiSensorValCnt + 1].value;
-              memcpy(&LL_1khz_control_input.speed_y,
-                  (void *)(((unsigned char *)(&jetiValues[3 * jetiSensorValCnt + 2].value)) + 2), 2);
-              memcpy(&LL_1khz_control_input.speed_x, &jetiValues[3 * jetiSensorValCnt + 2].value, 2);
-
-              jetiSensorValCnt++;
-              if(jetiSensorValCnt == 5)
-                jetiSensorValCnt = 0;
-
-              if(jetiTriggerTextSync)
-              {
-                jetiSyncState = 3; //trigger text resync
-                jetiTriggerTextSync = 0;
-              }
-
-              jetiSensorValUpdateTimeout++;
-              if(jetiSensorValUpdateTimeout == 75)
-                jetiSyncState = 0;
-              break;
-          }
-        }
-      }
+      //data fields are used for jeti commands, status 0 if nothing changed
+      JetiSyncFill(&LL_1khz_control_input);
     }
 
     //write data
     SSPWriteToLL(pageselect, (uint8_t*)&LL_1khz_control_input);
+    PhaseLockCommandWritten();
+    TRACE(TRACE_EV_LL_WRITE, pageselect);
     //set pageselect to other page for next cycle
     pageselect = 1;
   }
@@ -249,54 +271,18 @@ int HL2LL_write_cycle(void) //write data to low-level processor
     LL_1khz_control_input.numSV = gps.data.numSatellites;
     LL_1khz_control_input.battery_voltage_1 = HL_Status.battery_voltage_1;
     LL_1khz_control_input.battery_voltage_2 = 0;
-    if(declinationAvailable == 1)
-    {
-      declinationAvailable = 2;
-      LL_1khz_control_input.slowDataChannelSelect = SDC_DECLINATION;
-      LL_1khz_control_input.slowDataChannelDataShort = estimatedDeclination;
-    }
-    else if(declinationAvailable == 2)
-    {
-      declinationAvailable = 3;
-      LL_1khz_control_input.slowDataChannelSelect = SDC_INCLINATION;
-      LL_1khz_control_input.slowDataChannelDataShort = estimatedInclination;
-    }
-    else if(transmitBuildInfoTrigger == 1)
-    {
-      transmitBuildInfoTrigger = 2;
-      transmitCnt = 0;
-      transmitPtr = (unsigned char *)&buildInfo.version_major;
-      LL_1khz_control_input.slowDataChannelSelect = SDC_BUILDINFO;
-      LL_1khz_control_input.slowDataChannelDataShort = transmitCnt;
-      LL_1khz_control_input.slowDataChannelDataChar = *transmitPtr;
-      transmitPtr++;
-      transmitCnt++;
-    }
-    else if(transmitBuildInfoTrigger == 2)
-    {
-      LL_1khz_control_input.slowDataChannelSelect = SDC_BUILDINFO;
-      LL_1khz_control_input.slowDataChannelDataShort = transmitCnt;
-      LL_1khz_control_input.slowDataChannelDataChar = *transmitPtr;
-      transmitPtr++;
-      transmitCnt++;
-
-      if(transmitCnt == sizeof(buildInfo))
-        transmitBuildInfoTrigger = 3;
-    }
-    else if(sdk.cmd.newEmergencyMode)
-    {
-      LL_1khz_control_input.slowDataChannelSelect = SDC_EM_MODE;
-      LL_1khz_control_input.slowDataChannelDataShort = sdk.cmd.newEmergencyMode;
-    }
-    else
-    {
-      LL_1khz_control_input.slowDataChannelDataShort = 0;
-      LL_1khz_control_input.slowDataChannelSelect = 0;
-      LL_1khz_control_input.slowDataChannelDataChar = 0;
-    }
+
+    SlowChannelSlot slot;
+    postSlowChannelItems();
+    SlowChannelNext(&slot);
+    LL_1khz_control_input.slowDataChannelSelect = slot.select;
+    LL_1khz_control_input.slowDataChannelDataChar = slot.dataChar;
+    LL_1khz_control_input.slowDataChannelDataShort = slot.dataShort;
 
     //write data
     SSPWriteToLL(pageselect, (uint8_t*)&LL_1khz_control_input);
+    PhaseLockCommandWritten();
+    TRACE(TRACE_EV_LL_WRITE, pageselect);
     //set pageselect to other page for next cycle
     pageselect = 0;
   }
@@ -304,59 +290,125 @@ int HL2LL_write_cycle(void) //write data to low-level processor
   return 1;
 }
 
-inline void SSP_rx_handler_HL(unsigned char SPI_rxdata) //rx_handler @ high-level processor
+// end of the frame in llRxFrames[index], publishes it if the end marker is in place
+static void llRxFrameEnd(uint8_t index, uint8_t endByte)
 {
-  static volatile unsigned char SPI_syncstate = 0;
-  static volatile unsigned char SPI_rxcount = 0;
-  static volatile unsigned char *SPI_rxptr;
-  static volatile unsigned char incoming_page;
+  static CONTEXT_LOCAL uint8_t lastPage = 2;
+  static CONTEXT_LOCAL uint32_t lastFrameCycles;
 
-  //receive handler
-  if(SPI_syncstate == 0)
+  if(endByte != '<')
   {
-    if(SPI_rxdata == '>')
-      SPI_syncstate++;
-    else
-      SPI_syncstate = 0;
+    ++llRxStats.badFrames;
+    return;
   }
-  else if(SPI_syncstate == 1)
+
+  //only publish data if it was received correctly, parsed by LLRxProcess()
+  uint8_t page = llRxFrames[index].data[0] & 0x03;
+  uint32_t now = T1TC;
+
+  if(llRxStats.frames)
   {
-    if(SPI_rxdata == '*')
-    {
-      SPI_syncstate++;
-      SPI_rxptr = (unsigned char *)&LL_1khz_attitude_data;
-      SPI_rxcount = 40;
-    }
-    else
-      SPI_syncstate = 0;
+    uint32_t gap = SysTimeCyclesBetween(lastFrameCycles, now);
+
+    if(gap < llRxStats.gapMinCycles || llRxStats.frames == 1)
+      llRxStats.gapMinCycles = gap;
+    if(gap > llRxStats.gapMaxCycles)
+      llRxStats.gapMaxCycles = gap;
+    if(gap > LL_RX_LATE_CYCLES)
+      ++llRxStats.lateFrames;
   }
-  else if(SPI_syncstate == 2)
+
+  lastFrameCycles = now;
+
+  if(page > 2)
+  {
+    ++llRxStats.badFrames;
+    return;
+  }
+
+  if(page != (lastPage == 2 ? 0 : lastPage + 1))
+    ++llRxStats.pageErrors;
+
+  lastPage = page;
+  ++llRxStats.pages[page];
+
+  llRxFrames[index].seq = ++llRxStats.frames;
+  llRxLatest = index;
+  TRACE_ISR(TRACE_EV_SSP_FRAME, page);
+  PhaseLockFrame();
+}
+
+// The LL pads its 43 byte frames to 22 words, so '>' '*' is normally the first
+// word. A frame that starts in the high byte of a word (a lost byte, a frame
+// without pad byte) is still received byte-wise shifted and counted in oddStarts.
+void SSP_rx_handler_HL(uint16_t word) //rx_handler @ high-level processor
+{
+  static CONTEXT_LOCAL uint8_t rxState = LL_RX_SYNC;
+  static CONTEXT_LOCAL uint8_t rxCount = 0;
+  static CONTEXT_LOCAL uint8_t rxIndex = 0;
+  static CONTEXT_LOCAL uint8_t hunting = 0;
+  static CONTEXT_LOCAL uint8_t odd = 0;     // frame started in the high byte of a word
+  static CONTEXT_LOCAL uint8_t carry = 0;   // high byte of the previous word
+  static CONTEXT_LOCAL volatile uint16_t* pRx;
+
+  CAPTURE_BYTE(CAPTURE_SRC_SSP, word & 0xFF);
+  CAPTURE_BYTE(CAPTURE_SRC_SSP, word >> 8);
+
+  if(rxState == LL_RX_SYNC)
   {
-    if(SPI_rxcount == 26) //14 bytes transmitted => select 500Hz page
+    uint8_t oddStart = carry == '>' && (word & 0xFF) == '*';
+
+    if(word == LL_RX_START || oddStart)
     {
-      incoming_page = LL_1khz_attitude_data.system_flags & 0x03; //system flags were already received
-      if(incoming_page == 1)
-        SPI_rxptr += 26;
-      else if(incoming_page == 2)
-        SPI_rxptr += 52;
+      // free buffer, neither the latest frame nor the one the main loop reads
+      if(llRxLatest != llRxReading)
+        rxIndex = 3 - llRxLatest - llRxReading;
+      else
+        rxIndex = llRxLatest == 2 ? 0 : llRxLatest + 1;
+
+      SysTimeStamp stamp;
+      SysTimeCapture(&stamp);
+      llRxFrames[rxIndex].stamp.seconds = stamp.seconds;
+      llRxFrames[rxIndex].stamp.cycles = stamp.cycles;
+
+      pRx = llRxFrames[rxIndex].data;
+      rxCount = LL_RX_DATA_WORDS;
+      rxState = LL_RX_DATA;
+      hunting = 0;
+      odd = oddStart;
+
+      if(oddStart)
+        ++llRxStats.oddStarts;
     }
-    SPI_rxcount--;
-    *SPI_rxptr = SPI_rxdata;
-    SPI_rxptr++;
-    if(SPI_rxcount == 0)
+    else if(word && !hunting && (word >> 8) != '>')
     {
-      SPI_syncstate++;
+      // idle words are 0, anything else outside of a frame means we lost sync
+      ++llRxStats.syncLosses;
+      hunting = 1;
     }
   }
-  else if(SPI_syncstate == 3)
+  else if(rxState == LL_RX_DATA)
   {
-    if(SPI_rxdata == '<') //last byte ok => data should be valid
+    *pRx++ = odd ? carry | (word << 8) : word;
+    if(--rxCount == 0)
     {
-      SSP_data_distribution_HL(); //only distribute data to other structs, if it was received correctly
-      //ack data receiption
+      // a shifted frame has its end marker in the high byte of the last data word
+      if(odd)
+      {
+        rxState = LL_RX_SYNC;
+        llRxFrameEnd(rxIndex, word >> 8);
+      }
+      else
+      {
+        rxState = LL_RX_END;
+      }
     }
-    SPI_syncstate = 0;
   }
   else
-    SPI_syncstate = 0;
+  {
+    rxState = LL_RX_SYNC;
+    llRxFrameEnd(rxIndex, word & 0xFF);
+  }
+
+  carry = word >> 8;
 }
@@ -16,6 +16,10 @@
 
 #pragma once
 
+#include "context.h"
+#include "hal/sys_time.h"
+#include <stdint.h>
+
 //flight modes / error flags
 #define FM_ACC                             0x01
 #define FM_HEIGHT                          0x02
@@ -188,7 +192,35 @@ struct LL_CONTROL_INPUT
   short slowDataChannelDataShort;
 };
 
+// raw frame as received from the LL, 14 bytes 1kHz data and one 26 byte page
+typedef struct _LLRxFrame
+{
+  uint32_t seq;
+  SysTimeStamp stamp;   // start of the frame
+  uint16_t data[20];
+} LLRxFrame;
+
+// LL link health, written by the SSP interrupt except parsed and dropped
+typedef struct _LLRxStats
+{
+  uint32_t frames;        // complete frames received
+  uint32_t parsed;
+  uint32_t dropped;       // replaced by a newer frame before they were parsed
+  uint32_t syncLosses;    // unexpected words outside of a frame
+  uint32_t oddStarts;     // frames starting in the high byte of a word
+  uint32_t badFrames;     // no end marker or invalid page
+  uint32_t pageErrors;    // page not following the previous one
+  uint32_t pages[3];
+  uint32_t lateFrames;    // more than 1.5ms after the previous frame
+  uint32_t gapMinCycles;  // between two frames
+  uint32_t gapMaxCycles;
+} LLRxStats;
+
+extern CONTEXT_LOCAL LLRxStats llRxStats;
+
 void LL_write_ctrl_data(char);
 int HL2LL_write_cycle(void);
-void SSP_rx_handler_HL(unsigned char);
+void SSP_rx_handler_HL(uint16_t word);
 void SSP_data_distribution_HL(void);
+// parses the newest frame from the LL into sdk.ro, returns 1 if there was a new one
+uint8_t LLRxProcess(void);
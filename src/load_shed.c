@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2017 Intel Deutschland GmbH, Germany
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "load_shed.h"
+#include <string.h>
+
+CONTEXT_LOCAL LoadShed loadShed;
+
+static const uint8_t shedDivisors[LOAD_SHED_NUM] = LOAD_SHED_DIVISORS;
+static const char* const shedNames[LOAD_SHED_NUM] = LOAD_SHED_NAMES;
+
+static void setActive(uint8_t active)
+{
+  if(active && !loadShed.active)
+  {
+    ++loadShed.events;
+    memset(loadShed.count, 0, sizeof(loadShed.count));
+  }
+
+  loadShed.active = active;
+}
+
+void LoadShedInit(void)
+{
+  memset(&loadShed, 0, sizeof(LoadShed));
+}
+
+void LoadShedUpdate(uint16_t tickLoad)
+{
+  // about 8 ticks time constant
+  loadShed.load = (loadShed.load*7 + tickLoad)/8;
+
+  if(loadShed.mode == LOAD_SHED_AUTO)
+  {
+    if(tickLoad >= 1000 || loadShed.load >= LOAD_SHED_HIGH)
+      setActive(1);
+    else if(loadShed.load < LOAD_SHED_LOW)
+      setActive(0);
+  }
+
+  if(loadShed.active)
+    ++loadShed.activeTicks;
+}
+
+void LoadShedSetMode(uint8_t mode)
+{
+  loadShed.mode = mode;
+
+  if(mode != LOAD_SHED_AUTO)
+    setActive(mode == LOAD_SHED_ON);
+}
+
+uint8_t LoadShedAllow(uint8_t unit)
+{
+  if(!loadShed.active)
+    return 1;
+
+  if(shedDivisors[unit] && ++loadShed.count[unit] >= shedDivisors[unit])
+  {
+    loadShed.count[unit] = 0;
+    return 1;
+  }
+
+  ++loadShed.skipped[unit];
+
+  return 0;
+}
+
+const char* LoadShedName(uint8_t unit)
+{
+  if(unit >= LOAD_SHED_NUM)
+    return 0;
+
+  return shedNames[unit];
+}
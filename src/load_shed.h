@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2017 Intel Deutschland GmbH, Germany
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "config.h"
+#include "context.h"
+#include <stdint.h>
+
+// Load shedding for non-critical main loop work.
+// The main loop reports the load of every tick. Once its short term average
+// reaches LOAD_SHED_HIGH or a tick had no idle time at all, sheddable units are
+// throttled until the average falls below LOAD_SHED_LOW again. The LL command
+// write, GPS ingest, command handling and the SDK are never shed.
+//
+// Sheddable work asks LoadShedAllow() before it runs.
+
+#define LOAD_SHED_TELEMETRY 0   // periodic ExtCom messages, all but EXT_MSG_ID_LOAD_SHED
+#define LOAD_SHED_JETI      1   // Jeti values and display text
+#define LOAD_SHED_PTU       2   // camera pan-tilt-unit
+#define LOAD_SHED_FIREFLY   3   // Firefly LED fin
+#define LOAD_SHED_NUM       4
+
+// runs every n-th call while shedding, 0 = not at all
+#define LOAD_SHED_DIVISORS { 0, 10, 5, 0 }
+
+#define LOAD_SHED_NAMES { "telemetry", "jeti", "ptu", "firefly" }
+
+#define LOAD_SHED_AUTO 0
+#define LOAD_SHED_ON   1
+#define LOAD_SHED_OFF  2
+
+typedef struct _LoadShed
+{
+  uint8_t mode;
+  uint8_t active;
+  uint16_t load;                        // short term average [1/1000]
+  uint32_t events;                      // changes to active
+  uint32_t activeTicks;
+  uint8_t count[LOAD_SHED_NUM];
+  uint32_t skipped[LOAD_SHED_NUM];
+} LoadShed;
+
+extern CONTEXT_LOCAL LoadShed loadShed;
+
+void LoadShedInit(void);
+
+// once per tick with the load of the last timer 0 period [1/1000]
+void LoadShedUpdate(uint16_t tickLoad);
+
+// LOAD_SHED_AUTO or force shedding on/off
+void LoadShedSetMode(uint8_t mode);
+
+// 1 if a unit may run now
+uint8_t LoadShedAllow(uint8_t unit);
+
+const char* LoadShedName(uint8_t unit);
@@ -25,7 +25,7 @@
 #include "hal/ublox.h"
 #include "hal/pelican_ptu.h"
 #include "util/declination.h"
-#include "fastmath.h"
+#include "util/fastmath.h"
 #include "hal/led.h"
 #include "hal/uart0.h"
 #include "terminal.h"
@@ -39,30 +39,87 @@
 #include "ll_hl_comm.h"
 #include "sdk.h"
 #include "sdkio.h"
+#include "ll_convert.h"
 #include "util/build_info.h"
-
-struct HL_STATUS HL_Status;
-
-volatile unsigned int GPS_timeout = 0;
-volatile char SYSTEM_initialized = 0;
-
-static volatile uint8_t mainloopTrigger = 0;
+#include "capture.h"
+#include "scheduler.h"
+#include "profiler.h"
+#include "irq_stats.h"
+#include "trace.h"
+#include "phase_lock.h"
+#include "jobs.h"
+#include "stack_monitor.h"
+#include "load_shed.h"
+#include "slow_channel.h"
+#include "ll_events.h"
+#include "jeti_sync.h"
+#include "context.h"
+
+CONTEXT_LOCAL struct HL_STATUS HL_Status;
+
+CONTEXT_LOCAL volatile unsigned int GPS_timeout = 0;
+CONTEXT_LOCAL volatile char SYSTEM_initialized = 0;
+
+static CONTEXT_LOCAL volatile uint8_t mainloopTrigger = 0;
 
 void timer0ISR(void) __irq
 {
+  IRQ_STATS_ENTER(IRQ_STATS_TIMER0);
+
   T0IR = 0x01;      //Clear the timer 0 interrupt
   IENABLE;
 
+  CAPTURE_TICK(!mainloopTrigger);
+
+  PhaseLockTick();
+  SchedulerTick();
+
   mainloopTrigger = 1;
 
+  IRQ_STATS_EXIT(IRQ_STATS_TIMER0);
   IDISABLE;
   VICVectAddr = 0;		// Acknowledge Interrupt
 }
 
+// work done between two passes of the 1kHz loop, returns 1 if anything ran
+static uint8_t idleWork(void)
+{
+#if UART0_FUNCTION == UART0_FUNCTION_COMM
+  // handle commands as soon as they are complete
+  if(ExtComFastPath())
+    return 1;
+#endif
+
+  return JobsRunIdle(&mainloopTrigger);
+}
+
+#ifndef HOST_BUILD
+#define PCON_IDL 0x01
+
+// idle mode until the next interrupt, returns the cycles slept
+static uint32_t sleepUntilInterrupt(void)
+{
+  uint32_t slept = 0;
+
+  // with IRQs masked a tick between the check and PCON cannot be slept through.
+  // Enabled VIC interrupts still wake the core, the handler runs after IntEnable().
+  IntDisable();
+
+  if(!mainloopTrigger)
+  {
+    uint32_t start = T1TC;
+    PCON = PCON_IDL;
+    slept = SysTimeCyclesBetween(start, T1TC);
+  }
+
+  IntEnable();
+
+  return slept;
+}
+
 int main(void)
 {
   uint32_t vbat1 = 12000; //battery_voltage (lowpass-filtered)
-  uint8_t cnt100Hz = 0;
 
   init();
   BuzzerEnable(0);
@@ -83,17 +140,21 @@ int main(void)
   while(mainloopTrigger == 0)
     asm volatile("nop");
 
-  uint32_t maxIdleIncrements = 0;
-  mainloopTrigger = 0;
-
-  while(mainloopTrigger == 0)
-  {
-    ++maxIdleIncrements;
-  }
+  // before SDKInit(), which may already post slow channel items and jobs
+  mainloopInit();
 
   SDKInit();
 
-  uint32_t idleIncrements = 0;
+  uint32_t tickStart = T1TC;
+  uint32_t idleCycles = 0;
+
+#if CAPTURE_ENABLE
+  CaptureStart();
+#endif
+
+#if TRACE_ENABLE
+  TraceStart();
+#endif
 
   while(1)
   {
@@ -102,7 +163,9 @@ int main(void)
     {
       mainloopTrigger = 0;
 
-      ++cnt100Hz;
+      uint32_t now = T1TC;
+      uint32_t period = SysTimeCyclesBetween(tickStart, now);
+      tickStart = now;
 
       if(GPS_timeout < ControllerCyclesPerSecond)
       {
@@ -115,46 +178,88 @@ int main(void)
         gps.data.numSatellites = 0;
         sdk.ro.gps.raw.hasLock = 0;
         sdk.ro.gps.raw.numSatellites = 0;
+        SDKGroupUpdated(SDK_GROUP_GPS_RAW);
       }
 
       //battery monitoring
       uint32_t batRaw = ADC0GetRawValue(ADC0_CH_BAT);
-      vbat1 = (vbat1 * 14 + (batRaw * 9872 / 579)) / 15;	//voltage in mV
+      vbat1 = LLConvBatteryFilter(vbat1, LLConvBatteryMV(batRaw));	//voltage in mV
 
       HL_Status.battery_voltage_1 = vbat1;
 
       mainloop();
 
-      // triggered at 100Hz
-      if(cnt100Hz == 10)
-      {
-        cnt100Hz = 0;
-
-        BuzzerHandler(HL_Status.battery_voltage_1, gps.data.hasLock,
-            sdk.ro.rc.flightMode > 3500, sdk.ro.lowLevelError);
-      }
+      // share of the last period not spent asleep, interrupt handlers included
+      if(idleCycles > period)
+        idleCycles = period;
 
-      uint32_t newLoad = 1000-(idleIncrements*1000)/maxIdleIncrements;
+      uint32_t newLoad = 1000-(idleCycles*1000)/period;
       uint32_t prevLoad = HL_Status.cpu_load;
 
+      LoadShedUpdate(newLoad);
+
       HL_Status.cpu_load = (10*newLoad + 990*prevLoad)/1000;
 //      HL_Status.cpu_load = newLoad;
 
-      idleIncrements = 0;
+      idleCycles = 0;
     }
     else
     {
-      ++idleIncrements;
+      // time spent in commands and background jobs counts as load
+      if(!idleWork())
+        idleCycles += sleepUntilInterrupt();
     }
   }
 
   return 0;
 }
+#else
+// host drivers (host/sil, host/replay) run one pass of the 1kHz loop above
+// after each timer 0 interrupt
+void mainloopHostCycle(void)
+{
+  mainloopTrigger = 0;
+  mainloop();
+}
 
-void mainloop() //mainloop is triggered at 1 kHz
+// idle work of the loop above between two passes
+void mainloopHostIdle(void)
 {
-  static unsigned char led_cnt = 0, led_state = 1;
-  static int Firefly_led_fin_cnt = 0;
+  idleWork();
+}
+#endif
+
+// one degree of the field model per call
+#define DECLINATION_STEP_US 400
+
+static CONTEXT_LOCAL DeclinationJob declinationJob;
+static CONTEXT_LOCAL uint8_t declinationPending = 0;
+
+// getDeclination() takes several ms, computed in idle time
+static uint8_t declinationStep(void* pArg)
+{
+  DeclinationJob* pJob = (DeclinationJob*)pArg;
+
+  if(!getDeclinationStep(pJob))
+    return JOB_MORE;
+
+  int declination = pJob->declination;
+  if(declination < -32000)
+    declination = -32000;
+  if(declination > 32000)
+    declination = 32000;
+
+  estimatedDeclination = declination;
+  declinationAvailable = 1;
+  declinationPending = 0;
+
+  return JOB_DONE;
+}
+
+// LEDs, declination and GPS data hand-over to the SDK
+static void statusTask(void)
+{
+  static CONTEXT_LOCAL unsigned char led_cnt = 0, led_state = 1;
 
   //blink red led if no GPS lock available
   led_cnt++;
@@ -181,13 +286,12 @@ void mainloop() //mainloop is triggered at 1 kHz
     if((!declinationAvailable) && (gps.data.horizontalAccuracy < 10000) && gps.data.hasLock
         && (gps.dataUpdated)) //make sure GPS lock is valid
     {
-      int status;
-      estimatedDeclination = getDeclination(gps.data.latitude, gps.data.longitude, gps.data.height / 1000, 2014, &status);
-      if(estimatedDeclination < -32000)
-        estimatedDeclination = -32000;
-      if(estimatedDeclination > 32000)
-        estimatedDeclination = 32000;
-      declinationAvailable = 1;
+      if(!declinationPending)
+      {
+        getDeclinationStart(&declinationJob, gps.data.latitude, gps.data.longitude, gps.data.height / 1000, 2014);
+        if(!JobPost("declination", &declinationStep, &declinationJob, DECLINATION_STEP_US))
+          declinationPending = 1;
+      }
     }
   }
 
@@ -206,37 +310,104 @@ void mainloop() //mainloop is triggered at 1 kHz
     }
 
     memcpy(&sdk.ro.gps.raw, &gps.data, sizeof(GPSRawData));
+    SDKGroupUpdated(SDK_GROUP_GPS_RAW);
 
     gps.dataUpdated = 0;
   }
+}
 
-  //handle gps data reception
-  uBloxReceiveEngine();
+// newest LL frame into sdk.ro, outside of the SSP interrupt so that it cannot tear
+static void llRxTask(void)
+{
+  LLRxProcess();
+}
+
+// messages completed since the last pass, so that sdk and ll see new commands
+static void cmdTask(void)
+{
+#if UART0_FUNCTION == UART0_FUNCTION_COMM
+  ExtComFastPath();
+#endif
+}
 
-  //run SDK mainloop. Please put all your data handling / controller code in sdk.c
+// subscribers of updated sdk.ro groups first, then the user code
+static void sdkTask(void)
+{
+  SDKDispatchUpdates();
   SDKMainloop();
+}
 
-  //write data to transmit buffer for immediate transfer to LL processor
+//write data to transmit buffer for immediate transfer to LL processor
+static void llTask(void)
+{
   HL2LL_write_cycle();
+}
 
-  //control pan-tilt-unit ("cam option 4" @ AscTec Pelican and AscTec Firefly)
-  PTU_update();
-
+static void commTask(void)
+{
 #if UART0_FUNCTION == UART0_FUNCTION_TERMINAL
   TerminalSpinOnce();
 #else
   ExtComSpinOnce();
 #endif
+}
 
-  UART0SpinOnce();
+static void ptuTask(void)
+{
+  if(LoadShedAllow(LOAD_SHED_PTU))
+    PTU_update();
+}
 
-  //Firefly LED
-  if(SYSTEM_initialized && sdk.ro.isHexcopter)
-  {
-    if(++Firefly_led_fin_cnt == 10)
-    {
-      Firefly_led_fin_cnt = 0;
-      fireFlyLedHandler(gps.status);
-    }
-  }
+static void fireflyLedTask(void)
+{
+  if(SYSTEM_initialized && sdk.ro.isHexcopter && LoadShedAllow(LOAD_SHED_FIREFLY))
+    fireFlyLedHandler(gps.status);
+}
+
+static void buzzerTask(void)
+{
+  BuzzerHandler(HL_Status.battery_voltage_1, gps.data.hasLock,
+      sdk.ro.rc.flightMode > 3500, sdk.ro.lowLevelError);
+}
+
+// All periodic work of the main loop. Tasks of one tick run in priority order,
+// so the 1kHz chain llrx -> cmd -> gps -> sdk -> ll -> comm -> uart0 keeps its order. costUs
+// values are estimates used to stagger the 100Hz tasks onto different ticks.
+static const SchedulerTask mainTasks[] = {
+  // name      function             period phase                 prio costUs
+  { "llrx",    &llRxTask,            1,    0,                    0,   10 },
+  { "cmd",     &cmdTask,             1,    0,                    1,   10 },
+  { "status",  &statusTask,          1,    0,                    2,   10 },
+  { "gps",     &uBloxReceiveEngine,  1,    0,                    3,   20 },
+  { "sdk",     &sdkTask,             1,    0,                    4,   50 },
+  { "ll",      &llTask,              1,    0,                    5,   20 },
+  { "ptu",     &ptuTask,             10,   SCHEDULER_PHASE_AUTO, 6,   15 }, // pan-tilt-unit ("cam option 4" @ AscTec Pelican and AscTec Firefly)
+  { "comm",    &commTask,            1,    0,                    7,   100 },
+  { "uart0",   &UART0SpinOnce,       1,    0,                    8,   10 },
+  { "firefly", &fireflyLedTask,      10,   SCHEDULER_PHASE_AUTO, 9,   40 },
+  { "buzzer",  &buzzerTask,          10,   SCHEDULER_PHASE_AUTO, 10,  5 },
+  { "stack",   &StackMonitorTask,    100,  SCHEDULER_PHASE_AUTO, 11,  2 },
+};
+
+void mainloopInit(void)
+{
+  PhaseLockInit();
+  JobsInit();
+  StackMonitorInit();
+  LoadShedInit();
+  SlowChannelInit();
+  LLEventsInit();
+  JetiSyncInit();
+
+#if PROFILER_ENABLE
+  ProfilerInit();
+#endif
+
+  SchedulerInit(mainTasks, sizeof(mainTasks) / sizeof(mainTasks[0]));
+}
+
+void mainloop() //mainloop is triggered at 1 kHz
+{
+  //run all tasks released by timer 0. Please put all your data handling / controller code in sdk.c
+  SchedulerRun();
 }
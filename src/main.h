@@ -16,11 +16,18 @@
 
 #pragma once
 
+#include "context.h"
+
 extern void mainloop(void);
+extern void mainloopInit(void);
 extern void timer0ISR(void);
+#ifdef HOST_BUILD
+extern void mainloopHostCycle(void);
+extern void mainloopHostIdle(void);
+#endif
 
-extern volatile unsigned int GPS_timeout;
-extern volatile char SYSTEM_initialized;
+extern CONTEXT_LOCAL volatile unsigned int GPS_timeout;
+extern CONTEXT_LOCAL volatile char SYSTEM_initialized;
 
 #define ControllerCyclesPerSecond 	1000
 
@@ -0,0 +1,176 @@
+/*
+ * Copyright (C) 2017 Intel Deutschland GmbH, Germany
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "phase_lock.h"
+#include "LPC214x.h"
+#include "hal/sys_time.h"
+#include <string.h>
+
+#define LEAD_CYCLES   ((int32_t)(PHASE_LOCK_LEAD_US*(CPU_CLOCK_HZ/1000000)))
+#define WINDOW_CYCLES ((int32_t)(PHASE_LOCK_WINDOW_US*(CPU_CLOCK_HZ/1000000)))
+
+// T0MR0 never goes below the counter plus this, the match would be missed and
+// timer 0 would run through its full 32 bit range. Covers the instructions
+// from the last T0TC read to the T0MR0 write, with room for the VPB accesses.
+#define MIN_MARGIN_CYCLES ((int32_t)(2*(CPU_CLOCK_HZ/1000000)))
+
+// The SSP interrupt sees a frame only at FIFO half full, so arrivals scatter
+// by a few word times. The loop follows the latest arrival: a peak hold of the
+// phase error that decays by 1/4096 period per frame.
+#define PEAK_DECAY_DIV 4096
+
+// 1/4 of the peak error per frame, at most 1/16 period
+#define GAIN_DIV 4
+#define SLEW_DIV 16
+// integral gain 1/64, correction within +-2000ppm
+#define TRIM_SHIFT 6
+#define TRIM_DIV 500
+
+CONTEXT_LOCAL PhaseLock phaseLock;
+
+static inline int32_t clamp(int32_t value, int32_t limit)
+{
+  if(value > limit)
+    return limit;
+  if(value < -limit)
+    return -limit;
+
+  return value;
+}
+
+void PhaseLockResetStat(void)
+{
+  memset(&phaseLock.stat, 0, sizeof(PhaseLockStat));
+  phaseLock.stat.minError = INT32_MAX;
+  phaseLock.stat.maxError = INT32_MIN;
+  phaseLock.stat.minLatency = UINT32_MAX;
+}
+
+void PhaseLockInit(void)
+{
+  memset(&phaseLock, 0, sizeof(PhaseLock));
+  phaseLock.nominalMatch = T0MR0;
+
+  // no divisions in the SSP interrupt
+  phaseLock.period = phaseLock.nominalMatch + 1;
+  phaseLock.maxTrim = phaseLock.period/TRIM_DIV;
+  phaseLock.maxCorrection = phaseLock.period/SLEW_DIV;
+  phaseLock.peakDecay = phaseLock.period/PEAK_DECAY_DIV;
+
+  PhaseLockResetStat();
+  PhaseLockEnable(PHASE_LOCK_ENABLE);
+}
+
+void PhaseLockEnable(uint8_t enable)
+{
+  phaseLock.enabled = 0;
+  phaseLock.locked = 0;
+  phaseLock.trimSum = 0;
+  phaseLock.trim = 0;
+  phaseLock.peak = INT32_MIN/2;
+
+  T0MR0 = phaseLock.nominalMatch;
+
+  phaseLock.enabled = enable;
+}
+
+void PhaseLockTick(void)
+{
+  phaseLock.locked = phaseLock.enabled && phaseLock.frameSeen
+      && phaseLock.peak < WINDOW_CYCLES && phaseLock.peak > -WINDOW_CYCLES;
+  phaseLock.frameSeen = 0;
+
+  // drop the phase correction of the last frame, keep the learned rate
+  if(phaseLock.enabled)
+    T0MR0 = phaseLock.nominalMatch + phaseLock.trim;
+}
+
+void PhaseLockFrame(void)
+{
+  uint32_t tc = T0TC;
+
+  phaseLock.frameCycles = T1TC;
+  phaseLock.frameFresh = 1;
+
+  // arrival relative to LEAD_CYCLES before the end of a nominal period
+  const int32_t period = phaseLock.period;
+  int32_t error = (int32_t)tc - (period - LEAD_CYCLES);
+
+  if(error > (period >> 1))
+    error -= period;
+  else if(error < -(period >> 1))
+    error += period;
+
+  phaseLock.error = error;
+  phaseLock.frameSeen = 1;
+
+  ++phaseLock.stat.frames;
+  if(error < phaseLock.stat.minError)
+    phaseLock.stat.minError = error;
+  if(error > phaseLock.stat.maxError)
+    phaseLock.stat.maxError = error;
+
+  if(!phaseLock.enabled)
+    return;
+
+  phaseLock.peak -= phaseLock.peakDecay;
+  if(error > phaseLock.peak)
+    phaseLock.peak = error;
+
+  phaseLock.trimSum = clamp(phaseLock.trimSum + phaseLock.peak, phaseLock.maxTrim << TRIM_SHIFT);
+  phaseLock.trim = phaseLock.trimSum / (1 << TRIM_SHIFT);
+
+  // a late frame lengthens the current period, an early one shortens it
+  int32_t correction = clamp(phaseLock.peak/GAIN_DIV, phaseLock.maxCorrection);
+  uint32_t match = phaseLock.nominalMatch + phaseLock.trim + correction;
+
+  // the counter moved on since the arrival, check against its current value
+  tc = T0TC;
+  if(match < tc + MIN_MARGIN_CYCLES)
+    match = tc + MIN_MARGIN_CYCLES;
+
+  T0MR0 = match;
+
+  // delayed after all (FIQ, flash wait states): the counter has passed the
+  // match and would wrap, end the period one nominal period from now instead
+  tc = T0TC;
+  if(tc > match)
+  {
+    match = tc + period;
+    T0MR0 = match;
+  }
+
+  correction = match - phaseLock.nominalMatch - phaseLock.trim;
+
+  // following frames arrive earlier by the shift of the next tick
+  phaseLock.peak -= correction;
+}
+
+void PhaseLockCommandWritten(void)
+{
+  if(!phaseLock.frameFresh)
+    return;
+
+  uint32_t latency = SysTimeCyclesBetween(phaseLock.frameCycles, T1TC);
+  phaseLock.frameFresh = 0;
+
+  ++phaseLock.stat.commands;
+  phaseLock.stat.sumLatency += latency;
+  if(latency < phaseLock.stat.minLatency)
+    phaseLock.stat.minLatency = latency;
+  if(latency > phaseLock.stat.maxLatency)
+    phaseLock.stat.maxLatency = latency;
+}
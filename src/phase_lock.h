@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2017 Intel Deutschland GmbH, Germany
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "config.h"
+#include "context.h"
+#include <stdint.h>
+
+// Phase lock of the 1kHz timer 0 to the LL frames.
+// Free running, timer 0 has an arbitrary and drifting phase to the LL loop,
+// so SDKMainloop() sees attitude data that is up to one period old. When
+// enabled, every valid LL frame measures the timer 0 phase at its arrival and
+// moves T0MR0 so that the next main loop cycle starts PHASE_LOCK_LEAD_US after
+// the frame. A proportional term pulls the phase, an integral term learns the
+// clock difference to the LL. Without frames timer 0 runs at the learned rate.
+//
+// The frame to SSPWriteToLL() latency is measured with and without the lock.
+
+#define PHASE_LOCK_LEAD_US   20
+#define PHASE_LOCK_WINDOW_US 10   // locked while the phase error stays within this
+
+typedef struct _PhaseLockStat
+{
+  uint32_t frames;
+  int32_t minError;           // [cycles], frame arrival relative to the target phase
+  int32_t maxError;
+  uint32_t commands;          // commands written with a fresh frame
+  uint32_t minLatency;        // frame -> SSPWriteToLL() [cycles]
+  uint32_t maxLatency;
+  uint64_t sumLatency;
+} PhaseLockStat;
+
+typedef struct _PhaseLock
+{
+  uint8_t enabled;
+  uint8_t locked;
+  uint8_t frameSeen;          // frame in the current timer 0 period
+  volatile uint8_t frameFresh;  // frame not yet used by a command
+  uint32_t nominalMatch;      // T0MR0 of the free running timer 0
+  int32_t period;             // nominalMatch + 1 [cycles]
+  int32_t maxTrim;            // limits derived from the period, fixed at init
+  int32_t maxCorrection;
+  int32_t peakDecay;
+  int32_t trimSum;            // integral of the phase error
+  int32_t trim;               // period correction [cycles]
+  int32_t error;              // last phase error [cycles]
+  int32_t peak;               // decaying maximum of the phase error [cycles]
+  volatile uint32_t frameCycles;  // timer 1 at the last frame
+  PhaseLockStat stat;
+} PhaseLock;
+
+extern CONTEXT_LOCAL PhaseLock phaseLock;
+
+// timer 0 must be running, starts enabled with PHASE_LOCK_ENABLE
+void PhaseLockInit(void);
+void PhaseLockEnable(uint8_t enable);
+void PhaseLockResetStat(void);
+
+// timer 0 interrupt
+void PhaseLockTick(void);
+
+// SSP interrupt, valid LL frame received
+void PhaseLockFrame(void);
+
+// main loop, command frame handed to SSPWriteToLL()
+void PhaseLockCommandWritten(void);
@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2017 Intel Deutschland GmbH, Germany
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "profiler.h"
+
+#if PROFILER_ENABLE
+
+#include "hal/sys_time.h"
+#include <string.h>
+
+CONTEXT_LOCAL Profiler profiler;
+
+static uint8_t histBucket(uint32_t cycles)
+{
+  if(cycles < (1UL << PROFILER_HIST_MIN_BITS))
+    return cycles >> (PROFILER_HIST_MIN_BITS - PROFILER_HIST_SUB_BITS);
+
+  uint8_t msb = 31 - __builtin_clz(cycles);
+  uint32_t bucket = ((msb - PROFILER_HIST_MIN_BITS + 1) << PROFILER_HIST_SUB_BITS)
+      + ((cycles >> (msb - PROFILER_HIST_SUB_BITS)) & ((1 << PROFILER_HIST_SUB_BITS) - 1));
+
+  if(bucket >= PROFILER_HIST_BUCKETS)
+    bucket = PROFILER_HIST_BUCKETS - 1;
+
+  return bucket;
+}
+
+// first cycle count of the next bucket
+static uint32_t histUpperBound(uint8_t bucket)
+{
+  ++bucket;
+
+  if(bucket < (1 << PROFILER_HIST_SUB_BITS))
+    return (uint32_t)bucket << (PROFILER_HIST_MIN_BITS - PROFILER_HIST_SUB_BITS);
+
+  uint8_t msb = (bucket >> PROFILER_HIST_SUB_BITS) + PROFILER_HIST_MIN_BITS - 1;
+  uint32_t sub = bucket & ((1 << PROFILER_HIST_SUB_BITS) - 1);
+
+  return ((1UL << PROFILER_HIST_SUB_BITS) + sub) << (msb - PROFILER_HIST_SUB_BITS);
+}
+
+void ProfilerReset(void)
+{
+  memset(profiler.stage, 0, sizeof(profiler.stage));
+
+  for(uint8_t i = 0; i < PROFILER_NUM_STAGES; i++)
+    profiler.stage[i].minCycles = 0xFFFFFFFF;
+}
+
+void ProfilerInit(void)
+{
+  profiler.readCycles = 0;
+  profiler.overheadCycles = 0xFFFFFFFF;
+
+  uint32_t readCycles = 0xFFFFFFFF;
+
+  // take the fastest of a few runs, an interrupt may hit any of them
+  for(uint8_t i = 0; i < 8; i++)
+  {
+    uint32_t start = T1TC;
+    uint32_t end = T1TC;
+    uint32_t cycles = SysTimeCyclesBetween(start, end);
+
+    if(cycles < readCycles)
+      readCycles = cycles;
+  }
+
+  profiler.readCycles = readCycles;
+
+  for(uint8_t i = 0; i < 8; i++)
+  {
+    uint32_t start = T1TC;
+    PROFILER_START(t);
+    PROFILER_STOP(PROFILER_STAGE_LOOP, t);
+    uint32_t cycles = SysTimeCyclesBetween(start, T1TC);
+
+    if(cycles < profiler.overheadCycles)
+      profiler.overheadCycles = cycles;
+  }
+
+  if(profiler.overheadCycles > readCycles)
+    profiler.overheadCycles -= readCycles;
+  else
+    profiler.overheadCycles = 0;
+
+  ProfilerReset();
+}
+
+void ProfilerSample(uint8_t stage, uint32_t startCycles)
+{
+  uint32_t cycles = SysTimeCyclesBetween(startCycles, T1TC);
+  ProfilerStage* pStage = &profiler.stage[stage];
+
+  if(cycles > profiler.readCycles)
+    cycles -= profiler.readCycles;
+  else
+    cycles = 0;
+
+  ++pStage->count;
+  pStage->sumCycles += cycles;
+
+  if(cycles < pStage->minCycles)
+    pStage->minCycles = cycles;
+  if(cycles > pStage->maxCycles)
+    pStage->maxCycles = cycles;
+
+  uint8_t bucket = histBucket(cycles);
+
+  if(pStage->hist[bucket] == 0xFFFF)
+  {
+    for(uint8_t i = 0; i < PROFILER_HIST_BUCKETS; i++)
+      pStage->hist[i] >>= 1;
+  }
+
+  ++pStage->hist[bucket];
+}
+
+uint8_t ProfilerNumStages(void)
+{
+  return scheduler.numTasks + 1;
+}
+
+const char* ProfilerGetStats(uint8_t index, ProfilerStats* pStats)
+{
+  const char* pName;
+  uint8_t stage;
+
+  if(index < scheduler.numTasks)
+  {
+    pName = scheduler.pTasks[index].pName;
+    stage = index;
+  }
+  else if(index == scheduler.numTasks)
+  {
+    pName = "loop";
+    stage = PROFILER_STAGE_LOOP;
+  }
+  else
+  {
+    return 0;
+  }
+
+  const ProfilerStage* pStage = &profiler.stage[stage];
+
+  memset(pStats, 0, sizeof(ProfilerStats));
+
+  if(pStage->count == 0)
+    return pName;
+
+  pStats->count = pStage->count;
+  pStats->minCycles = pStage->minCycles;
+  pStats->maxCycles = pStage->maxCycles;
+  pStats->meanCycles = pStage->sumCycles / pStage->count;
+
+  uint32_t total = 0;
+  for(uint8_t i = 0; i < PROFILER_HIST_BUCKETS; i++)
+    total += pStage->hist[i];
+
+  uint32_t needed = total - total/100;
+  uint32_t sum = 0;
+
+  pStats->p99Cycles = pStage->maxCycles;
+
+  for(uint8_t i = 0; i < PROFILER_HIST_BUCKETS; i++)
+  {
+    sum += pStage->hist[i];
+
+    if(sum >= needed)
+    {
+      if(i == PROFILER_HIST_BUCKETS - 1)
+        break;
+
+      uint32_t upper = histUpperBound(i) - 1;
+      if(upper < pStats->p99Cycles)
+        pStats->p99Cycles = upper;
+      break;
+    }
+  }
+
+  return pName;
+}
+
+#endif
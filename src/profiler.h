@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2017 Intel Deutschland GmbH, Germany
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "config.h"
+#include "context.h"
+#include "scheduler.h"
+#include <stdint.h>
+
+// Execution time profiler for the main loop.
+// SchedulerRun() times every task and the complete pass with timer 1, which
+// counts CPU cycles and wraps once per second. Each stage keeps count, min,
+// max, the sum for the mean and a log-linear histogram for the p99.
+// Interrupts that preempt a stage are included in its time.
+//
+// Histogram: 4 buckets per octave, linear below 2^PROFILER_HIST_MIN_BITS cycles,
+// the last bucket collects everything above ~2.2ms. A bucket about to overflow
+// halves the whole histogram of its stage, so percentiles stay valid.
+
+#define PROFILER_NUM_STAGES (SCHEDULER_MAX_TASKS+1)
+#define PROFILER_STAGE_LOOP SCHEDULER_MAX_TASKS
+
+#define PROFILER_HIST_SUB_BITS 2
+#define PROFILER_HIST_MIN_BITS 6
+#define PROFILER_HIST_BUCKETS 48
+
+typedef struct _ProfilerStage
+{
+  uint32_t count;
+  uint32_t minCycles;
+  uint32_t maxCycles;
+  uint64_t sumCycles;
+  uint16_t hist[PROFILER_HIST_BUCKETS];
+} ProfilerStage;
+
+typedef struct _Profiler
+{
+  uint32_t readCycles;      // cost of one timer read, subtracted from every sample
+  uint32_t overheadCycles;  // cost of one PROFILER_START/PROFILER_STOP pair
+  ProfilerStage stage[PROFILER_NUM_STAGES];
+} Profiler;
+
+typedef struct _ProfilerStats
+{
+  uint32_t count;
+  uint32_t minCycles;
+  uint32_t meanCycles;
+  uint32_t p99Cycles;       // upper bound of the p99 bucket
+  uint32_t maxCycles;
+} ProfilerStats;
+
+#if PROFILER_ENABLE
+
+#include "LPC214x.h"
+
+extern CONTEXT_LOCAL Profiler profiler;
+
+// measures the instrumentation overhead, timer 1 must be running
+void ProfilerInit(void);
+void ProfilerReset(void);
+
+void ProfilerSample(uint8_t stage, uint32_t startCycles);
+
+// Reported stages are the scheduler tasks in table order followed by "loop".
+uint8_t ProfilerNumStages(void);
+
+// Returns the stage name, 0 for an invalid index.
+const char* ProfilerGetStats(uint8_t index, ProfilerStats* pStats);
+
+#define PROFILER_START(t) uint32_t t = T1TC
+#define PROFILER_STOP(stage, t) ProfilerSample(stage, t)
+
+#else
+
+#define PROFILER_START(t)
+#define PROFILER_STOP(stage, t)
+
+#endif
@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2017 Intel Deutschland GmbH, Germany
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "scheduler.h"
+#include "profiler.h"
+#include "trace.h"
+#include <string.h>
+
+CONTEXT_LOCAL Scheduler scheduler;
+
+// estimated cost of tick t for all tasks already placed
+static uint16_t tickCost(uint16_t t, const uint8_t* pPlaced, uint8_t numPlaced)
+{
+  uint16_t cost = 0;
+
+  for(uint8_t i = 0; i < numPlaced; i++)
+  {
+    const SchedulerTask* pTask = &scheduler.pTasks[pPlaced[i]];
+
+    if(t >= scheduler.state[pPlaced[i]].phase && (t - scheduler.state[pPlaced[i]].phase) % pTask->period == 0)
+      cost += pTask->costUs;
+  }
+
+  return cost;
+}
+
+// Greedy placement: most expensive task first, each at the phase that keeps
+// the worst of its own release ticks lowest. Runs once at startup.
+static void staggerPhases(void)
+{
+  uint8_t placed[SCHEDULER_MAX_TASKS];
+  uint8_t numPlaced = 0;
+  uint8_t done[SCHEDULER_MAX_TASKS] = { 0 };
+
+  // fixed phases first
+  for(uint8_t i = 0; i < scheduler.numTasks; i++)
+  {
+    if(scheduler.pTasks[i].phase != SCHEDULER_PHASE_AUTO)
+    {
+      scheduler.state[i].phase = scheduler.pTasks[i].phase % scheduler.pTasks[i].period;
+      placed[numPlaced++] = i;
+      done[i] = 1;
+    }
+  }
+
+  while(numPlaced < scheduler.numTasks)
+  {
+    uint8_t next = 0xFF;
+
+    for(uint8_t i = 0; i < scheduler.numTasks; i++)
+    {
+      if(!done[i] && (next == 0xFF || scheduler.pTasks[i].costUs > scheduler.pTasks[next].costUs))
+        next = i;
+    }
+
+    const SchedulerTask* pTask = &scheduler.pTasks[next];
+    uint16_t bestPhase = 0;
+    uint16_t bestCost = 0xFFFF;
+
+    for(uint16_t phase = 0; phase < pTask->period; phase++)
+    {
+      uint16_t worst = 0;
+
+      for(uint16_t t = phase; t < SCHEDULER_HYPERPERIOD; t += pTask->period)
+      {
+        uint16_t cost = tickCost(t, placed, numPlaced);
+        if(cost > worst)
+          worst = cost;
+      }
+
+      if(worst < bestCost)
+      {
+        bestCost = worst;
+        bestPhase = phase;
+      }
+    }
+
+    scheduler.state[next].phase = bestPhase;
+    placed[numPlaced++] = next;
+    done[next] = 1;
+  }
+
+  scheduler.worstTickCostUs = 0;
+  for(uint16_t t = 0; t < SCHEDULER_HYPERPERIOD; t++)
+  {
+    uint16_t cost = tickCost(t, placed, numPlaced);
+    if(cost > scheduler.worstTickCostUs)
+      scheduler.worstTickCostUs = cost;
+  }
+}
+
+void SchedulerInit(const SchedulerTask* pTasks, uint8_t numTasks)
+{
+  if(numTasks > SCHEDULER_MAX_TASKS)
+    numTasks = SCHEDULER_MAX_TASKS;
+
+  // timer 0 is already running, keep SchedulerTick() idle until the table is ready
+  scheduler.numTasks = 0;
+
+  memset(scheduler.state, 0, sizeof(scheduler.state));
+  scheduler.pTasks = pTasks;
+
+  // staggerPhases() and the priority sort work on the full table
+  scheduler.numTasks = numTasks;
+  staggerPhases();
+  scheduler.numTasks = 0;
+
+  for(uint8_t i = 0; i < numTasks; i++)
+  {
+    uint8_t pos = i;
+
+    while(pos > 0 && pTasks[scheduler.order[pos-1]].priority > pTasks[i].priority)
+    {
+      scheduler.order[pos] = scheduler.order[pos-1];
+      --pos;
+    }
+
+    scheduler.order[pos] = i;
+    scheduler.state[i].countdown = scheduler.state[i].phase + 1;
+  }
+
+  scheduler.numTasks = numTasks;
+}
+
+void SchedulerTick(void)
+{
+  for(uint8_t i = 0; i < scheduler.numTasks; i++)
+  {
+    SchedulerTaskState* pState = &scheduler.state[i];
+
+    if(--pState->countdown)
+      continue;
+
+    pState->countdown = scheduler.pTasks[i].period;
+    ++pState->releases;
+
+    if(pState->pending)
+      ++pState->overruns;
+    else
+      pState->pending = 1;
+  }
+}
+
+void SchedulerRun(void)
+{
+  PROFILER_START(loopStart);
+
+  for(uint8_t i = 0; i < scheduler.numTasks; i++)
+  {
+    uint8_t task = scheduler.order[i];
+
+    if(!scheduler.state[task].pending)
+      continue;
+
+    scheduler.state[task].pending = 0;
+
+    TRACE(TRACE_EV_TASK_BEGIN, task);
+    PROFILER_START(start);
+    (*scheduler.pTasks[task].pFunc)();
+    PROFILER_STOP(task, start);
+    TRACE(TRACE_EV_TASK_END, task);
+  }
+
+  PROFILER_STOP(PROFILER_STAGE_LOOP, loopStart);
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2017 Intel Deutschland GmbH, Germany
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "context.h"
+#include <stdint.h>
+
+// Rate-group scheduler for the main loop.
+// Timer 0 releases the tasks of a static table at their rate, the main loop
+// runs all released tasks in priority order. Tasks with the same rate can be
+// spread over different ticks by their phase to keep the worst tick short.
+
+#define SCHEDULER_MAX_TASKS 16
+
+// window used to stagger phases, must be a multiple of all task periods
+#define SCHEDULER_HYPERPERIOD 1000
+
+#define SCHEDULER_PHASE_AUTO 0xFFFF
+
+typedef void(*SchedulerFunc)(void);
+
+typedef struct _SchedulerTask
+{
+  const char* pName;
+  SchedulerFunc pFunc;
+  uint16_t period;    // [timer 0 ticks], 1 = 1kHz
+  uint16_t phase;     // [timer 0 ticks], SCHEDULER_PHASE_AUTO = chosen by SchedulerInit()
+  uint8_t priority;   // lower runs first within one tick
+  uint16_t costUs;    // estimated execution time, used for automatic phases
+} SchedulerTask;
+
+typedef struct _SchedulerTaskState
+{
+  uint16_t phase;
+  uint16_t countdown;       // ticks until the next release
+  volatile uint8_t pending;
+  uint32_t releases;
+  uint32_t overruns;        // releases while the previous one had not run yet
+} SchedulerTaskState;
+
+typedef struct _Scheduler
+{
+  const SchedulerTask* pTasks;
+  uint8_t numTasks;
+  uint8_t order[SCHEDULER_MAX_TASKS];   // task indices by priority
+  uint16_t worstTickCostUs;             // estimated, for the chosen phases
+  SchedulerTaskState state[SCHEDULER_MAX_TASKS];
+} Scheduler;
+
+extern CONTEXT_LOCAL Scheduler scheduler;
+
+void SchedulerInit(const SchedulerTask* pTasks, uint8_t numTasks);
+
+// timer 0 interrupt
+void SchedulerTick(void);
+
+// main loop, runs all released tasks
+void SchedulerRun(void);
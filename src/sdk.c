@@ -27,6 +27,7 @@
 #include "examples/gps_waypoints.h"
 #include "examples/motor_on_off.h"
 #include "examples/terminal_print.h"
+#include "examples/update_callbacks.h"
 
 /******** SDK in general ************
  * You can find further information about the AscTec SDK in our AscTec Wiki: http://wiki.asctec.de
@@ -44,6 +45,9 @@
 void SDKInit(void)
 {
   // Implement initialization of your variables or commands here.
+
+//  Subscribe to sdk.ro updates here, see SDKSubscribe() and this example.
+//  ExampleUpdateCallbacksInit();
 }
 
 void SDKMainloop(void)
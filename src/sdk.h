@@ -18,6 +18,7 @@
 
 #include <stdint.h>
 #include "asctec_uav_msgs/transport_definitions.h"
+#include "context.h"
 
 typedef struct _WaypointExample
 {
@@ -27,9 +28,10 @@ typedef struct _WaypointExample
   uint16_t state;
 } WaypointExample;
 
-extern WaypointExample wpExample;
+extern CONTEXT_LOCAL WaypointExample wpExample;
 
-// SDKInit gets called once during startup.
+// SDKInit gets called once during startup, after the main loop modules
+// (slow channel, jobs, LL events) are initialized.
 void SDKInit(void);
 
 // SDKMainloop is called regularly at 1kHz
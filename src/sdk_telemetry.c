@@ -26,10 +26,36 @@
 #include "sdk.h"
 #include "sdkio.h"
 #include "util/fastmath.h"
+#include "context.h"
+#include "jobs.h"
+#include "load_shed.h"
 
-void SDK_jetiAscTecExampleUpdateDisplay(unsigned char state)
+static CONTEXT_LOCAL uint8_t waypointTextPending = 0;
+static CONTEXT_LOCAL unsigned char shownState = 0;  // last state passed to the display
+
+// snprintf() takes too long for the 1kHz loop, formatted in idle time
+static uint8_t waypointTextJob(void* pArg)
 {
+  (void)pArg;
+
   char text[33]; // Line	  11111111111111112222222222222222
+
+  waypointTextPending = 0;
+
+  // a key press switched to another screen since the job was posted
+  if(shownState != 6)
+    return JOB_DONE;
+
+  snprintf(text, 33, "WP Act. v=Stop  WP# %1i, Dist: %2im", wpExample.wpNr, sdk.ro.waypoint.distanceToWp / 1000);
+  jetiSetTextDisplay(text);
+
+  return JOB_DONE;
+}
+
+void SDK_jetiAscTecExampleUpdateDisplay(unsigned char state)
+{
+  shownState = state;
+
   switch(state)
   {
     case 0:
@@ -61,15 +87,15 @@ void SDK_jetiAscTecExampleUpdateDisplay(unsigned char state)
       jetiSetTextDisplay("EmMode v=Set  <>Come Home High");
       break;
     case 6:
-      snprintf(text, 33, "WP Act. v=Stop  WP# %1i, Dist: %2im", wpExample.wpNr, sdk.ro.waypoint.distanceToWp / 1000);
-      jetiSetTextDisplay(text);
+      if(!waypointTextPending && !JobPost("jeti", &waypointTextJob, 0, 100))
+        waypointTextPending = 1;
       break;
   }
 }
 
 void SDK_jetiAscTecExampleKeyChange(unsigned char key)
 {
-  static unsigned char displayState = 0;
+  static CONTEXT_LOCAL unsigned char displayState = 0;
 
   switch(displayState)
   {
@@ -249,10 +275,13 @@ void SDK_jetiAscTecExampleRun(void)
   int speed;
   int gps_quality;
   unsigned char key;
-  static unsigned char first = 0;
-  static float voltageFilter = 12.6f;
+  static CONTEXT_LOCAL unsigned char first = 0;
+  static CONTEXT_LOCAL float voltageFilter = 12.6f;
   //counter for updating the jeti display regularly
-  static unsigned char jetiDisplayUpdateCnt = 0;
+  static CONTEXT_LOCAL unsigned char jetiDisplayUpdateCnt = 0;
+
+  if(!LoadShedAllow(LOAD_SHED_JETI))
+    return;
 
   if(!first)
   {
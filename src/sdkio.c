@@ -20,13 +20,30 @@
 #include "hal/system.h"
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 #include "sdkio.h"
 
 #include "hal/jeti_telemetry.h"
 #include "hal/uart1.h"
 #include "ll_hl_comm.h"
+#include "slow_channel.h"
+#include "ll_events.h"
+#include "ll_convert.h"
+#include "context.h"
 
-SDKData sdk;
+CONTEXT_LOCAL SDKData sdk;
+
+static CONTEXT_LOCAL LLEventReader sdkEventReader;
+
+typedef struct _SDKSubscriber
+{
+  SDKUpdateFunc func;
+  uint8_t groupMask;
+} SDKSubscriber;
+
+static CONTEXT_LOCAL SDKSubscriber sdkSubscribers[SDK_MAX_SUBSCRIBERS];
+static CONTEXT_LOCAL uint8_t sdkNumSubscribers;
+static CONTEXT_LOCAL uint32_t sdkDispatchedSeq[SDK_NUM_GROUPS];
 
 #define LL_STATUS_FLIGHT_MODE_MASK         0x07
 #define LL_STATUS_SERIAL_INTERFACE_ENABLED 0x20
@@ -66,6 +83,8 @@ void SDKParseLLData(struct LL_ATTITUDE_DATA* pLL)
   sdk.ro.attitude.angularVelocity[1] = pLL->angvel_pitch*15;
   sdk.ro.attitude.angularVelocity[2] = pLL->angvel_yaw*15;
 
+  ++sdk.ro.updateSeq[SDK_GROUP_ATTITUDE];
+
   switch(current_page)
   {
     case 0:
@@ -83,12 +102,14 @@ void SDKParseLLData(struct LL_ATTITUDE_DATA* pLL)
       sdk.ro.rc.flightMode = sdk.ro.rc.channels[5];
       sdk.ro.rc.aux = sdk.ro.rc.channels[6];
 
-      sdk.ro.sensors.acc[0] = (pLL->acc_x*981)/100;
-      sdk.ro.sensors.acc[1] = (pLL->acc_y*981)/100;
-      sdk.ro.sensors.acc[2] = (pLL->acc_z*981)/100;
+      sdk.ro.sensors.acc[0] = LLConvAcc(pLL->acc_x);
+      sdk.ro.sensors.acc[1] = LLConvAcc(pLL->acc_y);
+      sdk.ro.sensors.acc[2] = LLConvAcc(pLL->acc_z);
 
       sdk.ro.gps.latitude = pLL->latitude_best_estimate;
       sdk.ro.gps.longitude = pLL->longitude_best_estimate;
+
+      ++sdk.ro.updateSeq[SDK_GROUP_RC_ACC];
     }
     break;
     case 1:
@@ -104,6 +125,8 @@ void SDKParseLLData(struct LL_ATTITUDE_DATA* pLL)
         sdk.ro.motors.speed[i] = ((int32_t)pLL->motor_data[i + 8])*64;
         sdk.ro.motors.pwm[i] = ((int32_t)pLL->motor_data[i]);
       }
+
+      ++sdk.ro.updateSeq[SDK_GROUP_HEIGHT_MOTORS];
     }
     break;
     case 2:
@@ -179,6 +202,20 @@ void SDKParseLLData(struct LL_ATTITUDE_DATA* pLL)
           sdk.ro.emergencyMode = pLL->slowDataUpChannelDataShort;
           break;
       }
+
+      SlowChannelAck(slowDataUpChannelSelect, pLL->slowDataUpChannelDataShort);
+
+      if(slowDataUpChannelSelect != SUDC_NONE)
+      {
+        uint32_t eventSeq = llEvents.seq;
+
+        LLEventsUpdate(slowDataUpChannelSelect, pLL->slowDataUpChannelDataShort, sdk.ro.sampleTimeUs.page[2]);
+
+        if(llEvents.seq != eventSeq)
+          ++sdk.ro.updateSeq[SDK_GROUP_EVENTS];
+      }
+
+      ++sdk.ro.updateSeq[SDK_GROUP_MAG_STATUS];
     }
     break;
     default:
@@ -212,12 +249,12 @@ void SDKFillLLCommands(struct LL_CONTROL_INPUT* pCtrl)
         if(sdk.ro.isHexcopter)
         {
           // Firefly
-          out = (4*rpm-500)/175;
+          out = LLConvMotorCmdFirefly(rpm);
         }
         else
         {
           // Hummingbird or Pelican
-          out = (8*rpm-8600)/301;
+          out = LLConvMotorCmd(rpm);
         }
 
         if(out < 1)
@@ -243,13 +280,9 @@ void SDKFillLLCommands(struct LL_CONTROL_INPUT* pCtrl)
       pCtrl->system_flags &= ~(SF_DIRECT_MOTOR_CONTROL | SF_DIRECT_MOTOR_CONTROL_INDIVIDUAL | SF_WAYPOINT_MODE);
 
       pCtrl->ctrl_flags = 0x0F;
-      pCtrl->pitch = (sdk.cmd.RPYThrust.pitchAngle*2048)/52000;
-      pCtrl->roll = (sdk.cmd.RPYThrust.rollAngle*2048)/52000;
-#if VEHICLE_TYPE == VEHICLE_TYPE_HUMMINGBIRD
-      pCtrl->yaw = (sdk.cmd.RPYThrust.yawRate*2048)/300000;
-#else
-      pCtrl->yaw = (sdk.cmd.RPYThrust.yawRate*2048)/200000;
-#endif
+      pCtrl->pitch = LLConvAngleCmd(sdk.cmd.RPYThrust.pitchAngle);
+      pCtrl->roll = LLConvAngleCmd(sdk.cmd.RPYThrust.rollAngle);
+      pCtrl->yaw = LLConvYawRateCmd(sdk.cmd.RPYThrust.yawRate);
       pCtrl->thrust = sdk.cmd.RPYThrust.thrust;
     }
     break;
@@ -259,14 +292,10 @@ void SDKFillLLCommands(struct LL_CONTROL_INPUT* pCtrl)
       pCtrl->system_flags &= ~(SF_DIRECT_MOTOR_CONTROL | SF_DIRECT_MOTOR_CONTROL_INDIVIDUAL | SF_WAYPOINT_MODE);
 
       pCtrl->ctrl_flags = 0x1F;
-      pCtrl->pitch = (sdk.cmd.RPYClimbRate.pitchAngle*2048)/52000;
-      pCtrl->roll = (sdk.cmd.RPYClimbRate.rollAngle*2048)/52000;
-#if VEHICLE_TYPE == VEHICLE_TYPE_HUMMINGBIRD
-      pCtrl->yaw = (sdk.cmd.RPYClimbRate.yawRate*2048)/300000;
-#else
-      pCtrl->yaw = (sdk.cmd.RPYClimbRate.yawRate*2048)/200000;
-#endif
-      pCtrl->thrust = ((sdk.cmd.RPYClimbRate.climbRate+2000)*4096)/4000;
+      pCtrl->pitch = LLConvAngleCmd(sdk.cmd.RPYClimbRate.pitchAngle);
+      pCtrl->roll = LLConvAngleCmd(sdk.cmd.RPYClimbRate.rollAngle);
+      pCtrl->yaw = LLConvYawRateCmd(sdk.cmd.RPYClimbRate.yawRate);
+      pCtrl->thrust = LLConvClimbRateCmd(sdk.cmd.RPYClimbRate.climbRate);
     }
     break;
     case SDK_CMD_MODE_LOCAL_VEL_WITH_GPS:
@@ -275,14 +304,10 @@ void SDKFillLLCommands(struct LL_CONTROL_INPUT* pCtrl)
       pCtrl->system_flags &= ~(SF_DIRECT_MOTOR_CONTROL | SF_DIRECT_MOTOR_CONTROL_INDIVIDUAL | SF_WAYPOINT_MODE);
 
       pCtrl->ctrl_flags = 0x3F;
-      pCtrl->pitch = (sdk.cmd.localVelWithGPS.speedForward*2048)/3000;
-      pCtrl->roll = (sdk.cmd.localVelWithGPS.speedRight*2048)/3000;
-#if VEHICLE_TYPE == VEHICLE_TYPE_HUMMINGBIRD
-      pCtrl->yaw = (sdk.cmd.localVelWithGPS.yawRate*2048)/300000;
-#else
-      pCtrl->yaw = (sdk.cmd.localVelWithGPS.yawRate*2048)/200000;
-#endif
-      pCtrl->thrust = ((sdk.cmd.localVelWithGPS.climbRate+2000)*4096)/4000;
+      pCtrl->pitch = LLConvSpeedCmd(sdk.cmd.localVelWithGPS.speedForward);
+      pCtrl->roll = LLConvSpeedCmd(sdk.cmd.localVelWithGPS.speedRight);
+      pCtrl->yaw = LLConvYawRateCmd(sdk.cmd.localVelWithGPS.yawRate);
+      pCtrl->thrust = LLConvClimbRateCmd(sdk.cmd.localVelWithGPS.climbRate);
     }
     break;
     case SDK_CMD_MODE_GPS_WAYPOINT_ABS:
@@ -453,6 +478,92 @@ void SDKPrintROData()
   printf("ACK trigger: %hu\n", (uint16_t)sdk.ro.waypoint.ackTrigger);
 }
 
+// Queues a value for the slow data channel to the LowLevel processor, select is one of
+// the SDC_ defines. With ackSelect (SUDC_ define) the value is repeated up to retries
+// times until the LL reports it on that up channel. Returns 1 if the queue is full.
+uint8_t SDKSlowChannelSend(uint8_t select, uint8_t dataChar, int16_t dataShort, uint8_t ackSelect, uint8_t retries)
+{
+  SlowChannelItem item;
+
+  memset(&item, 0, sizeof(item));
+  item.slot.select = select;
+  item.slot.dataChar = dataChar;
+  item.slot.dataShort = dataShort;
+  item.itemClass = SLOW_CHANNEL_CLASS_SDK;
+  item.priority = SLOW_CHANNEL_PRIO_SDK;
+  item.ackSelect = ackSelect;
+  item.retries = retries;
+  item.retryInterval = 5;
+
+  return SlowChannelPost(&item);
+}
+
+// Next change on the slow up channel from the LowLevel processor (see ll_events.h),
+// returns 0 if there is none. Events lost because they were not read in time are
+// counted in SDKEventsLost().
+uint8_t SDKNextEvent(LLEvent* pEvent)
+{
+  return LLEventRead(&sdkEventReader, pEvent);
+}
+
+uint32_t SDKEventsLost(void)
+{
+  return LLEventReaderLost(&sdkEventReader);
+}
+
+// Calls func once per update of each group in groupMask (SDK_GROUP_MASK()), right
+// before SDKMainloop() and with sdk.ro already updated. Call it from SDKInit().
+// If a group was updated more than once since the last call, seq skips. Returns 1
+// if all SDK_MAX_SUBSCRIBERS are taken, like SlowChannelPost() and JobPost().
+uint8_t SDKSubscribe(uint8_t groupMask, SDKUpdateFunc func)
+{
+  if(sdkNumSubscribers >= SDK_MAX_SUBSCRIBERS || !func)
+    return 1;
+
+  sdkSubscribers[sdkNumSubscribers].func = func;
+  sdkSubscribers[sdkNumSubscribers].groupMask = groupMask;
+  ++sdkNumSubscribers;
+
+  return 0;
+}
+
+// sdk.ro data of a group was written outside of SDKParseLLData()
+void SDKGroupUpdated(uint8_t group)
+{
+  ++sdk.ro.updateSeq[group];
+}
+
+void SDKDispatchUpdates(void)
+{
+  uint8_t updated = 0;
+
+  for(uint8_t group = 0; group < SDK_NUM_GROUPS; group++)
+  {
+    if(sdk.ro.updateSeq[group] != sdkDispatchedSeq[group])
+    {
+      sdkDispatchedSeq[group] = sdk.ro.updateSeq[group];
+      updated |= SDK_GROUP_MASK(group);
+    }
+  }
+
+  if(!updated)
+    return;
+
+  for(uint8_t i = 0; i < sdkNumSubscribers; i++)
+  {
+    uint8_t groups = updated & sdkSubscribers[i].groupMask;
+
+    for(uint8_t group = 0; groups; group++)
+    {
+      if(groups & SDK_GROUP_MASK(group))
+      {
+        groups &= ~SDK_GROUP_MASK(group);
+        sdkSubscribers[i].func(group, sdkDispatchedSeq[group]);
+      }
+    }
+  }
+}
+
 // Sets emergency mode on LowLevel processor. Select one of the EM_ defines as mode option.
 // See EM_ defines for details
 void SDKSetEmergencyMode(uint8_t mode)
@@ -19,7 +19,9 @@
 #include <stdint.h>
 #include "hal/ublox.h"
 #include "ll_hl_comm.h"
+#include "ll_events.h"
 #include "asctec_uav_msgs/message_definitions.h"
+#include "context.h"
 
 #define SDK_CMD_MODE_OFF                0
 #define SDK_CMD_MODE_DIMC               1
@@ -41,6 +43,22 @@
 #define EM_RETURN_AT_PREDEFINED_HEIGHT 0x04 //"come home"
 #define EM_RETURN_AT_MISSION_SUMMIT    0x08 //"come home high"
 
+// Data groups of sdk.ro, each with its own update sequence number in sdk.ro.updateSeq
+#define SDK_GROUP_ATTITUDE      0 // attitude, every LL frame (1kHz)
+#define SDK_GROUP_RC_ACC        1 // sensors.acc, rc, gps.latitude/longitude (LL page 0, 333Hz)
+#define SDK_GROUP_HEIGHT_MOTORS 2 // height, verticalSpeed, gps speeds, motors (LL page 1, 333Hz)
+#define SDK_GROUP_MAG_STATUS    3 // sensors.mag, battery, status and slow channel data (LL page 2, 333Hz)
+#define SDK_GROUP_GPS_RAW       4 // gps.raw (GPS rate, ~5Hz)
+#define SDK_GROUP_EVENTS        5 // new slow up channel events, read them with SDKNextEvent()
+#define SDK_NUM_GROUPS          6
+
+#define SDK_GROUP_MASK(group) (1 << (group))
+
+#define SDK_MAX_SUBSCRIBERS 8
+
+// Called from SDKDispatchUpdates() for a group in the subscription mask, seq is sdk.ro.updateSeq[group]
+typedef void(*SDKUpdateFunc)(uint8_t group, uint32_t seq);
+
 typedef struct _SDKData
 {
   struct _READONLY
@@ -139,6 +157,17 @@ typedef struct _SDKData
       int32_t distanceToWp; // ~60Hz, [mm]
       uint8_t ackTrigger; // set by LL if command is accepted
     } waypoint;
+
+    // arrival of the LL frame that carried the data [us since boot, see SysTimeLongUSec()]
+    struct
+    {
+      int64_t attitude;
+      int64_t page[3]; // 0: sensors.acc, rc, fused gps; 1: height, verticalSpeed, gps speeds, motors;
+                       // 2: sensors.mag, battery, status and slow channel data
+    } sampleTimeUs;
+
+    // incremented on every update of a group, see SDK_GROUP_* and SDKSubscribe()
+    uint32_t updateSeq[SDK_NUM_GROUPS];
   } ro;
 
   struct _WRITEONLY
@@ -206,9 +235,15 @@ typedef struct _SDKData
   } cmd;
 } SDKData;
 
-extern SDKData sdk;
+extern CONTEXT_LOCAL SDKData sdk;
 
 void SDKParseLLData(struct LL_ATTITUDE_DATA* pLL);
 void SDKFillLLCommands(struct LL_CONTROL_INPUT* pCtrl);
 void SDKSetEmergencyMode(uint8_t mode);
+uint8_t SDKSlowChannelSend(uint8_t select, uint8_t dataChar, int16_t dataShort, uint8_t ackSelect, uint8_t retries);
+uint8_t SDKNextEvent(LLEvent* pEvent);
+uint32_t SDKEventsLost(void);
+uint8_t SDKSubscribe(uint8_t groupMask, SDKUpdateFunc func);
+void SDKGroupUpdated(uint8_t group);
+void SDKDispatchUpdates(void);
 void SDKPrintROData();
@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2017 Intel Deutschland GmbH, Germany
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "slow_channel.h"
+#include "hal/sys_time.h"
+#include <string.h>
+
+CONTEXT_LOCAL SlowChannel slowChannel;
+
+static const char* const classNames[SLOW_CHANNEL_NUM_CLASSES] = SLOW_CHANNEL_CLASS_NAMES;
+
+static uint32_t usSincePost(const SlowChannelEntry* pEntry)
+{
+  return SysTimeCyclesToUSec(SysTimeCycles() - pEntry->postedCycles);
+}
+
+static void finish(SlowChannelEntry* pEntry, uint8_t ok)
+{
+  SlowChannelClassStat* pStat = &slowChannel.stat[pEntry->item.itemClass];
+
+  if(ok)
+  {
+    uint32_t us = usSincePost(pEntry);
+
+    ++pStat->done;
+    pStat->doneSumUs += us;
+    if(us > pStat->doneMaxUs)
+      pStat->doneMaxUs = us;
+  }
+  else
+  {
+    ++pStat->failed;
+  }
+
+  pEntry->used = 0;
+}
+
+void SlowChannelInit(void)
+{
+  memset(&slowChannel, 0, sizeof(SlowChannel));
+}
+
+uint8_t SlowChannelPost(const SlowChannelItem* pItem)
+{
+  SlowChannelEntry* pFree = 0;
+  uint8_t replace = 0;
+  uint8_t sdkUsed = 0;
+
+  for(uint8_t i = 0; i < SLOW_CHANNEL_MAX; i++)
+  {
+    SlowChannelEntry* pEntry = &slowChannel.entries[i];
+
+    if(!pEntry->used)
+    {
+      if(!pFree)
+        pFree = pEntry;
+    }
+    else if(!pItem->pFill && !pEntry->item.pFill && pEntry->item.slot.select == pItem->slot.select)
+    {
+      // newer value for the same select
+      pFree = pEntry;
+      replace = 1;
+      break;
+    }
+    else if(pEntry->item.itemClass == SLOW_CHANNEL_CLASS_SDK)
+    {
+      ++sdkUsed;
+    }
+  }
+
+  SlowChannelClassStat* pStat = &slowChannel.stat[pItem->itemClass];
+
+  if(!replace && pItem->itemClass == SLOW_CHANNEL_CLASS_SDK && sdkUsed >= SLOW_CHANNEL_MAX - SLOW_CHANNEL_RESERVED)
+    pFree = 0;
+
+  if(!pFree)
+  {
+    ++pStat->dropped;
+    return 1;
+  }
+
+  pFree->item = *pItem;
+  pFree->used = 1;
+  pFree->sends = 0;
+  pFree->wait = 0;
+  pFree->seq = slowChannel.seq++;
+  pFree->postedCycles = SysTimeCycles();
+
+  ++pStat->posted;
+
+  return 0;
+}
+
+uint8_t SlowChannelNext(SlowChannelSlot* pSlot)
+{
+  SlowChannelEntry* pBest = 0;
+
+  ++slowChannel.slots;
+
+  for(uint8_t i = 0; i < SLOW_CHANNEL_MAX; i++)
+  {
+    SlowChannelEntry* pEntry = &slowChannel.entries[i];
+
+    if(!pEntry->used)
+      continue;
+
+    if(pEntry->wait)
+    {
+      --pEntry->wait;
+      continue;
+    }
+
+    // the last retry had its time to be confirmed
+    if(pEntry->item.ackSelect && pEntry->item.retries != SLOW_CHANNEL_RETRY_FOREVER
+        && pEntry->sends >= pEntry->item.retries)
+    {
+      finish(pEntry, 0);
+      continue;
+    }
+
+    if(!pBest || pEntry->item.priority < pBest->item.priority
+        || (pEntry->item.priority == pBest->item.priority && (int32_t)(pEntry->seq - pBest->seq) < 0))
+      pBest = pEntry;
+  }
+
+  if(!pBest)
+  {
+    memset(pSlot, 0, sizeof(SlowChannelSlot));
+    ++slowChannel.idleSlots;
+    return 0;
+  }
+
+  if(!pBest->sends)
+  {
+    SlowChannelClassStat* pStat = &slowChannel.stat[pBest->item.itemClass];
+    uint32_t us = usSincePost(pBest);
+
+    ++pStat->started;
+    pStat->waitSumUs += us;
+    if(us > pStat->waitMaxUs)
+      pStat->waitMaxUs = us;
+  }
+
+  if(pBest->sends < 0xFE)
+    ++pBest->sends;
+
+  if(pBest->item.pFill)
+  {
+    if((*pBest->item.pFill)(pSlot, pBest->item.pArg))
+      finish(pBest, 1);
+  }
+  else
+  {
+    *pSlot = pBest->item.slot;
+
+    if(pBest->item.ackSelect)
+      pBest->wait = pBest->item.retryInterval;
+    else
+      finish(pBest, 1);
+  }
+
+  return 1;
+}
+
+void SlowChannelAck(uint8_t upSelect, int16_t value)
+{
+  for(uint8_t i = 0; i < SLOW_CHANNEL_MAX; i++)
+  {
+    SlowChannelEntry* pEntry = &slowChannel.entries[i];
+
+    if(pEntry->used && !pEntry->item.pFill && pEntry->sends && pEntry->item.ackSelect == upSelect
+        && pEntry->item.slot.dataShort == value)
+      finish(pEntry, 1);
+  }
+}
+
+const char* SlowChannelClassName(uint8_t itemClass)
+{
+  if(itemClass >= SLOW_CHANNEL_NUM_CLASSES)
+    return 0;
+
+  return classNames[itemClass];
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2017 Intel Deutschland GmbH, Germany
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "context.h"
+#include <stdint.h>
+
+// Priority queue for the slow data channel to the LL.
+// Every page 1 frame to the LL carries one slot: a select byte (SDC_*), a char
+// and a short. SlowChannelNext() fills each slot from the ready item with the
+// lowest priority value, the oldest one among equals, so long transfers like
+// the build info are interleaved with urgent items instead of blocking them.
+//
+// A single item sends its slot once. With ackSelect it is repeated every
+// retryInterval slots until the LL reports the same value on that SUDC_* up
+// channel, at most retries times. A stream item calls its fill function for
+// every slot until it returns 1.
+// Posting a single item with the select of a queued one replaces that one.
+// SDK items cannot take the last SLOW_CHANNEL_RESERVED entries, so they cannot
+// block the internal items.
+//
+// Main loop only, not for interrupts.
+
+#define SLOW_CHANNEL_MAX 8
+#define SLOW_CHANNEL_RESERVED 4     // em mode, declination, inclination, build info
+
+// item classes for the statistics
+#define SLOW_CHANNEL_CLASS_EM_MODE     0
+#define SLOW_CHANNEL_CLASS_DECLINATION 1
+#define SLOW_CHANNEL_CLASS_BUILD_INFO  2
+#define SLOW_CHANNEL_CLASS_SDK         3
+#define SLOW_CHANNEL_NUM_CLASSES       4
+
+#define SLOW_CHANNEL_CLASS_NAMES { "em mode", "declination", "build info", "sdk" }
+
+#define SLOW_CHANNEL_PRIO_EM_MODE     0
+#define SLOW_CHANNEL_PRIO_DECLINATION 1
+#define SLOW_CHANNEL_PRIO_SDK         2
+#define SLOW_CHANNEL_PRIO_BUILD_INFO  3
+
+#define SLOW_CHANNEL_RETRY_FOREVER 0xFF
+
+typedef struct _SlowChannelSlot
+{
+  uint8_t select;
+  uint8_t dataChar;
+  int16_t dataShort;
+} SlowChannelSlot;
+
+// fills the next slot of a stream, returns 1 with the last one
+typedef uint8_t(*SlowChannelFillFunc)(SlowChannelSlot* pSlot, void* pArg);
+
+typedef struct _SlowChannelItem
+{
+  SlowChannelSlot slot;       // single item
+  SlowChannelFillFunc pFill;  // stream item if set
+  void* pArg;
+  uint8_t itemClass;          // SLOW_CHANNEL_CLASS_*
+  uint8_t priority;           // lower goes first
+  uint8_t ackSelect;          // SUDC_* confirming slot.dataShort, 0 = done when sent
+  uint8_t retries;            // sends without confirmation, or SLOW_CHANNEL_RETRY_FOREVER
+  uint8_t retryInterval;      // slots between two sends
+} SlowChannelItem;
+
+typedef struct _SlowChannelEntry
+{
+  SlowChannelItem item;
+  uint8_t used;
+  uint8_t sends;
+  uint8_t wait;               // slots until it may be sent again
+  uint32_t seq;               // post order
+  uint32_t postedCycles;
+} SlowChannelEntry;
+
+typedef struct _SlowChannelClassStat
+{
+  uint32_t posted;
+  uint32_t dropped;           // queue full
+  uint32_t started;           // first slot sent
+  uint32_t done;              // sent completely, or confirmed
+  uint32_t failed;            // not confirmed after all retries
+  uint32_t waitMaxUs;         // post to first slot
+  uint64_t waitSumUs;
+  uint32_t doneMaxUs;         // post to done
+  uint64_t doneSumUs;
+} SlowChannelClassStat;
+
+typedef struct _SlowChannel
+{
+  SlowChannelEntry entries[SLOW_CHANNEL_MAX];
+  uint32_t seq;
+  uint32_t slots;
+  uint32_t idleSlots;         // nothing to send
+  SlowChannelClassStat stat[SLOW_CHANNEL_NUM_CLASSES];
+} SlowChannel;
+
+extern CONTEXT_LOCAL SlowChannel slowChannel;
+
+void SlowChannelInit(void);
+
+// Queue an item, returns 1 if the queue is full (for SDK items: all but the reserved entries used).
+uint8_t SlowChannelPost(const SlowChannelItem* pItem);
+
+// Fills the slot of the next page 1 frame, all zero if nothing is ready.
+// Returns 1 if an item was sent.
+uint8_t SlowChannelNext(SlowChannelSlot* pSlot);
+
+// LL value on the slow up channel, confirms matching items
+void SlowChannelAck(uint8_t upSelect, int16_t value);
+
+const char* SlowChannelClassName(uint8_t itemClass);
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2017 Intel Deutschland GmbH, Germany
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stack_monitor.h"
+#include "jobs.h"
+#include <string.h>
+
+// words per job chunk, about 4us
+#define STACK_MONITOR_CHUNK 64
+
+#define STACK_MONITOR_TOTAL (0x800 + 0x800 + 0x800 + 0x80 + 0x80 + 0x80)
+
+#ifdef HOST_BUILD
+// no startup code, an untouched painted area
+static CONTEXT_LOCAL uint32_t Bottom_Stack[STACK_MONITOR_TOTAL/4];
+#else
+extern uint32_t Bottom_Stack[];
+#endif
+
+CONTEXT_LOCAL StackMonitor stackMonitor;
+
+static const uint16_t stackSizes[STACK_MONITOR_NUM] = STACK_MONITOR_SIZES;
+static const char* const stackNames[STACK_MONITOR_NUM] = STACK_MONITOR_NAMES;
+
+static uint32_t* stackBottom(uint8_t stack)
+{
+  uint32_t* pBottom = Bottom_Stack;
+
+  for(uint8_t i = 0; i < stack; i++)
+    pBottom += stackSizes[i]/4;
+
+  return pBottom;
+}
+
+static uint8_t scanStep(void* pArg)
+{
+  (void)pArg;
+
+  uint8_t stack = stackMonitor.scanStack;
+  const uint32_t* pBottom = stackBottom(stack);
+  uint16_t words = stackMonitor.size[stack]/4;
+  uint16_t usedWords = stackMonitor.used[stack]/4;
+  uint16_t end = stackMonitor.scanWord + STACK_MONITOR_CHUNK;
+  uint16_t i;
+
+  // the marks only grow, no need to look above the current one
+  if(end > words - usedWords)
+    end = words - usedWords;
+
+  for(i = stackMonitor.scanWord; i < end; i++)
+  {
+    if(pBottom[i] != STACK_MONITOR_PAINT)
+      break;
+  }
+
+  if(i < end)
+    stackMonitor.used[stack] = (words - i)*4;
+
+  if(i < end || end == words - usedWords)
+  {
+    stackMonitor.scanWord = 0;
+
+    if(++stackMonitor.scanStack == STACK_MONITOR_NUM)
+    {
+      stackMonitor.scanStack = 0;
+      stackMonitor.scanPending = 0;
+      ++stackMonitor.scans;
+      return JOB_DONE;
+    }
+  }
+  else
+  {
+    stackMonitor.scanWord = end;
+  }
+
+  return JOB_MORE;
+}
+
+void StackMonitorInit(void)
+{
+  memset(&stackMonitor, 0, sizeof(StackMonitor));
+  memcpy(stackMonitor.size, stackSizes, sizeof(stackSizes));
+
+#ifdef HOST_BUILD
+  for(uint16_t i = 0; i < STACK_MONITOR_TOTAL/4; i++)
+    Bottom_Stack[i] = STACK_MONITOR_PAINT;
+#endif
+}
+
+void StackMonitorTask(void)
+{
+  if(!stackMonitor.scanPending && !JobPost("stack", &scanStep, 0, 10))
+    stackMonitor.scanPending = 1;
+}
+
+const char* StackMonitorName(uint8_t stack)
+{
+  if(stack >= STACK_MONITOR_NUM)
+    return 0;
+
+  return stackNames[stack];
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2017 Intel Deutschland GmbH, Germany
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "context.h"
+#include <stdint.h>
+
+// Stack high-water marks of all processor modes.
+// Startup.s paints the stacks with STACK_MONITOR_PAINT before it sets them up.
+// StackMonitorTask() queues a background job (src/jobs.h) that scans the
+// stacks in small chunks from their far end for the deepest overwritten word.
+// The sizes must match Startup.s, stacks are placed from Bottom_Stack upwards
+// in the order below.
+
+#define STACK_MONITOR_PAINT 0xDEADBEEF
+
+#define STACK_MONITOR_USR 0
+#define STACK_MONITOR_SVC 1
+#define STACK_MONITOR_IRQ 2
+#define STACK_MONITOR_FIQ 3
+#define STACK_MONITOR_ABT 4
+#define STACK_MONITOR_UND 5
+#define STACK_MONITOR_NUM 6
+
+#define STACK_MONITOR_NAMES { "usr", "svc", "irq", "fiq", "abt", "und" }
+#define STACK_MONITOR_SIZES { 0x800, 0x800, 0x800, 0x80, 0x80, 0x80 }
+
+typedef struct _StackMonitor
+{
+  uint16_t size[STACK_MONITOR_NUM];
+  uint16_t used[STACK_MONITOR_NUM];   // high-water mark in bytes
+
+  uint32_t scans;                     // complete passes over all stacks
+  uint8_t scanPending;
+  uint8_t scanStack;
+  uint16_t scanWord;
+} StackMonitor;
+
+extern CONTEXT_LOCAL StackMonitor stackMonitor;
+
+void StackMonitorInit(void);
+
+// queue the next scan, main loop at a low rate
+void StackMonitorTask(void);
+
+const char* StackMonitorName(uint8_t stack);
@@ -20,6 +20,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdarg.h>
+#include "context.h"
 
 typedef struct _VT100Sequence
 {
@@ -37,7 +38,7 @@ static VT100Sequence sequences[] = {
   { "[\1~", FUNCTION_KEY, 0xFF, 0 },
 };
 
-Terminal terminal;
+CONTEXT_LOCAL Terminal terminal;
 
 void TerminalInit(Fifo* pInFifo, Fifo* pOutFifo, TerminalCmdCb cmdCb, TerminalEscCb escCb)
 {
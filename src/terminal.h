@@ -17,6 +17,7 @@
 #pragma once
 
 #include "util/fifo.h"
+#include "context.h"
 
 #define TERMINAL_INPUT_BUFFER_SIZE 80
 #define TERMINAL_OUTPUT_BUFFER_SIZE 200
@@ -77,7 +78,7 @@ typedef struct _Terminal
   Fifo* pOutFifo;
 } Terminal;
 
-extern Terminal terminal;
+extern CONTEXT_LOCAL Terminal terminal;
 
 void TerminalInit(Fifo* pInFifo, Fifo* pOutFifo, TerminalCmdCb cmdCb, TerminalEscCb escCb);
 void TerminalSpinOnce();
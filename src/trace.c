@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2017 Intel Deutschland GmbH, Germany
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "trace.h"
+#include "context.h"
+
+#if TRACE_ENABLE
+
+#include "LPC214x.h"
+#include "hal/sys_time.h"
+#include <string.h>
+
+#define TRACE_RING_MASK (TRACE_RING_SIZE - 1)
+
+#if TRACE_RING_SIZE & TRACE_RING_MASK
+#error "TRACE_RING_SIZE must be a power of two"
+#endif
+
+typedef struct _TraceRing
+{
+  TraceRecord records[TRACE_RING_SIZE];
+  uint32_t head;        // records written since TraceStart(), free running
+  uint32_t seconds;     // timer 1 wraps seen by this ring's writer
+  uint32_t lastCycles;
+} TraceRing;
+
+typedef struct _Trace
+{
+  TraceRing ring[TRACE_NUM_RINGS];
+  volatile uint8_t running;
+  TraceHeader header;
+} Trace;
+
+static CONTEXT_LOCAL Trace trace;
+
+// Each ring counts timer 1 wraps itself, its writer sees the timer go
+// backwards. Records of one ring are in time order and there is at least one
+// per second while tracing (timer 0 interrupt, scheduler tasks), so no wrap is
+// missed and no interrupt state has to be read.
+static inline uint32_t traceTime(TraceRing* pRing)
+{
+  uint32_t cycles = T1TC;
+
+  if(cycles < pRing->lastCycles)
+    ++pRing->seconds;
+
+  pRing->lastCycles = cycles;
+
+  return (pRing->seconds << TRACE_TIME_CYCLE_BITS) | cycles;
+}
+
+void TraceStart(void)
+{
+  trace.running = 0;
+
+  uint32_t cycles = T1TC;
+
+  for(uint8_t i = 0; i < TRACE_NUM_RINGS; i++)
+  {
+    trace.ring[i].head = 0;
+    trace.ring[i].seconds = 0;
+    trace.ring[i].lastCycles = cycles;
+  }
+
+  memset(&trace.header, 0, sizeof(TraceHeader));
+  trace.header.magic = TRACE_MAGIC;
+  trace.header.version = TRACE_VERSION;
+  trace.header.firmwareVersion = (__VERSION_MAJOR << 8) | __VERSION_MINOR;
+  trace.header.cpuClockHz = CPU_CLOCK_HZ;
+
+  trace.running = 1;
+}
+
+void TraceStop(void)
+{
+  trace.running = 0;
+}
+
+uint8_t TraceIsRunning(void)
+{
+  return trace.running;
+}
+
+void TraceEmit(uint8_t ring, uint16_t event, uint16_t arg)
+{
+  if(!trace.running)
+    return;
+
+  TraceRing* pRing = &trace.ring[ring];
+  TraceRecord* pRecord = &pRing->records[pRing->head & TRACE_RING_MASK];
+
+  pRecord->time = traceTime(pRing);
+  pRecord->event = event;
+  pRecord->arg = arg;
+
+  ++pRing->head;
+}
+
+static uint32_t numRecords(uint8_t ring)
+{
+  uint32_t head = trace.ring[ring].head;
+
+  return head < TRACE_RING_SIZE ? head : TRACE_RING_SIZE;
+}
+
+uint32_t TraceImageSize(void)
+{
+  return sizeof(TraceHeader) + (numRecords(TRACE_RING_MAIN) + numRecords(TRACE_RING_ISR))*sizeof(TraceRecord);
+}
+
+static void fillHeader(void)
+{
+  for(uint8_t i = 0; i < TRACE_NUM_RINGS; i++)
+  {
+    trace.header.numRecords[i] = numRecords(i);
+    trace.header.overwritten[i] = trace.ring[i].head - numRecords(i);
+  }
+
+  memset(trace.header.taskNames, 0, sizeof(trace.header.taskNames));
+
+  for(uint8_t i = 0; i < scheduler.numTasks; i++)
+    strncpy(trace.header.taskNames[i], scheduler.pTasks[i].pName, TRACE_NAME_SIZE-1);
+}
+
+uint32_t TraceRead(uint32_t offset, uint8_t* pDst, uint32_t size)
+{
+  if(trace.running)
+    return 0;
+
+  if(offset < sizeof(TraceHeader))
+    fillHeader();
+
+  uint32_t total = TraceImageSize();
+  if(offset >= total)
+    return 0;
+
+  if(size > total - offset)
+    size = total - offset;
+
+  for(uint32_t i = 0; i < size; i++, offset++)
+  {
+    if(offset < sizeof(TraceHeader))
+    {
+      pDst[i] = ((const uint8_t*)&trace.header)[offset];
+      continue;
+    }
+
+    uint32_t pos = offset - sizeof(TraceHeader);
+    uint8_t ring = TRACE_RING_MAIN;
+
+    if(pos >= numRecords(TRACE_RING_MAIN)*sizeof(TraceRecord))
+    {
+      pos -= numRecords(TRACE_RING_MAIN)*sizeof(TraceRecord);
+      ring = TRACE_RING_ISR;
+    }
+
+    const TraceRing* pRing = &trace.ring[ring];
+    uint32_t record = pRing->head - numRecords(ring) + pos/sizeof(TraceRecord);
+
+    pDst[i] = ((const uint8_t*)&pRing->records[record & TRACE_RING_MASK])[pos % sizeof(TraceRecord)];
+  }
+
+  return size;
+}
+
+#endif
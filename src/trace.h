@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2017 Intel Deutschland GmbH, Germany
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "config.h"
+#include "scheduler.h"
+#include <stdint.h>
+
+// Event trace for timelines of interrupt and main loop activity.
+// TRACE() (main loop) and TRACE_ISR() (interrupt handlers) append a
+// (time, event, arg) record to a RAM ring, the oldest records are overwritten.
+// Each context has its own ring with a single writer, so no locking is needed.
+// Interrupt handlers do not nest.
+//
+// Record time: bits 31..26 seconds since TraceStart() modulo 64,
+// bits 25..0 timer 1 cycles.
+//
+// The downloadable image is a TraceHeader followed by the records of the
+// main ring and then the ISR ring, both oldest first. host/trace converts it
+// to Chrome trace event JSON.
+
+#define TRACE_MAGIC   0x31435254 // "TRC1"
+#define TRACE_VERSION 1
+
+#define TRACE_RING_MAIN 0
+#define TRACE_RING_ISR  1
+#define TRACE_NUM_RINGS 2
+
+#define TRACE_TIME_CYCLE_BITS 26
+
+#define TRACE_NAME_SIZE 8
+
+// events, arg in brackets
+#define TRACE_EV_IRQ_ENTER   1  // IRQ_STATS_* handler id
+#define TRACE_EV_IRQ_EXIT    2  // IRQ_STATS_* handler id
+#define TRACE_EV_TASK_BEGIN  3  // scheduler task index
+#define TRACE_EV_TASK_END    4  // scheduler task index
+#define TRACE_EV_SSP_FRAME   5  // page of the LL frame received
+#define TRACE_EV_EXTCOM_MSG  6  // lower 16 bit of the message id
+#define TRACE_EV_LL_WRITE    7  // page of the command frame written to the LL
+#define TRACE_EV_USER        0x100  // first free id for sdk.c
+
+typedef struct _TraceRecord
+{
+  uint32_t time;
+  uint16_t event;
+  uint16_t arg;
+} TraceRecord;
+
+typedef struct _TraceHeader
+{
+  uint32_t magic;
+  uint16_t version;
+  uint16_t firmwareVersion;   // major << 8 | minor
+  uint32_t cpuClockHz;
+  uint32_t numRecords[TRACE_NUM_RINGS];
+  uint32_t overwritten[TRACE_NUM_RINGS];
+  char taskNames[SCHEDULER_MAX_TASKS][TRACE_NAME_SIZE];
+} TraceHeader;
+
+#if TRACE_ENABLE
+
+void TraceStart(void);
+void TraceStop(void);
+uint8_t TraceIsRunning(void);
+
+void TraceEmit(uint8_t ring, uint16_t event, uint16_t arg);
+
+// Total size of the image (header + records). Only valid when stopped.
+uint32_t TraceImageSize(void);
+
+// Copy part of the image. Returns the number of bytes copied, 0 while running.
+uint32_t TraceRead(uint32_t offset, uint8_t* pDst, uint32_t size);
+
+#define TRACE(event, arg) TraceEmit(TRACE_RING_MAIN, event, arg)
+#define TRACE_ISR(event, arg) TraceEmit(TRACE_RING_ISR, event, arg)
+
+#else
+
+#define TRACE(event, arg)
+#define TRACE_ISR(event, arg)
+
+#endif
@@ -15,8 +15,9 @@
  */
 
 #include "build_info.h"
+#include "context.h"
 
-struct BUILD_INFO buildInfo;
+CONTEXT_LOCAL struct BUILD_INFO buildInfo;
 
 void generateBuildInfo()
 {
@@ -17,6 +17,7 @@
 #pragma once
 
 #include <stdint.h>
+#include "context.h"
 
 #pragma pack(push, 1)
 
@@ -34,6 +35,6 @@ struct BUILD_INFO
 
 #pragma pack(pop)
 
-extern struct BUILD_INFO buildInfo;
+extern CONTEXT_LOCAL struct BUILD_INFO buildInfo;
 
 void generateBuildInfo(void);
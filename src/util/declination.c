@@ -19,15 +19,18 @@
 #include "declination.h"
 #include <math.h>
 #include "string.h"
+#include "context.h"
 
-volatile int estimatedDeclination;
-volatile int estimatedInclination;
-volatile unsigned char declinationAvailable;
+CONTEXT_LOCAL volatile int estimatedDeclination;
+CONTEXT_LOCAL volatile int estimatedInclination;
+CONTEXT_LOCAL volatile unsigned char declinationAvailable;
 
+// Degrees nFirst..nLast of the spherical harmonic expansion. Setup runs with
+// nFirst == 1, the result is complete after nLast >= maxord.
 static void E0000(int IENTRY, int *maxdeg, float alt, float glat, float glon, float time, float *dec, float *dip,
-    float *ti, float *gv)
+    float *ti, float *gv, int nFirst, int nLast)
 {
-  static float cd[169] =
+  static CONTEXT_LOCAL float cd[169] =
     { 0.0, 8.0, -15.1, 0.4, -2.5, -2.8, -0.7, 0.2, 0.1, 0.0, 0.0, 0.0, 0.0, -20.9, 10.6, -7.8, -2.6, 2.8, 0.7, 0.4,
         -0.1, 0.3, 0.0, 0.0, 0.0, 0.0, -23.2, -14.6, -0.8, -1.2, -7.0, -3.2, -0.3, -0.3, -0.4, 0.0, 0.0, 0.0, 0.0, 5.0,
         -7.0, -0.6, -6.5, 6.2, -1.1, 2.3, 1.1, 0.3, 0.0, 0.0, 0.0, 0.0, 2.2, 1.6, 5.8, 0.1, -3.8, 0.1, -2.1, 0.6, -0.3,
@@ -36,7 +39,7 @@ static void E0000(int IENTRY, int *maxdeg, float alt, float glat, float glon, fl
         0.0, -0.2, 0.1, 0.3, 0.4, 0.1, -0.2, 0.4, 0.4, 0.4, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0,
         0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0,
         0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
-  static float c[169] =
+  static CONTEXT_LOCAL float c[169] =
     { 0.0, -29556.8, -2340.6, 1335.4, 919.8, -227.4, 73.2, 80.1, 24.9, 5.6, -2.3, 2.8, -2.4, 5079.8, -1671.7, 3046.9,
         -2305.1, 798.1, 354.6, 69.7, -74.5, 7.7, 9.9, -6.3, -1.6, -0.4, -2594.7, -516.7, 1657.0, 1246.7, 211.3, 208.7,
         76.7, -1.4, -11.6, 3.5, 1.6, -1.7, 0.2, -199.9, 269.3, -524.2, 674.0, -379.4, -136.5, -151.2, 38.5, -6.9, -7.0,
@@ -47,36 +50,39 @@ static void E0000(int IENTRY, int *maxdeg, float alt, float glat, float glon, fl
         8.0, 2.9, -7.9, 6.0, -9.1, -0.1, 0.0, -0.3, 2.4, 0.2, 4.4, 4.8, -6.5, -1.1, -3.4, -0.8, -2.3, -7.9, -2.3, 1.1,
         -0.1, 0.3, 1.2, -0.8, -2.5, 0.9, -0.6, -2.7, -0.9, -1.3, -2.0, -1.2, 4.1, -0.3, -0.4, 0.3, 2.4, -2.6, 0.6, 0.3,
         0.0, 0.0, 0.3, -0.9, -0.4, 0.8, -0.1 };
-  static int maxord, n, m, j, D1, D2, D3, D4;
-  static float tc[13][13], dp[13][13], snorm[169], sp[13], cp[13], fn[13], fm[13], pp[13], k[13][13], pi, dtr, a, b, re,
+  static CONTEXT_LOCAL int maxord, n, m, j, D1, D2, D3, D4;
+  static CONTEXT_LOCAL float tc[13][13], dp[13][13], snorm[169], sp[13], cp[13], fn[13], fm[13], pp[13], k[13][13], pi, dtr, a, b, re,
       a2, b2, c2, a4, b4, c4, epoch, flnmj, otime, oalt, olat, olon, dt, rlon, rlat, srlon, srlat, crlon, crlat, srlat2,
       crlat2, q, q1, q2, ct, st, r2, r, d, ca, sa, aor, ar, br, bt, bp, bpp, par, temp1, temp2, parp, bx, by, bz, bh;
-  static float *p = snorm;
+  float *p = snorm;
 
   if(IENTRY == 0)
   {
     // GEOMAG
 
-    /* INITIALIZE CONSTANTS */
-    maxord = *maxdeg;
-    sp[0] = 0.0;
-    cp[0] = *p = pp[0] = 1.0;
-    dp[0][0] = 0.0;
-    a = 6378.137;
-    b = 6356.7523142;
-    re = 6371.2;
-    a2 = a * a;
-    b2 = b * b;
-    c2 = a2 - b2;
-    a4 = a2 * a2;
-    b4 = b2 * b2;
-    c4 = a4 - b4;
-
-    /* CONVERT SCHMIDT NORMALIZED GAUSS COEFFICIENTS TO UNNORMALIZED */
-    epoch = 2005;
-
-    *snorm = 1.0;
-    for(n = 1; n <= maxord; n++)
+    if(nFirst == 1)
+    {
+      /* INITIALIZE CONSTANTS */
+      maxord = *maxdeg;
+      sp[0] = 0.0;
+      cp[0] = *p = pp[0] = 1.0;
+      dp[0][0] = 0.0;
+      a = 6378.137;
+      b = 6356.7523142;
+      re = 6371.2;
+      a2 = a * a;
+      b2 = b * b;
+      c2 = a2 - b2;
+      a4 = a2 * a2;
+      b4 = b2 * b2;
+      c4 = a4 - b4;
+
+      /* CONVERT SCHMIDT NORMALIZED GAUSS COEFFICIENTS TO UNNORMALIZED */
+      epoch = 2005;
+
+      *snorm = 1.0;
+    }
+    for(n = nFirst; n <= nLast && n <= maxord; n++)
     {
       *(snorm + n) = *(snorm + n - 1) * (float)(2 * n - 1) / (float)n;
       j = 2;
@@ -97,59 +103,65 @@ static void E0000(int IENTRY, int *maxdeg, float alt, float glat, float glon, fl
       fn[n] = (float)(n + 1);
       fm[n] = (float)n;
     }
-    k[1][1] = 0.0;
+    if(nLast >= maxord)
+    {
+      k[1][1] = 0.0;
 
-    otime = oalt = olat = olon = -1000.0;
+      otime = oalt = olat = olon = -1000.0;
+    }
   }
   else
   {
     // GEOMG1
 
-    dt = time - epoch;
-    if(otime < 0.0 && (dt < 0.0 || dt > 5.0))
+    if(nFirst == 1)
     {
-      //Warning! date after maximum livespan model
-    }
+      dt = time - epoch;
+      if(otime < 0.0 && (dt < 0.0 || dt > 5.0))
+      {
+        //Warning! date after maximum livespan model
+      }
 
-    pi = 3.14159265359;
-    dtr = pi / 180.0;
-    rlon = glon * dtr;
-    rlat = glat * dtr;
-    srlon = sin(rlon);
-    srlat = sin(rlat);
-    crlon = cos(rlon);
-    crlat = cos(rlat);
-    srlat2 = srlat * srlat;
-    crlat2 = crlat * crlat;
-    sp[1] = srlon;
-    cp[1] = crlon;
-
-    /* CONVERT FROM GEODETIC COORDS. TO SPHERICAL COORDS. */
-    if(alt != oalt || glat != olat)
-    {
-      q = sqrt(a2 - c2 * srlat2);
-      q1 = alt * q;
-      q2 = ((q1 + a2) / (q1 + b2)) * ((q1 + a2) / (q1 + b2));
-      ct = srlat / sqrt(q2 * crlat2 + srlat2);
-      st = sqrt(1.0 - (ct * ct));
-      r2 = (alt * alt) + 2.0 * q1 + (a4 - c4 * srlat2) / (q * q);
-      r = sqrt(r2);
-      d = sqrt(a2 * crlat2 + b2 * srlat2);
-      ca = (alt + d) / r;
-      sa = c2 * crlat * srlat / (r * d);
-    }
-    if(glon != olon)
-    {
-      for(m = 2; m <= maxord; m++)
+      pi = 3.14159265359;
+      dtr = pi / 180.0;
+      rlon = glon * dtr;
+      rlat = glat * dtr;
+      srlon = sin(rlon);
+      srlat = sin(rlat);
+      crlon = cos(rlon);
+      crlat = cos(rlat);
+      srlat2 = srlat * srlat;
+      crlat2 = crlat * crlat;
+      sp[1] = srlon;
+      cp[1] = crlon;
+
+      /* CONVERT FROM GEODETIC COORDS. TO SPHERICAL COORDS. */
+      if(alt != oalt || glat != olat)
       {
-        sp[m] = sp[1] * cp[m - 1] + cp[1] * sp[m - 1];
-        cp[m] = cp[1] * cp[m - 1] - sp[1] * sp[m - 1];
+        q = sqrt(a2 - c2 * srlat2);
+        q1 = alt * q;
+        q2 = ((q1 + a2) / (q1 + b2)) * ((q1 + a2) / (q1 + b2));
+        ct = srlat / sqrt(q2 * crlat2 + srlat2);
+        st = sqrt(1.0 - (ct * ct));
+        r2 = (alt * alt) + 2.0 * q1 + (a4 - c4 * srlat2) / (q * q);
+        r = sqrt(r2);
+        d = sqrt(a2 * crlat2 + b2 * srlat2);
+        ca = (alt + d) / r;
+        sa = c2 * crlat * srlat / (r * d);
       }
+      if(glon != olon)
+      {
+        for(m = 2; m <= maxord; m++)
+        {
+          sp[m] = sp[1] * cp[m - 1] + cp[1] * sp[m - 1];
+          cp[m] = cp[1] * cp[m - 1] - sp[1] * sp[m - 1];
+        }
+      }
+      aor = re / r;
+      ar = aor * aor;
+      br = bt = bp = bpp = 0.0;
     }
-    aor = re / r;
-    ar = aor * aor;
-    br = bt = bp = bpp = 0.0;
-    for(n = 1; n <= maxord; n++)
+    for(n = nFirst; n <= nLast && n <= maxord; n++)
     {
       ar = ar * aor;
       for(m = 0, D3 = 1, D4 = (n + m + D3) / D3; D4 > 0; D4--, m += D3)
@@ -223,63 +235,66 @@ static void E0000(int IENTRY, int *maxdeg, float alt, float glat, float glon, fl
         }
       }
     }
-    if(st == 0.0)
-      bp = bpp;
-    else
-      bp /= st;
-    /*
-     ROTATE MAGNETIC VECTOR COMPONENTS FROM SPHERICAL TO
-     GEODETIC COORDINATES
-     */
-    bx = -bt * ca - br * sa;
-    by = bp;
-    bz = bt * sa - br * ca;
-    /*
-     COMPUTE DECLINATION (DEC), INCLINATION (DIP) AND
-     TOTAL INTENSITY (TI)
-     */
-    bh = sqrt((bx * bx) + (by * by));
-    *ti = sqrt((bh * bh) + (bz * bz));
-    *dec = atan2(by, bx) / dtr;
-    *dip = atan2(bz, bh) / dtr;
-    /*
-     COMPUTE MAGNETIC GRID VARIATION IF THE CURRENT
-     GEODETIC POSITION IS IN THE ARCTIC OR ANTARCTIC
-     (I.E. GLAT > +55 DEGREES OR GLAT < -55 DEGREES)
-
-     OTHERWISE, SET MAGNETIC GRID VARIATION TO -999.0
-     */
-    *gv = -999.0;
-    if(fabs(glat) >= 55.)
+    if(nLast >= maxord)
     {
-      if(glat > 0.0 && glon >= 0.0)
-        *gv = *dec - glon;
-      if(glat > 0.0 && glon < 0.0)
-        *gv = *dec + fabs(glon);
-      if(glat < 0.0 && glon >= 0.0)
-        *gv = *dec + glon;
-      if(glat < 0.0 && glon < 0.0)
-        *gv = *dec - fabs(glon);
-      if(*gv > +180.0)
-        *gv -= 360.0;
-      if(*gv < -180.0)
-        *gv += 360.0;
+      if(st == 0.0)
+        bp = bpp;
+      else
+        bp /= st;
+      /*
+       ROTATE MAGNETIC VECTOR COMPONENTS FROM SPHERICAL TO
+       GEODETIC COORDINATES
+       */
+      bx = -bt * ca - br * sa;
+      by = bp;
+      bz = bt * sa - br * ca;
+      /*
+       COMPUTE DECLINATION (DEC), INCLINATION (DIP) AND
+       TOTAL INTENSITY (TI)
+       */
+      bh = sqrt((bx * bx) + (by * by));
+      *ti = sqrt((bh * bh) + (bz * bz));
+      *dec = atan2(by, bx) / dtr;
+      *dip = atan2(bz, bh) / dtr;
+      /*
+       COMPUTE MAGNETIC GRID VARIATION IF THE CURRENT
+       GEODETIC POSITION IS IN THE ARCTIC OR ANTARCTIC
+       (I.E. GLAT > +55 DEGREES OR GLAT < -55 DEGREES)
+
+       OTHERWISE, SET MAGNETIC GRID VARIATION TO -999.0
+       */
+      *gv = -999.0;
+      if(fabs(glat) >= 55.)
+      {
+        if(glat > 0.0 && glon >= 0.0)
+          *gv = *dec - glon;
+        if(glat > 0.0 && glon < 0.0)
+          *gv = *dec + fabs(glon);
+        if(glat < 0.0 && glon >= 0.0)
+          *gv = *dec + glon;
+        if(glat < 0.0 && glon < 0.0)
+          *gv = *dec - fabs(glon);
+        if(*gv > +180.0)
+          *gv -= 360.0;
+        if(*gv < -180.0)
+          *gv += 360.0;
+      }
+      otime = time;
+      oalt = alt;
+      olat = glat;
+      olon = glon;
     }
-    otime = time;
-    oalt = alt;
-    olat = glat;
-    olon = glon;
   }
 }
 
 void geomag(int *maxdeg)
 {
-  E0000(0, maxdeg, 0.0, 0.0, 0.0, 0.0, NULL, NULL, NULL, NULL);
+  E0000(0, maxdeg, 0.0, 0.0, 0.0, 0.0, NULL, NULL, NULL, NULL, 1, *maxdeg);
 }
 
 void geomg1(float alt, float glat, float glon, float time, float *dec, float *dip, float *ti, float *gv)
 {
-  E0000(1, NULL, alt, glat, glon, time, dec, dip, ti, gv);
+  E0000(1, NULL, alt, glat, glon, time, dec, dip, ti, gv, 1, DECLINATION_MAX_DEG);
 }
 
 //gets declination from lat/lon/year/height above sea level
@@ -288,33 +303,73 @@ void geomg1(float alt, float glat, float glon, float time, float *dec, float *di
 //MAG_VERYWEAK = 0x02 => very weak magnetic field
 //MAG_ERROR = 0x03 => error, returned 0
 int getDeclination(int lat, int lon, int height, int year, int *status)
+{
+  DeclinationJob job;
+
+  getDeclinationStart(&job, lat, lon, height, year);
+  while(!getDeclinationStep(&job))
+    ;
+
+  *status = job.status;
+  return job.declination;
+}
+
+void getDeclinationStart(DeclinationJob* pJob, int lat, int lon, int height, int year)
+{
+  pJob->lat = lat;
+  pJob->lon = lon;
+  pJob->height = height;
+  pJob->year = year;
+  pJob->step = 0;
+  pJob->status = 0;
+  pJob->declination = 0;
+}
+
+// steps 0..11 set up the model, 12..23 evaluate it, one degree each
+int getDeclinationStep(DeclinationJob* pJob)
 {
   int warn_H, warn_H_strong, warn_P;
-  static int maxdeg;
-  static float altm, dlat, dlon;
-  static float alt, time, dec, dip, ti, gv;
-  static float dec1, dip1, ti1;
-  char decd[5];
+  static CONTEXT_LOCAL int maxdeg;
+  static CONTEXT_LOCAL float altm, dlat, dlon;
+  static CONTEXT_LOCAL float alt, time, dec, dip, ti, gv;
+  static CONTEXT_LOCAL float dec1, dip1, ti1;
   float h1;
   float rTd = 0.017453292;
 
-  maxdeg = 12;
-  warn_H = 0;
-  warn_H_strong = 0;
-  warn_P = 0;
+  if(pJob->step < DECLINATION_MAX_DEG)
+  {
+    int n = pJob->step + 1;
 
-  geomag(&maxdeg);
+    maxdeg = DECLINATION_MAX_DEG;
+    E0000(0, &maxdeg, 0.0, 0.0, 0.0, 0.0, NULL, NULL, NULL, NULL, n, n);
 
-  dlat = (float)lat / 10000000;
-  dlon = (float)lon / 10000000;
-  altm = height;
+    ++pJob->step;
+    return 0;
+  }
+
+  dlat = (float)pJob->lat / 10000000;
+  dlon = (float)pJob->lon / 10000000;
+  altm = pJob->height;
 
   alt = altm / 1000;
 
 //time: 1.0=1 year
-  time = year;
+  time = pJob->year;
+
+  if(pJob->step < 2*DECLINATION_MAX_DEG)
+  {
+    int n = pJob->step - DECLINATION_MAX_DEG + 1;
+
+    E0000(1, NULL, alt, dlat, dlon, time, &dec, &dip, &ti, &gv, n, n);
+
+    ++pJob->step;
+    return 0;
+  }
+
+  warn_H = 0;
+  warn_H_strong = 0;
+  warn_P = 0;
 
-  geomg1(alt, dlat, dlon, time, &dec, &dip, &ti, &gv);
   dec1 = dec;
   dip1 = dip;
   ti1 = ti;
@@ -327,7 +382,6 @@ int getDeclination(int lat, int lon, int height, int year, int *status)
   if(h1 < 100.0) /* at magnetic poles */
   {
     dec1 = 0.0;
-    strcpy(decd, "(VOID)");
     /* while rest is ok */
   }
 
@@ -350,27 +404,29 @@ int getDeclination(int lat, int lon, int height, int year, int *status)
     /* while rest is ok */
   }
 
-  *status = 0;
+  pJob->status = 0;
 
   if(warn_H)
   {
-    *status |= 0x01;
+    pJob->status |= 0x01;
   }
 
   if(warn_H_strong)
   {
-    *status |= 0x02;
+    pJob->status |= 0x02;
   }
 
   if(warn_P)
   {
-    *status |= 0x04;
-    return 0;
+    pJob->status |= 0x04;
+    pJob->declination = 0;
+    return 1;
   }
 
   estimatedInclination = (int)((float)dip1 * 10.);
   if(estimatedInclination < 0)
     estimatedInclination *= -1;
 
-  return (int)((float)dec1 * 1000);
+  pJob->declination = (int)((float)dec1 * 1000);
+  return 1;
 }
@@ -16,8 +16,29 @@
 
 #pragma once
 
+#include "context.h"
+
+#define DECLINATION_MAX_DEG 12
+
+typedef struct _DeclinationJob
+{
+  int lat;
+  int lon;
+  int height;
+  int year;
+  int step;
+  int status;
+  int declination;
+} DeclinationJob;
+
 int getDeclination(int lat, int lon, int height, int year, int *status);
 
-extern volatile int estimatedDeclination;
-extern volatile int estimatedInclination;
-extern volatile unsigned char declinationAvailable;
+// getDeclination() in 2*DECLINATION_MAX_DEG+1 short steps for background jobs.
+// getDeclinationStep() returns 1 when pJob->declination and pJob->status are
+// valid. Only one computation at a time, the model state is shared.
+void getDeclinationStart(DeclinationJob* pJob, int lat, int lon, int height, int year);
+int getDeclinationStep(DeclinationJob* pJob);
+
+extern CONTEXT_LOCAL volatile int estimatedDeclination;
+extern CONTEXT_LOCAL volatile int estimatedInclination;
+extern CONTEXT_LOCAL volatile unsigned char declinationAvailable;
@@ -126,6 +126,8 @@ AREA   STACK, DATA, READWRITE, ALIGN=2
 .arm
 .section .stack, "w"
 .align 4
+.global Bottom_Stack
+Bottom_Stack:
         .space (USR_Stack_Size+3)&~3  // Stack for User/System Mode 
         .space (SVC_Stack_Size+3)&~3  // Stack for Supervisor Mode
         .space (IRQ_Stack_Size+3)&~3  // Stack for Interrupt Mode
@@ -381,6 +383,14 @@ PLL_Loop:       LDR     R3, [R0, #PLLSTAT_OFS]
                 STR     R1, [R0]
 .endif
 
+// Paint the stacks for the high-water marks (src/stack_monitor.h)
+                LDR     R0, =Bottom_Stack
+                LDR     R1, =Top_Stack
+                LDR     R2, =0xDEADBEEF
+PaintStack:     CMP     R0, R1
+                STRLO   R2, [R0], #4
+                BLO     PaintStack
+
 // Setup Stack for each mode
                 LDR     R0, =Top_Stack
 
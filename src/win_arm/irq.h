@@ -118,6 +118,10 @@ void init_VIC( void );
 unsigned long install_irq( unsigned long IntNumber, void *HandlerAddr );
 unsigned long uninstall_irq( unsigned long IntNumber );
 
+// swi_handler.s, usable from user mode, return the previous CPSR
+unsigned long IntEnable( void );
+unsigned long IntDisable( void );
+
 
 
 #endif /* end __IRQ_H */